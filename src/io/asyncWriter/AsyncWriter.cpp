@@ -0,0 +1,140 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Asynchronous output through a persistent worker thread and a ring of snapshot buffers.
+ **/
+#include "AsyncWriter.h"
+
+#include <algorithm>
+
+tsunami_lab::io::AsyncWriter::AsyncWriter(t_idx i_nSlots,
+                                          t_idx i_nx,
+                                          t_idx i_ny)
+{
+  m_slots.resize(std::max<t_idx>(i_nSlots, 1));
+  for (std::size_t l_sl = 0; l_sl < m_slots.size(); l_sl++)
+  {
+    m_slots[l_sl].m_h.resize(i_nx * i_ny);
+    m_slots[l_sl].m_hu.resize(i_nx * i_ny);
+    m_slots[l_sl].m_hv.resize(i_nx * i_ny);
+    m_slots[l_sl].m_b.resize(i_nx * i_ny);
+    m_free.push_back(l_sl);
+  }
+
+  m_worker = std::thread(&AsyncWriter::work, this);
+}
+
+tsunami_lab::io::AsyncWriter::~AsyncWriter()
+{
+  {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+    m_stop = true;
+  }
+  m_workAvailable.notify_one();
+  m_worker.join();
+}
+
+void tsunami_lab::io::AsyncWriter::work()
+{
+  std::unique_lock<std::mutex> l_lock(m_mutex);
+  while (true)
+  {
+    m_workAvailable.wait(l_lock, [this]
+                         { return !m_jobs.empty() || m_stop; });
+
+    // the remaining jobs are finished before the worker exits
+    if (m_jobs.empty())
+    {
+      return;
+    }
+
+    Job l_job = std::move(m_jobs.front());
+    m_jobs.pop_front();
+
+    l_lock.unlock();
+    l_job.m_run();
+    l_lock.lock();
+
+    if (l_job.m_slot >= 0)
+    {
+      m_free.push_back(l_job.m_slot);
+    }
+    m_nPending--;
+    m_workDone.notify_all();
+  }
+}
+
+void tsunami_lab::io::AsyncWriter::enqueue(long i_slot,
+                                           std::function<void()> i_run)
+{
+  {
+    std::lock_guard<std::mutex> l_lock(m_mutex);
+    m_jobs.push_back({i_slot, std::move(i_run)});
+    m_nPending++;
+  }
+  m_workAvailable.notify_one();
+}
+
+tsunami_lab::io::AsyncWriter::Snapshot &tsunami_lab::io::AsyncWriter::acquireSnapshot()
+{
+  std::unique_lock<std::mutex> l_lock(m_mutex);
+  if (m_free.empty())
+  {
+    auto l_start = std::chrono::high_resolution_clock::now();
+    m_workDone.wait(l_lock, [this]
+                    { return !m_free.empty(); });
+    m_waitTime += std::chrono::high_resolution_clock::now() - l_start;
+  }
+
+  m_acquired = m_free.front();
+  m_free.pop_front();
+  return m_slots[m_acquired];
+}
+
+void tsunami_lab::io::AsyncWriter::submitSnapshot(std::function<void(Snapshot const &)> i_job)
+{
+  long l_slot = m_acquired;
+  m_acquired = -1;
+
+  Snapshot const *l_snapshot = &m_slots[l_slot];
+  enqueue(l_slot, [i_job, l_snapshot]()
+          { i_job(*l_snapshot); });
+}
+
+void tsunami_lab::io::AsyncWriter::submit(std::function<void()> i_job)
+{
+  enqueue(-1, std::move(i_job));
+}
+
+void tsunami_lab::io::AsyncWriter::flush()
+{
+  std::unique_lock<std::mutex> l_lock(m_mutex);
+  auto l_start = std::chrono::high_resolution_clock::now();
+  m_workDone.wait(l_lock, [this]
+                  { return m_nPending == 0; });
+  m_waitTime += std::chrono::high_resolution_clock::now() - l_start;
+}
+
+std::chrono::nanoseconds tsunami_lab::io::AsyncWriter::getWaitTime()
+{
+  std::lock_guard<std::mutex> l_lock(m_mutex);
+  return m_waitTime;
+}
+
+void tsunami_lab::io::AsyncWriter::copyInterior(t_real const *i_data,
+                                                t_idx i_nx,
+                                                t_idx i_ny,
+                                                t_idx i_ghostCellsX,
+                                                t_idx i_ghostCellsY,
+                                                t_idx i_stride,
+                                                t_real *o_data)
+{
+#pragma omp parallel for schedule(static)
+  for (t_idx l_iy = 0; l_iy < i_ny; l_iy++)
+  {
+    t_real const *l_row = i_data + (l_iy + i_ghostCellsY) * i_stride + i_ghostCellsX;
+    std::copy(l_row, l_row + i_nx, o_data + l_iy * i_nx);
+  }
+}
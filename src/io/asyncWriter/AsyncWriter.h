@@ -0,0 +1,179 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Asynchronous output through a persistent worker thread and a ring of snapshot buffers.
+ **/
+#ifndef TSUNAMI_LAB_IO_ASYNC_WRITER
+#define TSUNAMI_LAB_IO_ASYNC_WRITER
+
+#include "../../constants.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tsunami_lab
+{
+  namespace io
+  {
+    class AsyncWriter;
+  }
+}
+
+/**
+ * Runs output jobs in submission order on a persistent worker thread.
+ *
+ * Jobs which write the wave field get one of a fixed number of snapshot slots. The caller copies the interior
+ * of the patch into the slot and continues with the next time steps, while the worker writes the slot and
+ * returns it to the ring afterwards. The caller only blocks if all slots are in use.
+ * Small jobs, e.g. the output of the stations, carry their data in the job itself and do not occupy a slot.
+ **/
+class tsunami_lab::io::AsyncWriter
+{
+public:
+  /**
+   * Interior of the wave field at the time of an output.
+   **/
+  struct Snapshot
+  {
+    //! water heights, cell (ix, iy) at ix + iy * nx
+    std::vector<t_real> m_h;
+
+    //! momenta in x-direction
+    std::vector<t_real> m_hu;
+
+    //! momenta in y-direction
+    std::vector<t_real> m_hv;
+
+    //! bathymetry, only filled if the job needs it
+    std::vector<t_real> m_b;
+  };
+
+private:
+  //! job of the worker with its slot, a negative slot for jobs without snapshot
+  struct Job
+  {
+    long m_slot;
+    std::function<void()> m_run;
+  };
+
+  //! snapshot buffers of the ring
+  std::vector<Snapshot> m_slots;
+
+  //! slots which are not in use, in the order they were returned
+  std::deque<long> m_free;
+
+  //! slot handed out by acquireSnapshot and not submitted yet
+  long m_acquired = -1;
+
+  //! jobs waiting for the worker
+  std::deque<Job> m_jobs;
+
+  //! number of submitted jobs which are not finished
+  t_idx m_nPending = 0;
+
+  //! true if the worker finishes the remaining jobs and exits
+  bool m_stop = false;
+
+  //! time the caller was blocked by full slots or flushes
+  std::chrono::nanoseconds m_waitTime = std::chrono::nanoseconds::zero();
+
+  std::mutex m_mutex;
+  std::condition_variable m_workAvailable;
+  std::condition_variable m_workDone;
+  std::thread m_worker;
+
+  /**
+   * Loop of the worker thread.
+   **/
+  void work();
+
+  /**
+   * Queues a job and wakes the worker.
+   *
+   * @param i_slot slot of the job, negative if it has none.
+   * @param i_run job.
+   **/
+  void enqueue(long i_slot,
+               std::function<void()> i_run);
+
+public:
+  /**
+   * Constructs the writer and starts its worker.
+   *
+   * @param i_nSlots number of snapshot slots, at least 1.
+   * @param i_nx number of cells of a snapshot in x-direction.
+   * @param i_ny number of cells of a snapshot in y-direction.
+   **/
+  AsyncWriter(t_idx i_nSlots,
+              t_idx i_nx,
+              t_idx i_ny);
+
+  /**
+   * Finishes all submitted jobs and stops the worker.
+   **/
+  ~AsyncWriter();
+
+  AsyncWriter(AsyncWriter const &) = delete;
+  AsyncWriter &operator=(AsyncWriter const &) = delete;
+
+  /**
+   * Gets a free snapshot slot, blocks while all slots are in use.
+   * The slot has to be handed back by submitSnapshot before the next slot is acquired.
+   *
+   * @return snapshot to be filled by the caller.
+   **/
+  Snapshot &acquireSnapshot();
+
+  /**
+   * Submits a job which writes the acquired snapshot.
+   *
+   * @param i_job job, called on the worker with the snapshot.
+   **/
+  void submitSnapshot(std::function<void(Snapshot const &)> i_job);
+
+  /**
+   * Submits a job without snapshot, which owns all data it writes.
+   *
+   * @param i_job job, called on the worker.
+   **/
+  void submit(std::function<void()> i_job);
+
+  /**
+   * Blocks until all submitted jobs are finished.
+   **/
+  void flush();
+
+  /**
+   * Gets the time the caller was blocked by full slots or flushes.
+   *
+   * @return waiting time.
+   **/
+  std::chrono::nanoseconds getWaitTime();
+
+  /**
+   * Copies the interior of a field with ghost cells, the rows are copied in parallel.
+   *
+   * @param i_data field with ghost cells.
+   * @param i_nx number of cells in x-direction.
+   * @param i_ny number of cells in y-direction.
+   * @param i_ghostCellsX number of ghost cells on each side in x-direction.
+   * @param i_ghostCellsY number of ghost cells on each side in y-direction.
+   * @param i_stride stride of the field.
+   * @param o_data will be set to the interior, cell (ix, iy) at ix + iy * i_nx.
+   **/
+  static void copyInterior(t_real const *i_data,
+                           t_idx i_nx,
+                           t_idx i_ny,
+                           t_idx i_ghostCellsX,
+                           t_idx i_ghostCellsY,
+                           t_idx i_stride,
+                           t_real *o_data);
+};
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Unit tests for the asynchronous output.
+ **/
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "AsyncWriter.h"
+
+TEST_CASE("Test the copy of the interior of a field.", "[AsyncWriterCopy]")
+{
+  // 3 x 2 cells with one ghost cell on each side
+  tsunami_lab::t_real l_data[20] = {0, 0, 0, 0, 0,
+                                    0, 1, 2, 3, 0,
+                                    0, 4, 5, 6, 0,
+                                    0, 0, 0, 0, 0};
+  tsunami_lab::t_real l_interior[6] = {0};
+
+  tsunami_lab::io::AsyncWriter::copyInterior(l_data, 3, 2, 1, 1, 5, l_interior);
+
+  for (int l_ce = 0; l_ce < 6; l_ce++)
+  {
+    REQUIRE(l_interior[l_ce] == l_ce + 1);
+  }
+}
+
+TEST_CASE("Test the order and the snapshots of the asynchronous output.", "[AsyncWriter]")
+{
+  // written by the worker only, Catch2 checks them on the calling thread
+  std::vector<int> l_written;
+  bool l_snapshotsValid = true;
+  std::vector<tsunami_lab::t_real> l_field(4);
+
+  {
+    tsunami_lab::io::AsyncWriter l_writer(2, 2, 2);
+
+    for (int l_out = 0; l_out < 10; l_out++)
+    {
+      // the field changes after each submission, the jobs see the state at their submission
+      for (tsunami_lab::t_idx l_ce = 0; l_ce < 4; l_ce++)
+      {
+        l_field[l_ce] = l_out * 10 + l_ce;
+      }
+
+      tsunami_lab::io::AsyncWriter::Snapshot &l_snapshot = l_writer.acquireSnapshot();
+      std::copy(l_field.begin(), l_field.end(), l_snapshot.m_h.begin());
+      l_writer.submitSnapshot([&l_written, &l_snapshotsValid, l_out](tsunami_lab::io::AsyncWriter::Snapshot const &i_snapshot)
+                              {
+                                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                for (tsunami_lab::t_idx l_ce = 0; l_ce < 4; l_ce++)
+                                {
+                                  l_snapshotsValid = l_snapshotsValid && i_snapshot.m_h[l_ce] == l_out * 10 + l_ce;
+                                }
+                                l_written.push_back(l_out); });
+
+      // jobs without snapshot keep their place in the order
+      l_writer.submit([&l_written, l_out]()
+                      { l_written.push_back(-l_out); });
+    }
+
+    l_writer.flush();
+    REQUIRE(l_written.size() == 20);
+
+    // destruction finishes the remaining jobs
+    l_writer.submit([&l_written]()
+                    { l_written.push_back(100); });
+  }
+
+  REQUIRE(l_snapshotsValid);
+  REQUIRE(l_written.size() == 21);
+  for (int l_out = 0; l_out < 10; l_out++)
+  {
+    REQUIRE(l_written[2 * l_out] == l_out);
+    REQUIRE(l_written[2 * l_out + 1] == -l_out);
+  }
+  REQUIRE(l_written[20] == 100);
+}
+
+TEST_CASE("Test the backpressure of the asynchronous output.", "[AsyncWriterBackpressure]")
+{
+  tsunami_lab::io::AsyncWriter l_writer(1, 1, 1);
+  std::atomic<bool> l_release(false);
+
+  // the only slot is held by a job which waits for the release
+  l_writer.acquireSnapshot();
+  l_writer.submitSnapshot([&l_release](tsunami_lab::io::AsyncWriter::Snapshot const &)
+                          {
+                            while (!l_release)
+                            {
+                              std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                            } });
+
+  std::thread l_releaser([&l_release]()
+                         {
+                           std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                           l_release = true; });
+
+  // blocks until the first job returns the slot
+  l_writer.acquireSnapshot();
+  REQUIRE(l_release);
+  REQUIRE(l_writer.getWaitTime() > std::chrono::nanoseconds::zero());
+  l_writer.submitSnapshot([](tsunami_lab::io::AsyncWriter::Snapshot const &) {});
+
+  l_releaser.join();
+  l_writer.flush();
+}
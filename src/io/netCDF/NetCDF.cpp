@@ -132,13 +132,6 @@ void tsunami_lab::io::NetCdf::write(t_idx i_nx,
   delete[] scaled_h;
   delete[] scaled_hu;
   delete[] scaled_hv;
-
-  // freeing memory because "removeGhostCells"-function return these,
-  // they are not saved in a variable so this is the only time they
-  // can be deleted
-  delete[] i_h;
-  delete[] i_hu;
-  delete[] i_hv;
 }
 
 tsunami_lab::t_real *tsunami_lab::io::NetCdf::scaleDownArray(t_real const *i_array,
@@ -72,6 +72,7 @@ public:
 
   /**
    * @brief Writes one instance of h, hu, hv, time-step and stamp into the output-file.
+   * The arrays remain owned by the caller.
    *
    * @param i_nx number of cells in x-direction.
    * @param i_ny number of cells in y-direction.
@@ -61,9 +61,9 @@ TEST_CASE("Test the NetCDF-writer.", "[NetCDFWrite2d]")
     writer->write(4,
                   4,
                   1,
-                  writer->removeGhostCells(l_h, 4, 4, 0, 0, 4),
-                  writer->removeGhostCells(l_hu, 4, 4, 0, 0, 4),
-                  writer->removeGhostCells(l_hv, 4, 4, 0, 0, 4),
+                  l_h,
+                  l_hu,
+                  l_hv,
                   0,
                   0.2,
                   "netCDF_dump/netCDFdump.nc");
@@ -78,9 +78,9 @@ TEST_CASE("Test the NetCDF-writer.", "[NetCDFWrite2d]")
     writer->write(4,
                   4,
                   1,
-                  writer->removeGhostCells(l_h, 4, 4, 0, 0, 4),
-                  writer->removeGhostCells(l_hu, 4, 4, 0, 0, 4),
-                  writer->removeGhostCells(l_hv, 4, 4, 0, 0, 4),
+                  l_h,
+                  l_hu,
+                  l_hv,
                   1,
                   1.8,
                   "netCDF_dump/netCDFdump.nc");
@@ -27,6 +27,52 @@ std::vector<Station_struct> tsunami_lab::io::Stations::getStations()
     return m_stations;
 }
 
+bool tsunami_lab::io::Stations::getStationCell(Station_struct const &i_station,
+                                               t_real i_dxy,
+                                               t_idx i_nx,
+                                               t_idx i_ny,
+                                               t_real i_x_offset,
+                                               t_real i_y_offset,
+                                               t_idx i_stride,
+                                               t_idx &o_id)
+{
+    // stations left of or above the (sub)domain are skipped
+    if (i_station.m_x + i_x_offset < 0 || i_station.m_y + i_y_offset < 0)
+    {
+        return false;
+    }
+    t_idx l_ix = (i_station.m_x + i_x_offset) / i_dxy;
+    t_idx l_iy = (i_station.m_y + i_y_offset) / i_dxy;
+    o_id = l_ix + l_iy * i_stride;
+
+    return l_ix < i_nx && l_iy < i_ny;
+}
+
+void tsunami_lab::io::Stations::appendStationLine(std::string const &i_name,
+                                                  t_real i_time,
+                                                  std::vector<t_real> const &i_values)
+{
+    std::string filename = "station_data/" + i_name + ".csv";
+    std::ofstream file(filename, std::ios::app);
+
+    struct stat buffer;
+    bool isNewFile = (stat(filename.c_str(), &buffer) != 0 || buffer.st_size == 0);
+
+    if (file.is_open())
+    {
+
+        if (isNewFile)
+        {
+            file << "Time,height,momentum_x,momentum_y,bathymetry\n";
+        }
+        file << i_time;
+        for (t_real l_value : i_values)
+            file << "," << l_value;
+        file << std::endl
+             << std::flush;
+    }
+}
+
 void tsunami_lab::io::Stations::writeStationOutput(t_real i_dxy,
                                                    t_idx i_nx,
                                                    t_idx i_ny,
@@ -42,39 +88,61 @@ void tsunami_lab::io::Stations::writeStationOutput(t_real i_dxy,
 
     for (const auto &station : m_stations)
     {
-        t_idx l_ix = (station.m_x + i_x_offset) / i_dxy;
-        t_idx l_iy = (station.m_y + i_y_offset) / i_dxy;
-        t_idx l_id = l_ix + l_iy * i_stride;
-
-        if (l_ix < i_nx && l_iy < i_ny)
+        t_idx l_id = 0;
+        if (getStationCell(station, i_dxy, i_nx, i_ny, i_x_offset, i_y_offset, i_stride, l_id))
         {
-            std::string filename = "station_data/" + station.m_name + ".csv";
-            std::ofstream file(filename, std::ios::app);
-
-            struct stat buffer;
-            bool isNewFile = (stat(filename.c_str(), &buffer) != 0 || buffer.st_size == 0);
+            std::vector<t_real> l_values;
+            if (i_h != nullptr)
+                l_values.push_back(i_h[l_id]);
+            if (i_hu != nullptr)
+                l_values.push_back(i_hu[l_id]);
+            if (i_hv != nullptr)
+                l_values.push_back(i_hv[l_id]);
+            if (i_b != nullptr)
+                l_values.push_back(i_b[l_id]);
+            appendStationLine(station.m_name, i_time, l_values);
+        }
+    }
+}
 
-            if (file.is_open())
+std::vector<Station_sample> tsunami_lab::io::Stations::sampleStations(t_real i_dxy,
+                                                                      t_idx i_nx,
+                                                                      t_idx i_ny,
+                                                                      t_real i_x_offset,
+                                                                      t_real i_y_offset,
+                                                                      t_idx i_stride,
+                                                                      t_real const *i_h,
+                                                                      t_real const *i_hu,
+                                                                      t_real const *i_hv,
+                                                                      t_real const *i_b)
+{
+    std::vector<Station_sample> l_samples;
+    for (std::size_t l_st = 0; l_st < m_stations.size(); l_st++)
+    {
+        t_idx l_id = 0;
+        if (getStationCell(m_stations[l_st], i_dxy, i_nx, i_ny, i_x_offset, i_y_offset, i_stride, l_id))
+        {
+            Station_sample l_sample = {l_st, {}};
+            for (t_real const *l_data : {i_h, i_hu, i_hv, i_b})
             {
-
-                if (isNewFile)
-                {
-                    file << "Time,height,momentum_x,momentum_y,bathymetry\n";
-                }
-                file << i_time;
-                if (i_h != nullptr)
-                    file << "," << i_h[l_id];
-                if (i_hu != nullptr)
-                    file << "," << i_hu[l_id];
-                if (i_hv != nullptr)
-                    file << "," << i_hv[l_id];
-                if (i_b != nullptr)
-                    file << "," << i_b[l_id];
-                file << std::endl
-                     << std::flush;
+                if (l_data != nullptr)
+                    l_sample.m_values.push_back(l_data[l_id]);
             }
+            l_samples.push_back(l_sample);
         }
     }
+    return l_samples;
+}
+
+void tsunami_lab::io::Stations::writeStationSamples(std::vector<Station_sample> const &i_samples,
+                                                    t_real i_time)
+{
+    for (Station_sample const &l_sample : i_samples)
+    {
+        appendStationLine(m_stations[l_sample.m_station].m_name,
+                          i_time,
+                          l_sample.m_values);
+    }
 }
 
 tsunami_lab::io::Stations::Stations(const std::string &filePath)
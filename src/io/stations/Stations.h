@@ -34,12 +34,52 @@ struct Station_struct
     }
 };
 
+struct Station_sample
+{
+    std::size_t m_station;
+    //! height, momenta and bathymetry, fields without data (e.g. the y-momentum in 1d) are omitted
+    std::vector<tsunami_lab::t_real> m_values;
+};
+
 class tsunami_lab::io::Stations
 {
 private:
     int m_outputFrequency;
     std::vector<Station_struct> m_stations;
 
+    /**
+     * Gets the cell of a station.
+     *
+     * @param i_station station.
+     * @param i_dxy cell width in x- and y-direction.
+     * @param i_nx number of cells in x-direction.
+     * @param i_ny number of cells in y-direction.
+     * @param i_x_offset offset in x-direction.
+     * @param i_y_offset offset in y-direction.
+     * @param i_stride stride of the data arrays in y-direction.
+     * @param o_id will be set to the id of the station's cell.
+     * @return true if the station lies inside the (sub)domain.
+     **/
+    static bool getStationCell(Station_struct const &i_station,
+                               t_real i_dxy,
+                               t_idx i_nx,
+                               t_idx i_ny,
+                               t_real i_x_offset,
+                               t_real i_y_offset,
+                               t_idx i_stride,
+                               t_idx &o_id);
+
+    /**
+     * Appends a line to the CSV file of a station, the header is written to new files.
+     *
+     * @param i_name name of the station.
+     * @param i_time time of the output.
+     * @param i_values values of the line.
+     **/
+    static void appendStationLine(std::string const &i_name,
+                                  t_real i_time,
+                                  std::vector<t_real> const &i_values);
+
 public:
     /**
      * add station to the station vector.
@@ -86,6 +126,41 @@ public:
                             t_real const *i_b,
                             t_real i_time);
 
+    /**
+     * Gets the values of the stations inside the (sub)domain, such that they can be written later.
+     *
+     * @param i_dxy cell width in x- and y-direction.
+     * @param i_nx number of cells in x-direction.
+     * @param i_ny number of cells in y-direction.
+     * @param i_x_offset offset in x-direction.
+     * @param i_y_offset offset in y-direction.
+     * @param i_stride stride of the data arrays in y-direction (x is assumed to be stride-1).
+     * @param i_h water height of the cells.
+     * @param i_hu momentum in x-direction of the cells.
+     * @param i_hv momentum in y-direction of the cells.
+     * @param i_b bathymetry of the cells.
+     * @return values of the stations.
+     **/
+    std::vector<Station_sample> sampleStations(t_real i_dxy,
+                                               t_idx i_nx,
+                                               t_idx i_ny,
+                                               t_real i_x_offset,
+                                               t_real i_y_offset,
+                                               t_idx i_stride,
+                                               t_real const *i_h,
+                                               t_real const *i_hu,
+                                               t_real const *i_hv,
+                                               t_real const *i_b);
+
+    /**
+     * Writes values of the stations gathered by sampleStations, in the format of writeStationOutput.
+     *
+     * @param i_samples values of the stations.
+     * @param i_time time of the output.
+     **/
+    void writeStationSamples(std::vector<Station_sample> const &i_samples,
+                             t_real i_time);
+
     /**
      * load Station file.
      *
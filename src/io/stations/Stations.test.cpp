@@ -88,4 +88,32 @@ TEST_CASE("Test CSV File data", "[StationsData]")
                                          2, 4, 4, 4, 4,
                                          3, 4, 4, 4, 4};
     REQUIRE(l_csvData == out);
-}
\ No newline at end of file
+}
+TEST_CASE("Test sampling the Stations", "[StationsSample]")
+{
+    tsunami_lab::t_real l_h[25], l_hu[25], l_hv[25], l_b[25];
+    for (int i = 0; i < 25; i++)
+    {
+        l_h[i] = i;
+        l_hu[i] = i + 100;
+        l_hv[i] = i + 200;
+        l_b[i] = -i;
+    }
+
+    // Station_1 at (1, 2) lies in the 3 x 3 subdomain, Station_2 at (3, 4) does not
+    std::vector<Station_sample> l_samples = l_stations.sampleStations(1, 3, 3, 0, 0, 5, l_h, l_hu, l_hv, l_b);
+
+    REQUIRE(l_samples.size() == 1);
+    REQUIRE(l_samples[0].m_station == 0);
+    REQUIRE(l_samples[0].m_values == std::vector<tsunami_lab::t_real>{11, 111, 211, -11});
+
+    // both stations in the whole domain
+    l_samples = l_stations.sampleStations(1, 5, 5, 0, 0, 5, l_h, l_hu, l_hv, l_b);
+    REQUIRE(l_samples.size() == 2);
+    REQUIRE(l_samples[1].m_station == 1);
+    REQUIRE(l_samples[1].m_values[0] == 23);
+
+    // 1d patches have no momentum in y-direction
+    l_samples = l_stations.sampleStations(1, 5, 5, 0, 0, 5, l_h, l_hu, nullptr, l_b);
+    REQUIRE(l_samples[0].m_values == std::vector<tsunami_lab::t_real>{11, 111, -11});
+}
@@ -14,22 +14,26 @@
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <chrono>
-#include <atomic>
-#include <mutex>
-#include <thread>
 
+#include "io/asyncWriter/AsyncWriter.h"
 #include "io/csv/Csv.h"
 #include "io/netCDF/NetCDF.h"
 #include "io/stations/Stations.h"
+#include "parallel/affinity/Affinity.h"
+#include "parallel/ensemble/Ensemble.h"
 #include "patches/wavepropagation1d/WavePropagation1d.h"
 #include "patches/wavepropagation2d/WavePropagation2d.h"
 #include "patches/wavepropagation2d_kernel/WavePropagation2d_kernel.h"
+#ifdef TSUNAMI_LAB_USE_MPI
+#include "patches/wavepropagation2d_mpi/WavePropagation2d_mpi.h"
+#endif
 #include "setups/dambreak1d/DamBreak1d.h"
 #include "setups/dambreak2d/DamBreak2d.h"
 #include "setups/rarerare1d/RareRare1d.h"
@@ -40,7 +44,7 @@
 #include "setups/tsunamievent2d/TsunamiEvent2d.h"
 #include "setups/artificialTsunami2d/ArtificialTsunami2d.h"
 #include "setups/checkpoint/Checkpoint.h"
-#include <condition_variable>
+#include "plugins/json.hpp"
 
 bool do_write = true;
 // declaration of variables
@@ -56,8 +60,33 @@ int resolution_div = 1;
 bool simulate_real_tsunami = false;
 bool checkpointing = false;
 bool write_parallel = true;
+// number of snapshot buffers of the asynchronous output, the time loop only blocks if all of them are written
+tsunami_lab::t_idx output_slots = 2;
 double checkpoint_timer = 3600.0;
 int use_opencl = 0;
+// precision of the patches: "float", "double" or "mixed" (float state, double accumulation)
+std::string precision = "float";
+// tiling of the 2d time step: 0 x 0 = untiled, set by "-g auto" or "-g <tile_x>x<tile_y>"
+bool tiling_auto = false;
+// benchmark the work-group sizes of the OpenCL kernels before the time loop and store them for later runs, set by "-g tune"
+bool tiling_tune = false;
+// CFL number of the adaptive time step
+tsunami_lab::t_real cfl = 0.5;
+tsunami_lab::t_idx tile_size_x = 0;
+tsunami_lab::t_idx tile_size_y = 0;
+// deviation from the state of rest which activates tiles of the 2d time step, negative = all tiles active
+tsunami_lab::t_real activation_tolerance = -1;
+// number of time step classes of the local time stepping of the 2d time step, 1 = global time step
+unsigned short lts_classes = 1;
+// update scheme of the untiled 2d time step: dimensional splitting or unsplit single pass, set by "-u unsplit"
+bool unsplit = false;
+// binding of the OpenMP threads to CPUs: "none", "close", "spread" or "cores", set by "-a"
+std::string affinity = "none";
+// JSON configuration of an ensemble of tsunami events sharing the bathymetry, set by "-e"
+std::string ensemble_config = "";
+// rank of this process and number of processes, the 2d domain is distributed if started with more than one rank
+int mpi_rank = 0;
+int mpi_size = 1;
 // std::string bat_path = "data/artificialtsunami/artificialtsunami_bathymetry_1000.nc";
 // std::string dis_path = "data/artificialtsunami/artificialtsunami_displ_1000.nc";
 // std::string bat_path = "data/real_tsunamis/chile_gebco20_usgs_250m_bath_fixed.nc";
@@ -102,13 +131,218 @@ void printTime(std::chrono::nanoseconds i_duration, const std::string &i_message
     std::cout << std::endl;
 }
 
+/**
+ * Prints the usage of the command line interface.
+ **/
+void printUsage()
+{
+    std::cerr
+        << "usage:" << std::endl
+        << "  ./build/tsunami_lab [-d DIMENSION] [-s SETUP] [-l STATE_LEFT] [-r STATE_RIGHT] [-t STATE_TOP] [-b STATE_BOTTOM]" << std::endl
+        << "                      [-i STATION] [-k RESOLUTION] [-o OPENCL] [-p PARALLEL] [-w WRITE] [-f PRECISION] [-g TILING]" << std::endl
+        << "                      [-c CFL] [-v TOLERANCE] [-m CLASSES] [-u SCHEME] [-a AFFINITY] [-q SLOTS] [-e ENSEMBLE] N_CELLS_X" << std::endl
+        << "where N_CELLS_X is the number of cells in x-direction. The Grid is quadratic in 2d, so the same value will be taken for cells in y-direction" << std::endl
+        << "The exceptions are 'tsunami2d' and ensembles, where N_CELLS_X represents the size of a cell." << std::endl
+        << "    -d DIMENSION = '1d','2d'" << std::endl
+        << "    When using 1d-simulation, the choices for setup are:" << std::endl
+        << "        -s SETUP  = 'dambreak1d h_l h_r','rarerare1d h hu','shockshock1d h hu', 'supercritical1d', 'subcritical1d', 'tsunami1d'" << std::endl
+        << "    When using 2d-simulation, the choices for setup are:" << std::endl
+        << "        -s SETUP  = 'dambreak2d', 'artificial2d', 'tsunami2d'" << std::endl
+        << "    -l STATE_LEFT = 'open','closed', default is 'open'" << std::endl
+        << "    -r STATE_RIGHT = 'open','closed', default is 'open'" << std::endl
+        << "    -t STATE_TOP = 'open','closed', default is 'open'" << std::endl
+        << "    -b STATE_BOTTOM = 'open','closed', default is 'open'" << std::endl
+        << "    -i STATION = 'path', JSON configuration of the stations" << std::endl
+        << "    -k RESOLUTION, where the higher the input, the lower the resolution" << std::endl
+        << "    -o OPENCL, 0 = CPU and 1 = GPU" << std::endl
+        << "    -p PARALLEL, 1 = parallel output and 0 = normal output" << std::endl
+        << "    -w WRITE, 0 = write and 1 = no write" << std::endl
+        << "    -f PRECISION = 'float','double','mixed', default is 'float'" << std::endl
+        << "    -g TILING = 'auto','tune','<tile_x>x<tile_y>', tiles of the 2d time step, default is untiled" << std::endl
+        << "    -c CFL, CFL number of the adaptive time step in (0, 0.5] for both schemes, default is 0.5" << std::endl
+        << "    -v TOLERANCE, only compute tiles reached by a deviation from the state of rest, implies '-g auto' if untiled, CPU only" << std::endl
+        << "    -m CLASSES, number of time step classes 1-8 of the local time stepping, default is 1, implies '-g auto' if untiled, CPU only" << std::endl
+        << "    -u SCHEME = 'split','unsplit', update scheme of the untiled 2d time step, default is 'split'" << std::endl
+        << "    -a AFFINITY = 'none','close','spread','cores', binding of the threads to CPUs, default is 'none'" << std::endl
+        << "    -q SLOTS, number of snapshot buffers of the parallel output, default is 2" << std::endl
+        << "    -e ENSEMBLE = 'path', JSON configuration of an ensemble of tsunami events sharing the bathymetry" << std::endl;
+}
+
+/**
+ * Runs an ensemble of tsunami events, which share the bathymetry and differ in their displacement.
+ * The configuration holds the path of the bathymetry, the end time, the number of concurrent members and
+ * the name and displacement of each member.
+ *
+ * @param i_config path of the JSON configuration.
+ * @param i_cellSize cell width in meter.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ **/
+int runEnsemble(std::string const &i_config,
+                tsunami_lab::t_real i_cellSize)
+{
+    std::ifstream l_file(i_config);
+    if (!l_file.is_open())
+    {
+        std::cerr << "could not open the ensemble configuration " << i_config << std::endl;
+        return EXIT_FAILURE;
+    }
+    nlohmann::json l_json;
+    l_file >> l_json;
+
+    std::string l_bathymetry = l_json.value("bathymetry", bat_path);
+    tsunami_lab::t_real l_endTime = l_json.value("endtime", tsunami_lab::t_real(36000));
+    std::vector<std::string> l_names;
+    std::vector<std::string> l_displacements;
+    for (auto const &l_member : l_json["members"])
+    {
+        l_names.push_back(l_member["name"]);
+        l_displacements.push_back(l_member["displacement"]);
+    }
+    if (l_names.empty())
+    {
+        std::cerr << "the ensemble configuration " << i_config << " has no members" << std::endl;
+        return EXIT_FAILURE;
+    }
+    tsunami_lab::t_idx l_nConcurrent = l_json.value("concurrent", l_names.size());
+    tsunami_lab::t_idx l_nLanes = l_json.value("lanes", tsunami_lab::t_idx(1));
+
+    // the bathymetry is read once, all members share it and only read their displacement
+    tsunami_lab::t_real l_width = 0;
+    tsunami_lab::t_real l_height = 0;
+    tsunami_lab::t_real l_xOffset = 0;
+    tsunami_lab::t_real l_yOffset = 0;
+    tsunami_lab::setups::TsunamiEvent2d l_event(l_bathymetry,
+                                                l_displacements[0],
+                                                &l_width,
+                                                &l_height,
+                                                &l_xOffset,
+                                                &l_yOffset);
+    std::vector<tsunami_lab::setups::Setup const *> l_members;
+    for (std::string const &l_displacement : l_displacements)
+    {
+        l_members.push_back(new tsunami_lab::setups::TsunamiEvent2d(l_event, l_displacement));
+    }
+
+    tsunami_lab::t_idx l_nx = l_width / i_cellSize;
+    tsunami_lab::t_idx l_ny = l_nx * l_height / l_width;
+    tsunami_lab::t_real l_dxy = l_width / l_nx;
+
+    std::cout << "runtime configuration" << std::endl;
+    std::cout << "  number of cells in x-direction: " << l_nx << std::endl;
+    std::cout << "  number of cells in y-direction: " << l_ny << std::endl;
+    std::cout << "  cell size:                      " << l_dxy << std::endl;
+    std::cout << "  ensemble members:               " << l_members.size() << std::endl;
+    std::cout << "  concurrent members:             " << std::min(l_nConcurrent, l_members.size()) << std::endl;
+    std::cout << "  members per patch (lanes):      " << l_nLanes << std::endl;
+
+    tsunami_lab::parallel::Ensemble l_ensemble(l_nx,
+                                               l_ny,
+                                               l_dxy,
+                                               l_xOffset,
+                                               l_yOffset,
+                                               state_boundary_left,
+                                               state_boundary_right,
+                                               state_boundary_top,
+                                               state_boundary_bottom,
+                                               cfl);
+    l_ensemble.setBathymetry(*l_members[0]);
+
+    if (do_write)
+    {
+        std::filesystem::create_directory("netCDF_dump");
+    }
+
+    // the members finish one at a time, each writes its final state to a file of its own
+    tsunami_lab::io::NetCdf l_netCdf;
+    tsunami_lab::parallel::Ensemble::Statistics l_statistics = l_ensemble.run(
+        l_members,
+        l_endTime,
+        l_nConcurrent,
+        [&](tsunami_lab::t_idx i_member,
+            tsunami_lab::t_real const *i_h,
+            tsunami_lab::t_real const *i_hu,
+            tsunami_lab::t_real const *i_hv,
+            tsunami_lab::t_idx i_stride,
+            tsunami_lab::t_real i_time,
+            tsunami_lab::t_idx i_nTimeSteps)
+        {
+            std::cout << "  finished member " << l_names[i_member] << ": simulation time / #time steps: "
+                      << i_time << " / " << i_nTimeSteps << std::endl;
+            if (!do_write)
+            {
+                return;
+            }
+
+            std::string l_path = "netCDF_dump/ensemble_" + l_names[i_member] + ".nc";
+            // initialize takes ownership of the bathymetry without ghost cells
+            l_netCdf.initialize(l_path,
+                                l_dxy,
+                                l_nx,
+                                l_ny,
+                                resolution_div,
+                                l_xOffset,
+                                l_yOffset,
+                                l_netCdf.removeGhostCells(l_ensemble.getBathymetry(), l_nx, l_ny, 1, 1, i_stride));
+
+            tsunami_lab::t_real *l_h = l_netCdf.removeGhostCells(i_h, l_nx, l_ny, 1, 1, i_stride);
+            tsunami_lab::t_real *l_hu = l_netCdf.removeGhostCells(i_hu, l_nx, l_ny, 1, 1, i_stride);
+            tsunami_lab::t_real *l_hv = l_netCdf.removeGhostCells(i_hv, l_nx, l_ny, 1, 1, i_stride);
+            l_netCdf.write(l_nx, l_ny, resolution_div, l_h, l_hu, l_hv, 0, i_time, l_path);
+            delete[] l_h;
+            delete[] l_hu;
+            delete[] l_hv;
+        },
+        l_nLanes);
+
+    printTime(l_statistics.m_duration, "ensemble time");
+    std::cout << "time steps of all members: " << l_statistics.m_nTimeSteps << std::endl;
+    std::cout << "cell updates of all members: " << l_statistics.m_nCellUpdates << std::endl;
+    std::cout << "cell updates per second: " << l_statistics.getCellUpdatesPerSecond() << std::endl;
+
+    for (tsunami_lab::setups::Setup const *l_member : l_members)
+    {
+        delete l_member;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * Ends the run after an invalid option or input. With MPI, all ranks are aborted, such that none of them waits
+ * in a collective call for a rank which returned.
+ *
+ * @return EXIT_FAILURE.
+ **/
+int abortRun()
+{
+#ifdef TSUNAMI_LAB_USE_MPI
+    MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+#endif
+    return EXIT_FAILURE;
+}
+
 int main(int i_argc,
          char *i_argv[])
 {
+#ifdef TSUNAMI_LAB_USE_MPI
+    // the distributed patch calls MPI from the main thread inside parallel regions
+    int l_provided = 0;
+    MPI_Init_thread(&i_argc, &i_argv, MPI_THREAD_FUNNELED, &l_provided);
+    if (l_provided < MPI_THREAD_FUNNELED)
+    {
+        std::cerr << "Error: the MPI library does not support calls from the main thread of parallel regions." << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    }
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+
+    // only the first rank reports to the console
+    if (mpi_rank != 0)
+    {
+        std::cout.setstate(std::ios_base::failbit);
+    }
+#endif
 
     auto l_start_time = std::chrono::high_resolution_clock::now();
-    // setenv("OMP_PROC_BIND", "master", 1);
-    // setenv("OMP_PLACES", "cores", 1);
 
     std::filesystem::path currentPath = std::filesystem::current_path();
     std::filesystem::path targetPath;
@@ -131,10 +365,16 @@ int main(int i_argc,
     tsunami_lab::t_idx l_nx = 0;
     tsunami_lab::t_idx l_ny = 1;
 
-    // set up time and print control
+    // cells of this rank in x- and y-direction and the global ids of its first cell, the whole domain without MPI
+    tsunami_lab::t_idx l_nx_local = 0;
+    tsunami_lab::t_idx l_ny_local = 0;
+    tsunami_lab::t_idx l_cx0 = 0;
+    tsunami_lab::t_idx l_cy0 = 0;
+
+    // set up time and print control, the simulated time and the time step are carried in double independent of the precision of the patch
     tsunami_lab::t_idx l_timeStep = 0;
     tsunami_lab::t_idx l_nOut = 0;
-    tsunami_lab::t_real l_simTime = 0;
+    double l_simTime = 0;
 
     // set up filename
     std::string filename;
@@ -158,26 +398,9 @@ int main(int i_argc,
 
     if (((i_argc < 4) || (i_argv[i_argc - 1][0] == '-')) && !checkpointing)
     {
-        std::cerr << "invalid number of arguments OR wrong order, usage:" << std::endl;
-        std::cerr << "  ./build/tsunami_lab [-d DIMENSION] [-s SETUP] [-l STATE_LEFT] [-r STATE_RIGHT] [-t STATE_TOP] [-b STATE_BOTTOM] [-i STATION] [-k RESOLUTION]  N_CELLS_X" << std::endl;
-        std::cerr << "where N_CELLS_X is the number of cells in x-direction. The Grid is quadratic in 2d, so the same value will be taken for cells in y-direction" << std::endl;
-        std::cerr << "The exception is 'tsunami2d', where N_CELLS_X represents the size of a cell." << std::endl;
-        std::cerr << "Its is planned however to switch to a json-config based approach where everything will change." << std::endl;
-        std::cerr << "-d DIMENSION = '1d','2d'" << std::endl;
-        std::cerr << "When using 1d-simulation, the choices for setup are:" << std::endl;
-        std::cerr << "  -s SETUP  = 'dambreak1d h_l h_r','rarerare1d h hu','shockshock1d h hu', 'supercritical1d', 'subcritical1d', 'tsunami1d'" << std::endl;
-        std::cerr << "When using 2d-simulation, the choices for setup are:" << std::endl;
-        std::cerr << "  -s SETUP  = 'dambreak2d', 'tsunami2d'" << std::endl;
-        std::cerr << "-l STATE_LEFT = 'open','closed', default is 'open'" << std::endl;
-        std::cerr << "-r STATE_RIGHT = 'open','closed', default is 'open'" << std::endl;
-        std::cerr << "-t STATE_TOP = 'open','closed', default is 'open'" << std::endl;
-        std::cerr << "-b STATE_BOTTOM = 'open','closed', default is 'open'" << std::endl;
-        std::cerr << "-i STATION = 'path'" << std::endl;
-        std::cerr << "-k RESOLUTION, where the higher the input, the lower the resolution" << std::endl;
-        std::cerr << "-o OPENCL, 0 = CPU and 1 = GPU" << std::endl;
-        std::cerr << "-p write parallel, 0 = parallel and 1 = normal" << std::endl;
-        std::cerr << "-w write, 0 = no write and 1 = write" << std::endl;
-        return EXIT_FAILURE;
+        std::cerr << "invalid number of arguments OR wrong order" << std::endl;
+        printUsage();
+        return abortRun();
     }
     else if (!checkpointing)
     {
@@ -185,16 +408,21 @@ int main(int i_argc,
         if (l_nx < 1)
         {
             std::cerr << "invalid number of cells" << std::endl;
-            return EXIT_FAILURE;
+            return abortRun();
         }
     }
 
-    tsunami_lab::t_real l_endTime = 1.25;
+    double l_endTime = 1.25;
     tsunami_lab::t_real l_width = 10.0;
     std::vector<tsunami_lab::t_real> m_b_in;
 
     // construct solver
     tsunami_lab::patches::WavePropagation *l_waveProp;
+    tsunami_lab::patches::WavePropagation2d_kernel *l_waveProp_kernel = nullptr;
+#ifdef TSUNAMI_LAB_USE_MPI
+    // distributed solver, which additionally reports the timers of its halo exchange
+    tsunami_lab::patches::WavePropagation2d_mpi *l_waveProp_mpi = nullptr;
+#endif
 
     tsunami_lab::io::NetCdf *netcdf_manager = new tsunami_lab::io::NetCdf();
 
@@ -242,7 +470,7 @@ int main(int i_argc,
     else
     {
 
-        while ((opt = getopt(i_argc, i_argv, "d:s:l:r:t:b:i:k:o:p:w:")) != -1)
+        while ((opt = getopt(i_argc, i_argv, "d:s:l:r:t:b:i:k:o:p:w:f:g:c:v:m:u:a:q:e:")) != -1)
         {
             switch (opt)
             {
@@ -265,7 +493,7 @@ int main(int i_argc,
                         << std::string(optarg) << std::endl
                         << "possible options are: '1d' or '2d'" << std::endl
                         << "be sure to only type in lower-case" << std::endl;
-                    return EXIT_FAILURE;
+                    return abortRun();
                 }
                 break;
             }
@@ -303,7 +531,7 @@ int main(int i_argc,
                         std::cerr
                             << "Invalid argument: " << ia.what() << std::endl
                             << "be sure to only type numbers after the setup-name" << std::endl;
-                        return EXIT_FAILURE;
+                        return abortRun();
                     }
 
                     if (tokens[0] == "dambreak1d")
@@ -334,7 +562,7 @@ int main(int i_argc,
                             << "Undefined setup: " << tokens[0] << std::endl
                             << "possible options are: 'dambreak1d', 'shockshock1d' or 'rarerare1d'" << std::endl
                             << "be sure to only type in lower-case" << std::endl;
-                        return EXIT_FAILURE;
+                        return abortRun();
                     }
                 }
                 else if (tokens[0] == "subcritical1d" && dimension == 1)
@@ -414,7 +642,7 @@ int main(int i_argc,
                         << "Either: False number of arguments for setup: " << tokens.size() << std::endl
                         << "Expected: 3" << std::endl
                         << "OR: Wrong dimension-setup-combination" << std::endl;
-                    return EXIT_FAILURE;
+                    return abortRun();
                 }
                 break;
             }
@@ -437,7 +665,7 @@ int main(int i_argc,
                         << std::string(optarg) << std::endl
                         << "possible options are: 'open' or 'closed'" << std::endl
                         << "be sure to only type in lower-case" << std::endl;
-                    return EXIT_FAILURE;
+                    return abortRun();
                 }
                 break;
             }
@@ -460,7 +688,7 @@ int main(int i_argc,
                         << std::string(optarg) << std::endl
                         << "possible options are: 'open' or 'closed'" << std::endl
                         << "be sure to only type in lower-case" << std::endl;
-                    return EXIT_FAILURE;
+                    return abortRun();
                 }
                 break;
             }
@@ -483,7 +711,7 @@ int main(int i_argc,
                         << std::string(optarg) << std::endl
                         << "possible options are: 'open' or 'closed'" << std::endl
                         << "be sure to only type in lower-case" << std::endl;
-                    return EXIT_FAILURE;
+                    return abortRun();
                 }
                 break;
             }
@@ -506,7 +734,7 @@ int main(int i_argc,
                         << std::string(optarg) << std::endl
                         << "possible options are: 'open' or 'closed'" << std::endl
                         << "be sure to only type in lower-case" << std::endl;
-                    return EXIT_FAILURE;
+                    return abortRun();
                 }
                 break;
             }
@@ -522,7 +750,7 @@ int main(int i_argc,
                 if (resolution_div < 1)
                 {
                     std::cout << "Error: resolution-scalar cannot be less than 1." << std::endl;
-                    return EXIT_FAILURE;
+                    return abortRun();
                 }
                 break;
             }
@@ -551,7 +779,7 @@ int main(int i_argc,
                         << std::string(optarg) << std::endl
                         << "possible options are: '0' or '1'" << std::endl
                         << "be sure to only type in lower-case" << std::endl;
-                    return EXIT_FAILURE;
+                    return abortRun();
                 }
                 break;
             }
@@ -567,41 +795,232 @@ int main(int i_argc,
                 }
                 break;
             }
+            case 'f':
+            {
+                precision = std::string(optarg);
+                if (precision != "float" && precision != "double" && precision != "mixed")
+                {
+                    std::cerr
+                        << "undefined precision "
+                        << precision << std::endl
+                        << "possible options are: 'float', 'double' or 'mixed'" << std::endl
+                        << "be sure to only type in lower-case" << std::endl;
+                    return abortRun();
+                }
+                std::cout << "precision: " << precision << std::endl;
+                break;
+            }
+            case 'c':
+            {
+                cfl = atof(optarg);
+                // the time step follows the wave speeds of the previous step, which leaves a margin for accelerating waves
+                if (cfl <= 0 || cfl > 0.5)
+                {
+                    std::cerr << "Error: CFL number has to be in (0, 0.5]." << std::endl;
+                    return abortRun();
+                }
+                break;
+            }
+            case 'v':
+            {
+                activation_tolerance = atof(optarg);
+                if (activation_tolerance < 0)
+                {
+                    std::cerr << "Error: activation tolerance has to be non-negative." << std::endl;
+                    return abortRun();
+                }
+                break;
+            }
+            case 'm':
+            {
+                int l_classes = atoi(optarg);
+                if (l_classes < 1 || l_classes > 8)
+                {
+                    std::cerr << "Error: number of time step classes has to be in [1, 8]." << std::endl;
+                    return abortRun();
+                }
+                lts_classes = l_classes;
+                break;
+            }
+            case 'u':
+            {
+                std::string l_scheme(optarg);
+                if (l_scheme == "split" || l_scheme == "unsplit")
+                {
+                    unsplit = l_scheme == "unsplit";
+                }
+                else
+                {
+                    std::cerr
+                        << "undefined update scheme "
+                        << l_scheme << std::endl
+                        << "possible options are: 'split' or 'unsplit'" << std::endl;
+                    return abortRun();
+                }
+                break;
+            }
+            case 'a':
+            {
+                affinity = std::string(optarg);
+                if (!tsunami_lab::parallel::Affinity::isPolicy(affinity))
+                {
+                    std::cerr
+                        << "undefined affinity policy "
+                        << affinity << std::endl
+                        << "possible options are: 'none', 'close', 'spread' or 'cores'" << std::endl;
+                    return abortRun();
+                }
+                break;
+            }
+            case 'e':
+            {
+                ensemble_config = std::string(optarg);
+                break;
+            }
+            case 'q':
+            {
+                int l_slots = atoi(optarg);
+                if (l_slots < 1)
+                {
+                    std::cerr
+                        << "invalid number of output slots "
+                        << std::string(optarg) << std::endl
+                        << "the number of output slots has to be at least 1" << std::endl;
+                    return abortRun();
+                }
+                output_slots = l_slots;
+                break;
+            }
+            case 'g':
+            {
+                std::string l_tiling(optarg);
+                std::size_t l_sep = l_tiling.find('x');
+                if (l_tiling == "auto")
+                {
+                    tiling_auto = true;
+                }
+                else if (l_tiling == "tune")
+                {
+                    tiling_tune = true;
+                }
+                // exactly one 'x' with digits on both sides
+                else if (l_sep != std::string::npos && l_sep > 0 && l_sep + 1 < l_tiling.size() &&
+                         l_tiling.find('x', l_sep + 1) == std::string::npos &&
+                         l_tiling.find_first_not_of("0123456789x") == std::string::npos &&
+                         std::stoul(l_tiling.substr(0, l_sep)) > 0 && std::stoul(l_tiling.substr(l_sep + 1)) > 0)
+                {
+                    tile_size_x = std::stoul(l_tiling.substr(0, l_sep));
+                    tile_size_y = std::stoul(l_tiling.substr(l_sep + 1));
+                }
+                else
+                {
+                    std::cerr
+                        << "undefined tiling "
+                        << l_tiling << std::endl
+                        << "possible options are: 'auto', 'tune' or '<tile_x>x<tile_y>', e.g. '512x64'" << std::endl;
+                    return abortRun();
+                }
+                break;
+            }
             // unknown option
             case '?':
             {
-                std::cerr
-                    << "Undefinded option: " << char(optopt) << " OR wrong dimension-setup-combination" << std::endl
-                    << "possible options are:" << std::endl
-                    << "    -d DIMENSION = '1d','2d'" << std::endl
-                    << "    When using 1d-simulation, the choices for setup are:" << std::endl
-                    << "        -s SETUP  = 'dambreak h_l h_r','rarerare h hu','shockshock h hu', 'supercritical', 'subcritical', 'tsunami'" << std::endl
-                    << "    When using 2d-simulation, the choices for setup are:" << std::endl
-                    << "        -s SETUP  = 'dambreak', 'tsunami2d'" << std::endl
-                    << "    -l STATE_LEFT = 'open','closed', default is 'open'" << std::endl
-                    << "    -r STATE_RIGHT = 'open','closed', default is 'open'" << std::endl
-                    << "    -t STATE_TOP = 'open','closed', default is 'open'" << std::endl
-                    << "    -b STATE_BOTTOM = 'open','closed', default is 'open'" << std::endl
-                    << "    -i 'path' " << std::endl
-                    << "    -k RESOLUTION, where the higher the input, the lower the resolution" << std::endl
-                    << "    -o OPENCL, 0 = CPU and 1 = GPU" << std::endl;
+                std::cerr << "Undefinded option: " << char(optopt) << " OR wrong dimension-setup-combination" << std::endl;
+                printUsage();
                 break;
             }
             }
         }
     }
 
+    // the tuning benchmarks the kernels of the OpenCL patch
+    if (tiling_tune && !use_opencl)
+    {
+        std::cerr << "Error: the tuning of the work-group sizes is only supported with OpenCL." << std::endl;
+        return abortRun();
+    }
+
+    // the activation and the local time stepping are only implemented by the tiled time step on the CPU
+    if (use_opencl && (activation_tolerance >= 0 || lts_classes > 1))
+    {
+        std::cerr << "Error: the activation and the local time stepping are not supported with OpenCL." << std::endl;
+        return abortRun();
+    }
+
+    // the unsplit time step has no tiled variant
+    if (unsplit && (tiling_auto || (tile_size_x > 0 && tile_size_y > 0) || activation_tolerance >= 0 || lts_classes > 1))
+    {
+        std::cerr << "Error: the unsplit update scheme can not be combined with tiling, activation or local time stepping." << std::endl;
+        return abortRun();
+    }
+
+    // only the untiled single precision 2d time step on the CPU is distributed
+    if (mpi_size > 1 && (dimension != 2 || use_opencl || checkpointing || precision != "float" || tiling_auto ||
+                         (tile_size_x > 0 && tile_size_y > 0) || activation_tolerance >= 0 || lts_classes > 1 || unsplit))
+    {
+        std::cerr << "Error: runs with more than one MPI rank support only the untiled, split 2d time step in single precision on the CPU." << std::endl;
+        return abortRun();
+    }
+
+    // bind the threads before the patches allocate their fields, such that the first touch places the pages near the threads
+    if (!tsunami_lab::parallel::Affinity::pinThreads(affinity))
+    {
+        return abortRun();
+    }
+
+    // ensemble of tsunami events instead of a single simulation
+    if (ensemble_config != "")
+    {
+        if (mpi_size > 1 || use_opencl || checkpointing || precision != "float" || tiling_auto ||
+            (tile_size_x > 0 && tile_size_y > 0) || activation_tolerance >= 0 || lts_classes > 1 || unsplit)
+        {
+            std::cerr << "Error: ensembles run on a single MPI rank with the untiled, split 2d time step in single precision on the CPU." << std::endl;
+            return abortRun();
+        }
+
+        int l_result = runEnsemble(ensemble_config, l_nx);
+
+        delete l_setup;
+        delete l_stations;
+        delete netcdf_manager;
+#ifdef TSUNAMI_LAB_USE_MPI
+        MPI_Finalize();
+#endif
+        return l_result;
+    }
+
+    // the activation and the local time stepping work on the tiles of the tiled time step
+    if ((activation_tolerance >= 0 || lts_classes > 1) && !tiling_auto && (tile_size_x == 0 || tile_size_y == 0))
+    {
+        tiling_auto = true;
+    }
+
     switch (dimension)
     {
     case 1:
         if (use_opencl)
         {
             std::cout << "Using OpenCL in 1d is not supported. Exiting." << std::endl;
-            return EXIT_FAILURE;
+            return abortRun();
+        }
+        if (precision == "double")
+        {
+            l_waveProp = new tsunami_lab::patches::WavePropagation1d<double, double>(l_nx,
+                                                                                     state_boundary_left,
+                                                                                     state_boundary_right);
+        }
+        else if (precision == "mixed")
+        {
+            l_waveProp = new tsunami_lab::patches::WavePropagation1d<float, double>(l_nx,
+                                                                                    state_boundary_left,
+                                                                                    state_boundary_right);
+        }
+        else
+        {
+            l_waveProp = new tsunami_lab::patches::WavePropagation1d<float, float>(l_nx,
+                                                                                   state_boundary_left,
+                                                                                   state_boundary_right);
         }
-        l_waveProp = new tsunami_lab::patches::WavePropagation1d(l_nx,
-                                                                 state_boundary_left,
-                                                                 state_boundary_right);
         break;
 
     case 2:
@@ -609,96 +1028,212 @@ int main(int i_argc,
         {
             l_ny = l_nx;
         }
+        if (use_opencl && precision != "float")
+        {
+            std::cout << "Using OpenCL with precision '" << precision << "' is not supported. Exiting." << std::endl;
+            return abortRun();
+        }
+#ifdef TSUNAMI_LAB_USE_MPI
+        if (mpi_size > 1)
+        {
+            l_waveProp_mpi = new tsunami_lab::patches::WavePropagation2d_mpi(l_nx,
+                                                                             l_ny,
+                                                                             state_boundary_left,
+                                                                             state_boundary_right,
+                                                                             state_boundary_top,
+                                                                             state_boundary_bottom);
+            l_nx_local = l_waveProp_mpi->getNumberOfCellsX();
+            l_ny_local = l_waveProp_mpi->getNumberOfCellsY();
+            l_cx0 = l_waveProp_mpi->getOffsetX();
+            l_cy0 = l_waveProp_mpi->getOffsetY();
+            l_waveProp = l_waveProp_mpi;
+            break;
+        }
+#endif
         if (use_opencl)
         {
-            l_waveProp = new tsunami_lab::patches::WavePropagation2d_kernel(l_nx,
-                                                                            l_ny,
-                                                                            state_boundary_left,
-                                                                            state_boundary_right,
-                                                                            state_boundary_top,
-                                                                            state_boundary_bottom);
+            l_waveProp_kernel = new tsunami_lab::patches::WavePropagation2d_kernel(l_nx,
+                                                                                   l_ny,
+                                                                                   state_boundary_left,
+                                                                                   state_boundary_right,
+                                                                                   state_boundary_top,
+                                                                                   state_boundary_bottom);
+            // the tiling selects the work-group size of the tiled kernels, without an explicit one the sizes of an earlier tuning are used
+            if ((tile_size_x > 0 && tile_size_y > 0) || !l_waveProp_kernel->loadTuning())
+            {
+                if (tiling_auto)
+                {
+                    l_waveProp_kernel->getDefaultTiling(tile_size_x, tile_size_y);
+                }
+                l_waveProp_kernel->setTiling(tile_size_x, tile_size_y);
+            }
+            l_waveProp = l_waveProp_kernel;
+        }
+        else if (precision == "double")
+        {
+            if (tiling_auto)
+            {
+                tsunami_lab::patches::WavePropagation2d<double, double>::getAutoTileSize(l_nx, l_ny, tile_size_x, tile_size_y);
+            }
+            l_waveProp = new tsunami_lab::patches::WavePropagation2d<double, double>(l_nx,
+                                                                                     l_ny,
+                                                                                     state_boundary_left,
+                                                                                     state_boundary_right,
+                                                                                     state_boundary_top,
+                                                                                     state_boundary_bottom,
+                                                                                     tile_size_x,
+                                                                                     tile_size_y,
+                                                                                     activation_tolerance,
+                                                                                     lts_classes,
+                                                                                     unsplit);
+        }
+        else if (precision == "mixed")
+        {
+            if (tiling_auto)
+            {
+                tsunami_lab::patches::WavePropagation2d<float, double>::getAutoTileSize(l_nx, l_ny, tile_size_x, tile_size_y);
+            }
+            l_waveProp = new tsunami_lab::patches::WavePropagation2d<float, double>(l_nx,
+                                                                                    l_ny,
+                                                                                    state_boundary_left,
+                                                                                    state_boundary_right,
+                                                                                    state_boundary_top,
+                                                                                    state_boundary_bottom,
+                                                                                    tile_size_x,
+                                                                                    tile_size_y,
+                                                                                    activation_tolerance,
+                                                                                    lts_classes,
+                                                                                    unsplit);
         }
         else
         {
-            l_waveProp = new tsunami_lab::patches::WavePropagation2d(l_nx,
-                                                                     l_ny,
-                                                                     state_boundary_left,
-                                                                     state_boundary_right,
-                                                                     state_boundary_top,
-                                                                     state_boundary_bottom);
+            if (tiling_auto)
+            {
+                tsunami_lab::patches::WavePropagation2d<float, float>::getAutoTileSize(l_nx, l_ny, tile_size_x, tile_size_y);
+            }
+            l_waveProp = new tsunami_lab::patches::WavePropagation2d<float, float>(l_nx,
+                                                                                   l_ny,
+                                                                                   state_boundary_left,
+                                                                                   state_boundary_right,
+                                                                                   state_boundary_top,
+                                                                                   state_boundary_bottom,
+                                                                                   tile_size_x,
+                                                                                   tile_size_y,
+                                                                                   activation_tolerance,
+                                                                                   lts_classes,
+                                                                                   unsplit);
         }
 
         break;
 
     default:
         std::cerr << "Dimension has to be specified" << std::endl;
-        return EXIT_FAILURE;
+        return abortRun();
         break;
     }
 
     l_dxy = l_width / l_nx;
 
+    // without a decomposition the rank holds the whole domain
+    if (l_nx_local == 0)
+    {
+        l_nx_local = l_nx;
+        l_ny_local = l_ny;
+    }
+
+    // offsets which place the first cell of the rank at its global position
+    tsunami_lab::t_real l_x_offset_local = l_x_offset - l_cx0 * l_dxy;
+    tsunami_lab::t_real l_y_offset_local = l_y_offset - l_cy0 * l_dxy;
+
     std::cout << "runtime configuration" << std::endl;
     std::cout << "  number of cells in x-direction: " << l_nx << std::endl;
     std::cout << "  number of cells in y-direction: " << l_ny << std::endl;
     std::cout << "  cell size:                      " << l_dxy << std::endl;
+    if (mpi_size > 1)
+    {
+        std::cout << "  MPI ranks:                      " << mpi_size << std::endl;
+    }
+    if (affinity != "none")
+    {
+        std::cout << "  thread affinity:                " << affinity << std::endl;
+    }
+    if (dimension == 2 && !use_opencl && tile_size_x > 0 && tile_size_y > 0)
+    {
+        std::cout << "  tile size:                      " << tile_size_x << " x " << tile_size_y << std::endl;
+    }
+    if (dimension == 2 && use_opencl && tile_size_x > 0 && tile_size_y > 0)
+    {
+        std::cout << "  work-group size:                " << tile_size_x << " x " << tile_size_y << std::endl;
+    }
+    if (dimension == 2 && !use_opencl && activation_tolerance >= 0)
+    {
+        std::cout << "  activation tolerance:           " << activation_tolerance << std::endl;
+    }
+    if (dimension == 2 && !use_opencl && lts_classes > 1)
+    {
+        std::cout << "  time step classes:              " << lts_classes << std::endl;
+    }
+    if (dimension == 2 && !use_opencl && unsplit)
+    {
+        std::cout << "  update scheme:                  unsplit" << std::endl;
+    }
 
-    // set up solver
-    for (tsunami_lab::t_idx l_cy = 0; l_cy < l_ny; l_cy++)
+    // set up solver, each rank initializes its cells at their global coordinates in bands of rows
+    tsunami_lab::t_idx l_nRowsBand = std::min<tsunami_lab::t_idx>(l_ny_local, 256);
+    std::vector<tsunami_lab::t_real> l_band[4];
+    for (std::vector<tsunami_lab::t_real> &l_quantity : l_band)
     {
-        tsunami_lab::t_real l_y = l_cy * l_dxy - l_y_offset;
+        l_quantity.resize(l_nx_local * l_nRowsBand);
+    }
 
-        for (tsunami_lab::t_idx l_cx = 0; l_cx < l_nx; l_cx++)
+    for (tsunami_lab::t_idx l_iy0 = 0; l_iy0 < l_ny_local; l_iy0 += l_nRowsBand)
+    {
+        tsunami_lab::t_idx l_nRows = std::min(l_nRowsBand, l_ny_local - l_iy0);
+
+        // checkpoints are queried by cell ids
+        tsunami_lab::setups::Setup::Region l_region = {l_cx0,
+                                                       l_cy0 + l_iy0,
+                                                       l_nx_local,
+                                                       l_nRows,
+                                                       checkpointing ? tsunami_lab::t_real(1) : l_dxy,
+                                                       checkpointing ? tsunami_lab::t_real(0) : l_x_offset,
+                                                       checkpointing ? tsunami_lab::t_real(0) : l_y_offset};
+
+        // get initial values of the setup
+        l_setup->fill(l_region,
+                      l_band[0].data(),
+                      l_band[1].data(),
+                      l_band[2].data(),
+                      l_band[3].data(),
+                      l_nx_local);
+
+        if (!checkpointing)
         {
-            tsunami_lab::t_real l_x = l_cx * l_dxy - l_x_offset;
-
-            tsunami_lab::t_real l_h, l_hu, l_hv, l_b;
-
-            // get initial values of the setup
-            if (checkpointing)
-            {
-                l_h = l_setup->getHeight(l_cx,
-                                         l_cy);
-                l_hu = l_setup->getMomentumX(l_cx,
-                                             l_cy);
-                l_hv = l_setup->getMomentumY(l_cx,
-                                             l_cy);
-                l_b = l_setup->getBathymetry(l_cx,
-                                             l_cy);
-            }
-            else
+            tsunami_lab::t_real const *l_h = l_band[0].data();
+            tsunami_lab::t_idx l_nCells = l_nx_local * l_nRows;
+#pragma omp parallel for schedule(static) reduction(max : l_hMax)
+            for (tsunami_lab::t_idx l_id = 0; l_id < l_nCells; l_id++)
             {
-                l_h = l_setup->getHeight(l_x,
-                                         l_y);
-                l_hMax = std::max(l_h, l_hMax);
-
-                l_hu = l_setup->getMomentumX(l_x,
-                                             l_y);
-                l_hv = l_setup->getMomentumY(l_x,
-                                             l_y);
-                l_b = l_setup->getBathymetry(l_x,
-                                             l_y);
+                l_hMax = std::max(l_h[l_id], l_hMax);
             }
-
-            // set initial values in wave propagation solver
-            l_waveProp->setHeight(l_cx,
-                                  l_cy,
-                                  l_h);
-
-            l_waveProp->setMomentumX(l_cx,
-                                     l_cy,
-                                     l_hu);
-
-            l_waveProp->setMomentumY(l_cx,
-                                     l_cy,
-                                     l_hv);
-
-            l_waveProp->setBathymetry(l_cx,
-                                      l_cy,
-                                      l_b);
         }
+
+        // set initial values in wave propagation solver
+        l_waveProp->setCells(0,
+                             l_iy0,
+                             l_nx_local,
+                             l_nRows,
+                             l_nx_local,
+                             l_band[0].data(),
+                             l_band[1].data(),
+                             l_band[2].data(),
+                             l_band[3].data());
     }
     l_waveProp->setData();
+#ifdef TSUNAMI_LAB_USE_MPI
+    // all ranks derive the first time step from the maximum height of the whole domain
+    MPI_Allreduce(MPI_IN_PLACE, &l_hMax, 1, MPI_FLOAT, MPI_MAX, MPI_COMM_WORLD);
+#endif
     if (dimension == 2 && !checkpointing && do_write)
     {
         /* if (std::filesystem::exists("netCDF_dump"))
@@ -709,54 +1244,77 @@ int main(int i_argc,
         // create netCDF_dump folder
         std::filesystem::create_directory("netCDF_dump");
 
-        std::time_t t = std::time(nullptr);
+        long long t = std::time(nullptr);
+#ifdef TSUNAMI_LAB_USE_MPI
+        // the files of all ranks share the time stamp of the first rank
+        MPI_Bcast(&t, 1, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
+#endif
 
-        filename = "netCDF_dump/netCDFdump_" + std::to_string(l_dxy) + "_ " + std::to_string(t) + ".nc";
+        filename = "netCDF_dump/netCDFdump_" + std::to_string(l_dxy) + "_ " + std::to_string(t);
+        if (mpi_size > 1)
+        {
+            filename += "_rank" + std::to_string(mpi_rank);
+        }
+        filename += ".nc";
 
+        l_waveProp->getData();
         netcdf_manager->initialize(filename,
                                    l_dxy,
-                                   l_nx,
-                                   l_ny,
+                                   l_nx_local,
+                                   l_ny_local,
                                    resolution_div,
-                                   l_x_offset,
-                                   l_y_offset,
-                                   netcdf_manager->removeGhostCells(l_waveProp->getBathymetry(), l_nx, l_ny, 1, 1, l_waveProp->getStride()));
+                                   l_x_offset_local,
+                                   l_y_offset_local,
+                                   netcdf_manager->removeGhostCells(l_waveProp->getBathymetry(), l_nx_local, l_ny_local, 1, 1, l_waveProp->getStride()));
     }
 
     // derive maximum wave speed in setup; the momentum is ignored
-    tsunami_lab::t_real l_speedMax = std::sqrt(9.81 * l_hMax);
+    double l_speedMax = std::sqrt(9.81 * l_hMax);
 
-    // derive constant time step; changes at simulation time are ignored
-    tsunami_lab::t_real l_dt = 0.5 * l_dxy / l_speedMax;
+    // derive the first time step; afterwards it follows the wave speeds reported by the patch
+    double l_dt = cfl * l_dxy / l_speedMax;
 
     // derive scaling for a time step
-    tsunami_lab::t_real l_scaling = l_dt / l_dxy;
-
-    std::cout << "entering time loop" << std::endl;
+    double l_scaling = l_dt / l_dxy;
 
-    // clear csv_dump
-    if (std::filesystem::exists("csv_dump"))
+    // the tuning runs time steps with the first scaling and restores the cells afterwards
+    if (tiling_tune && l_waveProp_kernel != nullptr)
     {
-        std::filesystem::remove_all("csv_dump");
+        l_waveProp_kernel->tune(l_scaling, 20);
     }
 
-    // create csv_dump folder
-    if (do_write)
-    {
-        std::filesystem::create_directory("csv_dump");
-    }
+    std::cout << "entering time loop" << std::endl;
 
-    // clear station_data
-    if (std::filesystem::exists("station_data"))
+    // the output folders are shared, the first rank recreates them
+    if (mpi_rank == 0)
     {
-        std::filesystem::remove_all("station_data");
-    }
+        // clear csv_dump
+        if (std::filesystem::exists("csv_dump"))
+        {
+            std::filesystem::remove_all("csv_dump");
+        }
 
-    // create station_data folder
-    if (do_write)
-    {
-        std::filesystem::create_directory("station_data");
+        // create csv_dump folder
+        if (do_write)
+        {
+            std::filesystem::create_directory("csv_dump");
+        }
+
+        // clear station_data
+        if (std::filesystem::exists("station_data"))
+        {
+            std::filesystem::remove_all("station_data");
+        }
+
+        // create station_data folder
+        if (do_write)
+        {
+            std::filesystem::create_directory("station_data");
+        }
     }
+#ifdef TSUNAMI_LAB_USE_MPI
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
 
     int multiplier = 0;
     auto l_lastCheckpointTime = std::chrono::high_resolution_clock::now();
@@ -764,11 +1322,12 @@ int main(int i_argc,
     std::chrono::nanoseconds l_duration_write = std::chrono::nanoseconds::zero();
     std::chrono::nanoseconds l_duration_checkpoint = std::chrono::nanoseconds::zero();
 
-    // setup for write thread
-    std::mutex write_mutex;
-    std::atomic<bool> is_write_completed(true);
-    std::condition_variable write_condition;
-    write_condition.notify_one();
+    // the 2d output is written by a persistent worker from snapshots of the interior
+    tsunami_lab::io::AsyncWriter *l_writer = nullptr;
+    if (dimension == 2 && do_write)
+    {
+        l_writer = new tsunami_lab::io::AsyncWriter(output_slots, l_nx_local, l_ny_local);
+    }
 
     // iterate over time
     while (l_simTime < l_endTime)
@@ -776,49 +1335,43 @@ int main(int i_argc,
         auto l_currentTime = std::chrono::high_resolution_clock::now();
         std::chrono::duration<double> l_elapsedTime = l_currentTime - l_start_time;
 
-        if (l_elapsedTime.count() >= checkpoint_timer && dimension == 2 && do_write)
+        // checkpoints hold the whole domain and are not written by distributed runs
+        if (l_elapsedTime.count() >= checkpoint_timer && dimension == 2 && do_write && mpi_size == 1)
         {
-            netcdf_manager->writeCheckpoint(l_nx,
-                                            l_ny,
-                                            netcdf_manager->removeGhostCells(l_waveProp->getHeight(),
-                                                                             l_nx,
-                                                                             l_ny,
-                                                                             1,
-                                                                             1,
-                                                                             l_waveProp->getStride()),
-                                            netcdf_manager->removeGhostCells(l_waveProp->getMomentumX(),
-                                                                             l_nx,
-                                                                             l_ny,
-                                                                             1,
-                                                                             1,
-                                                                             l_waveProp->getStride()),
-                                            netcdf_manager->removeGhostCells(l_waveProp->getMomentumY(),
-                                                                             l_nx,
-                                                                             l_ny,
-                                                                             1,
-                                                                             1,
-                                                                             l_waveProp->getStride()),
-                                            netcdf_manager->removeGhostCells(l_waveProp->getBathymetry(),
-                                                                             l_nx,
-                                                                             l_ny,
-                                                                             1,
-                                                                             1,
-                                                                             l_waveProp->getStride()),
-                                            l_x_offset,
-                                            l_y_offset,
-                                            state_boundary_left,
-                                            state_boundary_right,
-                                            state_boundary_top,
-                                            state_boundary_bottom,
-                                            l_width,
-                                            l_endTime,
-                                            l_timeStep,
-                                            l_simTime,
-                                            l_nOut,
-                                            l_hMax,
-                                            simulated_frame,
-                                            resolution_div,
-                                            filename);
+            l_waveProp->getData();
+            tsunami_lab::io::AsyncWriter::Snapshot &l_snapshot = l_writer->acquireSnapshot();
+            tsunami_lab::io::AsyncWriter::copyInterior(l_waveProp->getHeight(), l_nx, l_ny, 1, 1, l_waveProp->getStride(), l_snapshot.m_h.data());
+            tsunami_lab::io::AsyncWriter::copyInterior(l_waveProp->getMomentumX(), l_nx, l_ny, 1, 1, l_waveProp->getStride(), l_snapshot.m_hu.data());
+            tsunami_lab::io::AsyncWriter::copyInterior(l_waveProp->getMomentumY(), l_nx, l_ny, 1, 1, l_waveProp->getStride(), l_snapshot.m_hv.data());
+            tsunami_lab::io::AsyncWriter::copyInterior(l_waveProp->getBathymetry(), l_nx, l_ny, 1, 1, l_waveProp->getStride(), l_snapshot.m_b.data());
+
+            // the state of the loop is captured at the time of the snapshot
+            l_writer->submitSnapshot([=](tsunami_lab::io::AsyncWriter::Snapshot const &i_snapshot)
+                                     { netcdf_manager->writeCheckpoint(l_nx,
+                                                                       l_ny,
+                                                                       i_snapshot.m_h.data(),
+                                                                       i_snapshot.m_hu.data(),
+                                                                       i_snapshot.m_hv.data(),
+                                                                       i_snapshot.m_b.data(),
+                                                                       l_x_offset,
+                                                                       l_y_offset,
+                                                                       state_boundary_left,
+                                                                       state_boundary_right,
+                                                                       state_boundary_top,
+                                                                       state_boundary_bottom,
+                                                                       l_width,
+                                                                       l_endTime,
+                                                                       l_timeStep,
+                                                                       l_simTime,
+                                                                       l_nOut,
+                                                                       l_hMax,
+                                                                       simulated_frame,
+                                                                       resolution_div,
+                                                                       filename); });
+            if (!write_parallel)
+            {
+                l_writer->flush();
+            }
             l_lastCheckpointTime = std::chrono::high_resolution_clock::now();
             l_duration_checkpoint += l_lastCheckpointTime - l_currentTime;
         }
@@ -830,12 +1383,20 @@ int main(int i_argc,
 
             std::cout << "  simulation time / #time steps: "
                       << l_simTime << " / " << l_timeStep << std::endl;
+#ifdef TSUNAMI_LAB_USE_MPI
+            if (l_waveProp_mpi != nullptr && l_timeStep > 0)
+            {
+                printTime(l_waveProp_mpi->getCommunicationTime(true), "\thalo exchange of the last time step");
+                printTime(l_waveProp_mpi->getHiddenCommunicationTime(true), "\thidden behind the interior");
+            }
+#endif
 
             if (dimension == 1 && do_write)
             {
                 std::string l_path = targetPath.string() + "/" + "solution_" + std::to_string(l_nOut) + ".csv";
                 std::cout << "  writing wave field to " << l_path << std::endl;
 
+                l_waveProp->getData();
                 std::ofstream l_file;
                 l_file.open(l_path);
                 tsunami_lab::io::Csv::write(l_dxy,
@@ -852,76 +1413,53 @@ int main(int i_argc,
 
                 l_file.close();
             }
-            else if (dimension == 2 && do_write && !write_parallel)
-            {
-                l_waveProp->getData();
-                netcdf_manager->write(l_nx,
-                                      l_ny,
-                                      resolution_div,
-                                      netcdf_manager->removeGhostCells(l_waveProp->getHeight(),
-                                                                       l_nx,
-                                                                       l_ny,
-                                                                       1,
-                                                                       1,
-                                                                       l_waveProp->getStride()),
-                                      netcdf_manager->removeGhostCells(l_waveProp->getMomentumX(),
-                                                                       l_nx,
-                                                                       l_ny,
-                                                                       1,
-                                                                       1,
-                                                                       l_waveProp->getStride()),
-                                      netcdf_manager->removeGhostCells(l_waveProp->getMomentumY(),
-                                                                       l_nx,
-                                                                       l_ny,
-                                                                       1,
-                                                                       1,
-                                                                       l_waveProp->getStride()),
-                                      l_nOut,
-                                      l_simTime,
-                                      filename);
-            }
-            else if (dimension == 2 && do_write && write_parallel)
+            else if (dimension == 2 && do_write)
             {
-                // lock until Writhe Thread is done
-                std::unique_lock<std::mutex> lock(write_mutex);
-                write_condition.wait(lock, [&]
-                                     { return is_write_completed.load(); });
+                // the frame is written from a snapshot, the time loop continues meanwhile
+                tsunami_lab::io::AsyncWriter::Snapshot &l_snapshot = l_writer->acquireSnapshot();
+
+                // patches on a device strip the ghost cells and downsample before the readback, the snapshot is then already coarse.
+                // The readback fills the snapshot in the background, the worker waits for it before writing
+                tsunami_lab::t_idx l_frameNx = l_nx_local;
+                tsunami_lab::t_idx l_frameNy = l_ny_local;
+                int l_frameDiv = resolution_div;
+                std::shared_future<void> l_readback = l_waveProp->getCoarseDataAsync(resolution_div, l_snapshot.m_h.data(), l_snapshot.m_hu.data(), l_snapshot.m_hv.data());
+                if (l_readback.valid())
+                {
+                    l_frameNx = l_nx_local / resolution_div;
+                    l_frameNy = l_ny_local / resolution_div;
+                    l_frameDiv = 1;
+                }
+                else
+                {
+                    l_waveProp->getData();
+                    tsunami_lab::io::AsyncWriter::copyInterior(l_waveProp->getHeight(), l_nx_local, l_ny_local, 1, 1, l_waveProp->getStride(), l_snapshot.m_h.data());
+                    tsunami_lab::io::AsyncWriter::copyInterior(l_waveProp->getMomentumX(), l_nx_local, l_ny_local, 1, 1, l_waveProp->getStride(), l_snapshot.m_hu.data());
+                    tsunami_lab::io::AsyncWriter::copyInterior(l_waveProp->getMomentumY(), l_nx_local, l_ny_local, 1, 1, l_waveProp->getStride(), l_snapshot.m_hv.data());
+                }
 
-                l_waveProp->getData();
-                auto n_out = l_nOut;
-                auto n_simTime = l_simTime;
-                lock.unlock();
-                std::thread write_thread([&, n_out, n_simTime]()
-                                         {
-                                             std::unique_lock<std::mutex> lock(write_mutex);
-                                             netcdf_manager->write(l_nx,
-                                                                   l_ny,
-                                                                   resolution_div,
-                                                                   netcdf_manager->removeGhostCells(l_waveProp->getHeight(),
-                                                                                                    l_nx,
-                                                                                                    l_ny,
-                                                                                                    1,
-                                                                                                    1,
-                                                                                                    l_waveProp->getStride()),
-                                                                   netcdf_manager->removeGhostCells(l_waveProp->getMomentumX(),
-                                                                                                    l_nx,
-                                                                                                    l_ny,
-                                                                                                    1,
-                                                                                                    1,
-                                                                                                    l_waveProp->getStride()),
-                                                                   netcdf_manager->removeGhostCells(l_waveProp->getMomentumY(),
-                                                                                                    l_nx,
-                                                                                                    l_ny,
-                                                                                                    1,
-                                                                                                    1,
-                                                                                                    l_waveProp->getStride()),
-                                                                   n_out,
-                                                                   n_simTime,
-                                                                   filename);
-                                             lock.unlock();
-                                             is_write_completed = true;
-                                             write_condition.notify_one(); });
-                write_thread.detach();
+                tsunami_lab::t_idx l_frame = l_nOut;
+                tsunami_lab::t_real l_frameTime = l_simTime;
+                l_writer->submitSnapshot([netcdf_manager, l_frameNx, l_frameNy, l_frameDiv, l_frame, l_frameTime, filename, l_readback](tsunami_lab::io::AsyncWriter::Snapshot const &i_snapshot)
+                                         { if (l_readback.valid())
+                                           {
+                                               l_readback.wait();
+                                           }
+                                           netcdf_manager->write(l_frameNx,
+                                                                 l_frameNy,
+                                                                 l_frameDiv,
+                                                                 i_snapshot.m_h.data(),
+                                                                 i_snapshot.m_hu.data(),
+                                                                 i_snapshot.m_hv.data(),
+                                                                 l_frame,
+                                                                 l_frameTime,
+                                                                 filename); });
+
+                // without parallel writing the frame is finished before the next time step
+                if (!write_parallel)
+                {
+                    l_writer->flush();
+                }
             }
             l_nOut++;
 
@@ -937,24 +1475,62 @@ int main(int i_argc,
 
         if (l_simTime >= multiplier && do_write)
         {
-            l_stations->writeStationOutput(l_dxy,
-                                           l_nx,
-                                           l_ny,
-                                           l_x_offset,
-                                           l_y_offset,
-                                           l_waveProp->getStride(),
-                                           l_waveProp->getHeight(),
-                                           l_waveProp->getMomentumX(),
-                                           l_waveProp->getMomentumY(),
-                                           l_waveProp->getBathymetry(),
-                                           l_simTime);
+            // the stations sample the host copy, which patches on a device only update on request
+            l_waveProp->getData();
+            std::vector<Station_sample> l_samples = l_stations->sampleStations(l_dxy,
+                                                                               l_nx_local,
+                                                                               l_ny_local,
+                                                                               l_x_offset_local,
+                                                                               l_y_offset_local,
+                                                                               l_waveProp->getStride(),
+                                                                               l_waveProp->getHeight(),
+                                                                               l_waveProp->getMomentumX(),
+                                                                               l_waveProp->getMomentumY(),
+                                                                               l_waveProp->getBathymetry());
+            if (l_writer != nullptr)
+            {
+                tsunami_lab::t_real l_sampleTime = l_simTime;
+                l_writer->submit([l_stations, l_samples, l_sampleTime]()
+                                 { l_stations->writeStationSamples(l_samples, l_sampleTime); });
+                if (!write_parallel)
+                {
+                    l_writer->flush();
+                }
+            }
+            else
+            {
+                l_stations->writeStationSamples(l_samples, l_simTime);
+            }
             multiplier += l_stations->getOutputFrequency();
         }
 
-        l_waveProp->timeStep(l_scaling);
+        // the OpenCL patch keeps the time step fixed, its steps are enqueued up to the next frame, station output or the end
+        tsunami_lab::t_idx l_nSteps = 0;
+        do
+        {
+            l_nSteps++;
+            l_timeStep++;
+            l_simTime += l_dt;
+        } while (use_opencl && l_timeStep % simulated_frame != 0 && l_simTime < l_endTime && !(l_simTime >= multiplier && do_write));
+        l_waveProp->timeSteps(l_nSteps, l_scaling);
+
+        // adapt the time step to the wave speeds of the last step, patches report 0 if unknown
+        l_speedMax = l_waveProp->getMaxWaveSpeed();
+        if (l_speedMax > 0)
+        {
+            l_dt = cfl * l_dxy / l_speedMax;
+            l_scaling = l_dt / l_dxy;
+        }
+    }
 
-        l_timeStep++;
-        l_simTime += l_dt;
+    // the outputs still in flight are part of the write time
+    std::chrono::nanoseconds l_duration_output_wait = std::chrono::nanoseconds::zero();
+    if (l_writer != nullptr)
+    {
+        auto l_drainStartTime = std::chrono::high_resolution_clock::now();
+        l_writer->flush();
+        l_duration_write += std::chrono::high_resolution_clock::now() - l_drainStartTime;
+        l_duration_output_wait = l_writer->getWaitTime();
     }
 
     auto l_end = std::chrono::high_resolution_clock::now();
@@ -967,10 +1543,27 @@ int main(int i_argc,
     printTime(l_duration_setup, "setup time");
     printTime(l_duration_write, "total write time");
     printTime(l_duration_checkpoint, "checkpoint time");
+    printTime(l_duration_output_wait, "time waited for the output");
+#ifdef TSUNAMI_LAB_USE_MPI
+    if (l_waveProp_mpi != nullptr && l_timeStep > 0)
+    {
+        std::chrono::nanoseconds l_duration_comm = l_waveProp_mpi->getCommunicationTime();
+        std::chrono::nanoseconds l_duration_hidden = l_waveProp_mpi->getHiddenCommunicationTime();
+        printTime(l_duration_comm, "total halo exchange time");
+        printTime(l_duration_hidden, "hidden halo exchange time");
+        printTime(l_duration_comm / l_timeStep, "halo exchange time per time step");
+        if (l_duration_comm.count() > 0)
+        {
+            std::cout << "hidden halo exchange: " << 100.0 * l_duration_hidden.count() / l_duration_comm.count() << "%" << std::endl;
+        }
+    }
+#endif
 
     std::cout << "finished time loop" << std::endl;
 
     // free memory
+    std::cout << "freeing memory: l_writer" << std::endl;
+    delete l_writer;
     std::cout << "freeing memory: l_setup" << std::endl;
     delete l_setup;
     std::cout << "freeing memory: l_waveProp" << std::endl;
@@ -988,5 +1581,8 @@ int main(int i_argc,
     }
 
     std::cout << "finished, exiting" << std::endl;
+#ifdef TSUNAMI_LAB_USE_MPI
+    MPI_Finalize();
+#endif
     return EXIT_SUCCESS;
 }
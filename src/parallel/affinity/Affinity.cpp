@@ -0,0 +1,151 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Pinning of the OpenMP threads to CPUs.
+ **/
+#include "Affinity.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include <omp.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+bool tsunami_lab::parallel::Affinity::isPolicy(std::string const &i_policy)
+{
+  return i_policy == "none" || i_policy == "close" || i_policy == "spread" || i_policy == "cores";
+}
+
+std::vector<int> tsunami_lab::parallel::Affinity::getCpus(std::string const &i_policy,
+                                                          int i_thread,
+                                                          int i_nThreads,
+                                                          std::vector<int> const &i_cpus,
+                                                          std::vector<int> const &i_cores)
+{
+  std::size_t l_nCpus = i_cpus.size();
+  if (l_nCpus == 0 || i_nThreads < 1)
+  {
+    return {};
+  }
+
+  if (i_policy == "close")
+  {
+    return {i_cpus[i_thread % l_nCpus]};
+  }
+  else if (i_policy == "spread")
+  {
+    // with more threads than CPUs, the CPUs are shared round-robin
+    if (std::size_t(i_nThreads) > l_nCpus)
+    {
+      return {i_cpus[i_thread % l_nCpus]};
+    }
+    return {i_cpus[std::size_t(i_thread) * l_nCpus / i_nThreads]};
+  }
+  else if (i_policy == "cores")
+  {
+    // physical cores in the order of their first CPU
+    std::vector<int> l_cores;
+    for (int l_core : i_cores)
+    {
+      if (std::find(l_cores.begin(), l_cores.end(), l_core) == l_cores.end())
+      {
+        l_cores.push_back(l_core);
+      }
+    }
+
+    int l_core = l_cores[i_thread % l_cores.size()];
+    std::vector<int> l_cpus;
+    for (std::size_t l_ci = 0; l_ci < l_nCpus; l_ci++)
+    {
+      if (i_cores[l_ci] == l_core)
+      {
+        l_cpus.push_back(i_cpus[l_ci]);
+      }
+    }
+    return l_cpus;
+  }
+
+  return {};
+}
+
+bool tsunami_lab::parallel::Affinity::pinThreads(std::string const &i_policy)
+{
+  if (i_policy == "none")
+  {
+    return true;
+  }
+  if (!isPolicy(i_policy))
+  {
+    std::cerr << "undefined affinity policy " << i_policy << std::endl;
+    return false;
+  }
+
+#ifdef __linux__
+  // CPUs the process may run on, e.g. restricted by taskset or the batch system
+  cpu_set_t l_allowed;
+  CPU_ZERO(&l_allowed);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &l_allowed) != 0)
+  {
+    std::cerr << "could not get the CPUs of the process" << std::endl;
+    return false;
+  }
+
+  // CPUs with the same socket and core id are hardware threads of the same physical core
+  std::vector<int> l_cpus;
+  std::vector<int> l_cores;
+  for (int l_cpu = 0; l_cpu < CPU_SETSIZE; l_cpu++)
+  {
+    if (!CPU_ISSET(l_cpu, &l_allowed))
+    {
+      continue;
+    }
+    std::string l_topology = "/sys/devices/system/cpu/cpu" + std::to_string(l_cpu) + "/topology/";
+    std::ifstream l_coreFile(l_topology + "core_id");
+    std::ifstream l_socketFile(l_topology + "physical_package_id");
+    int l_core = 0;
+    int l_socket = 0;
+    if (!(l_coreFile >> l_core) || !(l_socketFile >> l_socket))
+    {
+      // unknown topology: each CPU is a core of its own
+      l_core = l_cpu;
+      l_socket = -1;
+    }
+    l_cpus.push_back(l_cpu);
+    l_cores.push_back(l_socket * 65536 + l_core);
+  }
+
+  bool l_pinned = true;
+#pragma omp parallel reduction(&& : l_pinned)
+  {
+    std::vector<int> l_threadCpus = getCpus(i_policy,
+                                            omp_get_thread_num(),
+                                            omp_get_num_threads(),
+                                            l_cpus,
+                                            l_cores);
+
+    cpu_set_t l_set;
+    CPU_ZERO(&l_set);
+    for (int l_cpu : l_threadCpus)
+    {
+      CPU_SET(l_cpu, &l_set);
+    }
+
+    // pid 0 binds the calling thread
+    l_pinned = !l_threadCpus.empty() && sched_setaffinity(0, sizeof(cpu_set_t), &l_set) == 0;
+  }
+
+  if (!l_pinned)
+  {
+    std::cerr << "could not bind all threads with the affinity policy " << i_policy << std::endl;
+  }
+  return l_pinned;
+#else
+  std::cerr << "thread affinity is only supported on Linux" << std::endl;
+  return false;
+#endif
+}
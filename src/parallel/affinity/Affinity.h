@@ -0,0 +1,68 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Pinning of the OpenMP threads to CPUs.
+ **/
+#ifndef TSUNAMI_LAB_PARALLEL_AFFINITY
+#define TSUNAMI_LAB_PARALLEL_AFFINITY
+
+#include <string>
+#include <vector>
+
+namespace tsunami_lab
+{
+  namespace parallel
+  {
+    class Affinity;
+  }
+}
+
+/**
+ * Binds the OpenMP threads to CPUs according to a policy:
+ *   close:  thread i runs on the i-th CPU of the process, consecutive threads share a socket.
+ *   spread: the threads are distributed evenly over the CPUs of the process, and thus over the sockets.
+ *   cores:  thread i runs on the hardware threads of the i-th physical core.
+ *
+ * The policies are applied with sched_setaffinity from within a parallel region. The OpenMP runtime reads
+ * OMP_PROC_BIND and OMP_PLACES once at program start, such that setting them in main has no effect.
+ **/
+class tsunami_lab::parallel::Affinity
+{
+public:
+  /**
+   * Checks if the policy is known.
+   *
+   * @param i_policy name of the policy.
+   * @return true if the policy is 'none', 'close', 'spread' or 'cores'.
+   **/
+  static bool isPolicy(std::string const &i_policy);
+
+  /**
+   * Gets the CPUs a thread is bound to.
+   *
+   * @param i_policy 'close', 'spread' or 'cores'.
+   * @param i_thread id of the thread.
+   * @param i_nThreads number of threads.
+   * @param i_cpus CPUs of the process in ascending order.
+   * @param i_cores physical core of each CPU in i_cpus, e.g. socket and core id combined.
+   * @return CPUs of the thread, empty for an unknown policy.
+   **/
+  static std::vector<int> getCpus(std::string const &i_policy,
+                                  int i_thread,
+                                  int i_nThreads,
+                                  std::vector<int> const &i_cpus,
+                                  std::vector<int> const &i_cores);
+
+  /**
+   * Binds the threads of the OpenMP parallel regions to CPUs. The binding is kept as long as the
+   * runtime reuses its threads, i.e. as long as the number of threads does not change.
+   *
+   * @param i_policy 'none', 'close', 'spread' or 'cores'; 'none' leaves the threads unbound.
+   * @return true if all threads were bound.
+   **/
+  static bool pinThreads(std::string const &i_policy);
+};
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Unit tests for the pinning of the OpenMP threads.
+ **/
+#include <catch2/catch.hpp>
+#include <vector>
+#include "Affinity.h"
+
+TEST_CASE("Test the CPUs of the affinity policies.", "[Affinity]")
+{
+  /*
+   * Two sockets with two cores and two hardware threads each, numbered like Linux does:
+   *
+   *   CPU:    0 1 2 3 4 5 6 7
+   *   socket: 0 0 1 1 0 0 1 1
+   *   core:   0 1 0 1 0 1 0 1
+   *
+   * The physical cores are given as socket * 65536 + core, like Affinity::pinThreads combines the ids.
+   */
+  std::vector<int> l_cpus = {0, 1, 2, 3, 4, 5, 6, 7};
+  std::vector<int> l_cores = {0, 1, 65536, 65537, 0, 1, 65536, 65537};
+
+  REQUIRE(tsunami_lab::parallel::Affinity::isPolicy("none"));
+  REQUIRE(tsunami_lab::parallel::Affinity::isPolicy("close"));
+  REQUIRE(tsunami_lab::parallel::Affinity::isPolicy("spread"));
+  REQUIRE(tsunami_lab::parallel::Affinity::isPolicy("cores"));
+  REQUIRE_FALSE(tsunami_lab::parallel::Affinity::isPolicy("master"));
+
+  // close: consecutive CPUs, wrapping around
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("close", 0, 4, l_cpus, l_cores) == std::vector<int>{0});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("close", 3, 4, l_cpus, l_cores) == std::vector<int>{3});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("close", 9, 10, l_cpus, l_cores) == std::vector<int>{1});
+
+  // spread: evenly distributed, two threads end up on both sockets
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("spread", 0, 2, l_cpus, l_cores) == std::vector<int>{0});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("spread", 1, 2, l_cpus, l_cores) == std::vector<int>{4});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("spread", 3, 4, l_cpus, l_cores) == std::vector<int>{6});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("spread", 8, 9, l_cpus, l_cores) == std::vector<int>{0});
+
+  // cores: all hardware threads of a physical core
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("cores", 0, 4, l_cpus, l_cores) == std::vector<int>{0, 4});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("cores", 2, 4, l_cpus, l_cores) == std::vector<int>{2, 6});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("cores", 5, 6, l_cpus, l_cores) == std::vector<int>{1, 5});
+
+  // restricted CPU set, e.g. by taskset
+  std::vector<int> l_cpusRestricted = {2, 3, 6};
+  std::vector<int> l_coresRestricted = {65536, 65537, 65536};
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("close", 1, 2, l_cpusRestricted, l_coresRestricted) == std::vector<int>{3});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("cores", 0, 2, l_cpusRestricted, l_coresRestricted) == std::vector<int>{2, 6});
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("cores", 1, 2, l_cpusRestricted, l_coresRestricted) == std::vector<int>{3});
+
+  // unknown policy or no CPUs
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("master", 0, 1, l_cpus, l_cores).empty());
+  REQUIRE(tsunami_lab::parallel::Affinity::getCpus("close", 0, 1, {}, {}).empty());
+}
+
+TEST_CASE("Test the pinning of the threads.", "[AffinityPin]")
+{
+  REQUIRE(tsunami_lab::parallel::Affinity::pinThreads("none"));
+  REQUIRE_FALSE(tsunami_lab::parallel::Affinity::pinThreads("master"));
+}
@@ -0,0 +1,340 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Ensemble of scenarios sharing the grid and the bathymetry.
+ **/
+#include "Ensemble.h"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <mutex>
+
+tsunami_lab::parallel::Ensemble::Ensemble(t_idx i_nx,
+                                          t_idx i_ny,
+                                          t_real i_dxy,
+                                          t_real i_x_offset,
+                                          t_real i_y_offset,
+                                          int i_state_boundary_left,
+                                          int i_state_boundary_right,
+                                          int i_state_boundary_top,
+                                          int i_state_boundary_bottom,
+                                          t_real i_cfl)
+{
+  m_nx = i_nx;
+  m_ny = i_ny;
+  m_dxy = i_dxy;
+  m_x_offset = i_x_offset;
+  m_y_offset = i_y_offset;
+  m_boundary[0] = i_state_boundary_left;
+  m_boundary[1] = i_state_boundary_right;
+  m_boundary[2] = i_state_boundary_top;
+  m_boundary[3] = i_state_boundary_bottom;
+  m_cfl = i_cfl;
+
+  m_bathymetry = new patches::WavePropagation2d<>(m_nx,
+                                                  m_ny,
+                                                  m_boundary[0],
+                                                  m_boundary[1],
+                                                  m_boundary[2],
+                                                  m_boundary[3]);
+}
+
+tsunami_lab::parallel::Ensemble::~Ensemble()
+{
+  delete m_bathymetry;
+}
+
+void tsunami_lab::parallel::Ensemble::setBathymetry(setups::Setup const &i_setup)
+{
+  t_idx l_nRowsBand = std::min<t_idx>(m_ny, 256);
+  std::vector<t_real> l_band[4];
+  for (std::vector<t_real> &l_quantity : l_band)
+  {
+    l_quantity.resize(m_nx * l_nRowsBand);
+  }
+
+  for (t_idx l_iy0 = 0; l_iy0 < m_ny; l_iy0 += l_nRowsBand)
+  {
+    t_idx l_nRows = std::min(l_nRowsBand, m_ny - l_iy0);
+    setups::Setup::Region l_region = {0, l_iy0, m_nx, l_nRows, m_dxy, m_x_offset, m_y_offset};
+
+    i_setup.fill(l_region, l_band[0].data(), l_band[1].data(), l_band[2].data(), l_band[3].data(), m_nx);
+    m_bathymetry->setCells(0, l_iy0, m_nx, l_nRows, m_nx, l_band[0].data(), l_band[1].data(), l_band[2].data(), l_band[3].data());
+  }
+
+  // the members share the bathymetry concurrently
+  m_bathymetry->fixBathymetry();
+}
+
+tsunami_lab::t_real tsunami_lab::parallel::Ensemble::fillBand(setups::Setup const &i_setup,
+                                                              t_idx i_iy0,
+                                                              t_idx i_nRows,
+                                                              std::vector<t_real> (&o_band)[4]) const
+{
+  setups::Setup::Region l_region = {0, i_iy0, m_nx, i_nRows, m_dxy, m_x_offset, m_y_offset};
+  i_setup.fill(l_region, o_band[0].data(), o_band[1].data(), o_band[2].data(), o_band[3].data(), m_nx);
+
+  // the bathymetry of the member is not stored, it has to match the common one
+  t_real const *l_b = m_bathymetry->getBathymetry();
+  t_idx l_stride = m_bathymetry->getStride();
+  t_real l_hMax = std::numeric_limits<t_real>::lowest();
+  bool l_sameBathymetry = true;
+
+  for (t_idx l_iy = 0; l_iy < i_nRows; l_iy++)
+  {
+    for (t_idx l_ix = 0; l_ix < m_nx; l_ix++)
+    {
+      t_idx l_id = l_ix + l_iy * m_nx;
+      l_sameBathymetry = l_sameBathymetry && o_band[3][l_id] == l_b[(l_ix + 1) + (i_iy0 + l_iy + 1) * l_stride];
+      l_hMax = std::max(o_band[0][l_id], l_hMax);
+    }
+  }
+  if (!l_sameBathymetry)
+  {
+    std::cerr << "the members of an ensemble need the same bathymetry" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return l_hMax;
+}
+
+tsunami_lab::t_real tsunami_lab::parallel::Ensemble::setMember(setups::Setup const &i_setup,
+                                                               patches::WavePropagation2d<> &io_waveProp) const
+{
+  t_idx l_nRowsBand = std::min<t_idx>(m_ny, 256);
+  std::vector<t_real> l_band[4];
+  for (std::vector<t_real> &l_quantity : l_band)
+  {
+    l_quantity.resize(m_nx * l_nRowsBand);
+  }
+
+  t_real l_hMax = std::numeric_limits<t_real>::lowest();
+  for (t_idx l_iy0 = 0; l_iy0 < m_ny; l_iy0 += l_nRowsBand)
+  {
+    t_idx l_nRows = std::min(l_nRowsBand, m_ny - l_iy0);
+    l_hMax = std::max(fillBand(i_setup, l_iy0, l_nRows, l_band), l_hMax);
+    io_waveProp.setCells(0, l_iy0, m_nx, l_nRows, m_nx, l_band[0].data(), l_band[1].data(), l_band[2].data(), l_band[3].data());
+  }
+
+  return l_hMax;
+}
+
+tsunami_lab::t_real tsunami_lab::parallel::Ensemble::setMember(setups::Setup const &i_setup,
+                                                               t_idx i_lane,
+                                                               patches::WavePropagation2dLanes &io_lanes) const
+{
+  t_idx l_nRowsBand = std::min<t_idx>(m_ny, 256);
+  std::vector<t_real> l_band[4];
+  for (std::vector<t_real> &l_quantity : l_band)
+  {
+    l_quantity.resize(m_nx * l_nRowsBand);
+  }
+
+  t_real l_hMax = std::numeric_limits<t_real>::lowest();
+  for (t_idx l_iy0 = 0; l_iy0 < m_ny; l_iy0 += l_nRowsBand)
+  {
+    t_idx l_nRows = std::min(l_nRowsBand, m_ny - l_iy0);
+    l_hMax = std::max(fillBand(i_setup, l_iy0, l_nRows, l_band), l_hMax);
+    io_lanes.setCells(i_lane, 0, l_iy0, m_nx, l_nRows, m_nx, l_band[0].data(), l_band[1].data(), l_band[2].data());
+  }
+
+  return l_hMax;
+}
+
+tsunami_lab::t_idx tsunami_lab::parallel::Ensemble::runMember(t_idx i_member,
+                                                              setups::Setup const &i_setup,
+                                                              t_real i_endTime,
+                                                              t_finish const &i_finish,
+                                                              std::mutex &io_finishMutex) const
+{
+  patches::WavePropagation2d<> l_waveProp(m_nx,
+                                          m_ny,
+                                          m_boundary[0],
+                                          m_boundary[1],
+                                          m_boundary[2],
+                                          m_boundary[3]);
+  l_waveProp.shareBathymetry(*m_bathymetry);
+  t_real l_hMax = setMember(i_setup, l_waveProp);
+
+  // same adaptive time steps as a single simulation
+  t_real l_speedMax = std::sqrt(9.81 * l_hMax);
+  t_real l_dt = m_cfl * m_dxy / l_speedMax;
+  t_real l_scaling = l_dt / m_dxy;
+  t_real l_simTime = 0;
+  t_idx l_timeStep = 0;
+
+  while (l_simTime < i_endTime)
+  {
+    l_waveProp.timeStep(l_scaling);
+
+    l_timeStep++;
+    l_simTime += l_dt;
+
+    l_speedMax = l_waveProp.getMaxWaveSpeed();
+    if (l_speedMax > 0)
+    {
+      l_dt = m_cfl * m_dxy / l_speedMax;
+      l_scaling = l_dt / m_dxy;
+    }
+  }
+
+  if (i_finish)
+  {
+    std::lock_guard<std::mutex> l_lock(io_finishMutex);
+    i_finish(i_member,
+             l_waveProp.getHeight(),
+             l_waveProp.getMomentumX(),
+             l_waveProp.getMomentumY(),
+             l_waveProp.getStride(),
+             l_simTime,
+             l_timeStep);
+  }
+
+  return l_timeStep;
+}
+
+tsunami_lab::t_idx tsunami_lab::parallel::Ensemble::runBatch(t_idx i_member0,
+                                                             std::vector<setups::Setup const *> const &i_setups,
+                                                             t_real i_endTime,
+                                                             t_finish const &i_finish,
+                                                             std::mutex &io_finishMutex) const
+{
+  t_idx l_nLanes = i_setups.size();
+  patches::WavePropagation2dLanes l_lanes(m_nx,
+                                          m_ny,
+                                          l_nLanes,
+                                          m_boundary[0],
+                                          m_boundary[1],
+                                          m_boundary[2],
+                                          m_boundary[3],
+                                          m_bathymetry->getBathymetry());
+
+  // same adaptive time steps as a single simulation in each lane
+  std::vector<t_real> l_dt(l_nLanes);
+  std::vector<t_real> l_scaling(l_nLanes);
+  std::vector<t_real> l_simTime(l_nLanes, 0);
+  std::vector<t_idx> l_timeStep(l_nLanes, 0);
+  for (t_idx l_la = 0; l_la < l_nLanes; l_la++)
+  {
+    t_real l_hMax = setMember(*i_setups[l_la], l_la, l_lanes);
+    t_real l_speedMax = std::sqrt(9.81 * l_hMax);
+    l_dt[l_la] = m_cfl * m_dxy / l_speedMax;
+    l_scaling[l_la] = l_dt[l_la] / m_dxy;
+  }
+
+  // lanes which reached the end time take steps of size 0
+  std::vector<t_real> l_scalingStep(l_nLanes);
+  bool l_running = true;
+  while (l_running)
+  {
+    for (t_idx l_la = 0; l_la < l_nLanes; l_la++)
+    {
+      l_scalingStep[l_la] = l_simTime[l_la] < i_endTime ? l_scaling[l_la] : 0;
+    }
+
+    l_lanes.timeStep(l_scalingStep.data());
+
+    l_running = false;
+    for (t_idx l_la = 0; l_la < l_nLanes; l_la++)
+    {
+      if (l_simTime[l_la] < i_endTime)
+      {
+        l_timeStep[l_la]++;
+        l_simTime[l_la] += l_dt[l_la];
+
+        t_real l_speedMax = l_lanes.getMaxWaveSpeed(l_la);
+        if (l_speedMax > 0)
+        {
+          l_dt[l_la] = m_cfl * m_dxy / l_speedMax;
+          l_scaling[l_la] = l_dt[l_la] / m_dxy;
+        }
+      }
+      l_running = l_running || l_simTime[l_la] < i_endTime;
+    }
+  }
+
+  t_idx l_nTimeSteps = 0;
+  std::vector<t_real> l_lane[3];
+  for (std::vector<t_real> &l_quantity : l_lane)
+  {
+    l_quantity.resize((m_nx + 2) * (m_ny + 2));
+  }
+  for (t_idx l_la = 0; l_la < l_nLanes; l_la++)
+  {
+    l_nTimeSteps += l_timeStep[l_la];
+    if (i_finish)
+    {
+      l_lanes.getLane(l_la, l_lane[0].data(), l_lane[1].data(), l_lane[2].data());
+
+      std::lock_guard<std::mutex> l_lock(io_finishMutex);
+      i_finish(i_member0 + l_la,
+               l_lane[0].data(),
+               l_lane[1].data(),
+               l_lane[2].data(),
+               l_lanes.getStride(),
+               l_simTime[l_la],
+               l_timeStep[l_la]);
+    }
+  }
+
+  return l_nTimeSteps;
+}
+
+tsunami_lab::parallel::Ensemble::Statistics tsunami_lab::parallel::Ensemble::run(std::vector<setups::Setup const *> const &i_members,
+                                                                               t_real i_endTime,
+                                                                               t_idx i_nConcurrent,
+                                                                               t_finish i_finish,
+                                                                               t_idx i_nLanes)
+{
+  Statistics l_statistics;
+  if (i_members.empty())
+  {
+    return l_statistics;
+  }
+  auto l_start = std::chrono::high_resolution_clock::now();
+
+  // members are scheduled in batches of lanes, a batch of one lane runs the member on its own patch
+  t_idx l_nLanes = std::clamp<t_idx>(i_nLanes, 1, i_members.size());
+  t_idx l_nBatches = (i_members.size() + l_nLanes - 1) / l_nLanes;
+
+  // concurrent batches in the outer level, the threads of each batch in the inner level
+  int l_nConcurrent = std::clamp<t_idx>(i_nConcurrent, 1, l_nBatches);
+  int l_nThreadsMember = std::max(1, omp_get_max_threads() / l_nConcurrent);
+  int l_maxLevels = omp_get_max_active_levels();
+  omp_set_max_active_levels(2);
+
+  std::mutex l_finishMutex;
+  unsigned long long l_nTimeSteps = 0;
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(l_nConcurrent) reduction(+ : l_nTimeSteps)
+  for (t_idx l_ba = 0; l_ba < l_nBatches; l_ba++)
+  {
+    omp_set_num_threads(l_nThreadsMember);
+
+    t_idx l_first = l_ba * l_nLanes;
+    t_idx l_last = std::min<t_idx>(l_first + l_nLanes, i_members.size());
+    if (l_nLanes == 1)
+    {
+      l_nTimeSteps += runMember(l_first, *i_members[l_first], i_endTime, i_finish, l_finishMutex);
+    }
+    else
+    {
+      std::vector<setups::Setup const *> l_setups(i_members.begin() + l_first, i_members.begin() + l_last);
+      l_nTimeSteps += runBatch(l_first, l_setups, i_endTime, i_finish, l_finishMutex);
+    }
+  }
+
+  omp_set_max_active_levels(l_maxLevels);
+
+  l_statistics.m_nTimeSteps = l_nTimeSteps;
+  l_statistics.m_nCellUpdates = l_nTimeSteps * m_nx * m_ny;
+  l_statistics.m_duration = std::chrono::high_resolution_clock::now() - l_start;
+  return l_statistics;
+}
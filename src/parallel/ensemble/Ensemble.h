@@ -0,0 +1,250 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Ensemble of scenarios sharing the grid and the bathymetry.
+ **/
+#ifndef TSUNAMI_LAB_PARALLEL_ENSEMBLE
+#define TSUNAMI_LAB_PARALLEL_ENSEMBLE
+
+#include "../../constants.h"
+#include "../../patches/wavepropagation2d/WavePropagation2d.h"
+#include "../../patches/wavepropagation2d_lanes/WavePropagation2dLanes.h"
+#include "../../setups/Setup.h"
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace tsunami_lab
+{
+  namespace parallel
+  {
+    class Ensemble;
+  }
+}
+
+/**
+ * Runs scenarios (members) on the same grid with a common, read-only bathymetry.
+ *
+ * The bathymetry is held once by the ensemble, the members only allocate their heights and momenta.
+ * The members are distributed dynamically over a pool of threads, such that a given number of members runs
+ * concurrently; the remaining threads of the pool are split evenly between the concurrent members.
+ * Each member takes adaptive time steps like a single simulation and is identical to it bitwise.
+ *
+ * Optionally, batches of members are advanced together as the lanes of a WavePropagation2dLanes, which computes
+ * the same edge of all lanes in one vectorized loop. Each lane keeps its own time step; lanes which reached
+ * the end time are kept unchanged until the whole batch is done.
+ **/
+class tsunami_lab::parallel::Ensemble
+{
+public:
+  /**
+   * Work of a run.
+   **/
+  struct Statistics
+  {
+    //! number of time steps of all members
+    unsigned long long m_nTimeSteps = 0;
+
+    //! number of cell updates of all members
+    unsigned long long m_nCellUpdates = 0;
+
+    //! wall time of the run
+    std::chrono::nanoseconds m_duration = std::chrono::nanoseconds::zero();
+
+    /**
+     * Gets the aggregate throughput of all members.
+     *
+     * @return cell updates per second.
+     **/
+    double getCellUpdatesPerSecond() const
+    {
+      return m_duration.count() > 0 ? m_nCellUpdates / (m_duration.count() * 1.0E-9) : 0;
+    }
+  };
+
+  /**
+   * Gets the final state of a member, called for one member at a time.
+   * The fields include one layer of ghost cells, i.e. cell (ix, iy) is stored at (ix + 1) + (iy + 1) * i_stride.
+   *
+   * @param i_member id of the member.
+   * @param i_h water heights of the member.
+   * @param i_hu momenta in x-direction of the member.
+   * @param i_hv momenta in y-direction of the member.
+   * @param i_stride stride of the rows.
+   * @param i_time simulated time.
+   * @param i_nTimeSteps number of time steps of the member.
+   **/
+  typedef std::function<void(t_idx i_member,
+                             t_real const *i_h,
+                             t_real const *i_hu,
+                             t_real const *i_hv,
+                             t_idx i_stride,
+                             t_real i_time,
+                             t_idx i_nTimeSteps)>
+      t_finish;
+
+private:
+  //! number of cells in x-direction
+  t_idx m_nx;
+
+  //! number of cells in y-direction
+  t_idx m_ny;
+
+  //! cell width in x- and y-direction
+  t_real m_dxy;
+
+  //! offset of the coordinates in x-direction
+  t_real m_x_offset;
+
+  //! offset of the coordinates in y-direction
+  t_real m_y_offset;
+
+  //! boundary conditions: left, right, top, bottom (0 = open, 1 = closed)
+  int m_boundary[4];
+
+  //! CFL number of the adaptive time steps
+  t_real m_cfl;
+
+  //! patch which holds the common bathymetry, its heights and momenta are not used
+  patches::WavePropagation2d<> *m_bathymetry = nullptr;
+
+  /**
+   * Fills a band of rows with the initial values of a member and checks its bathymetry against the common one.
+   *
+   * @param i_setup setup of the member.
+   * @param i_iy0 id of the band's first row.
+   * @param i_nRows number of rows of the band.
+   * @param o_band will be set to the heights, momenta in x- and y-direction and bathymetry of the band, stride #cells_x.
+   * @return maximum height of the band.
+   **/
+  t_real fillBand(setups::Setup const &i_setup,
+                  t_idx i_iy0,
+                  t_idx i_nRows,
+                  std::vector<t_real> (&o_band)[4]) const;
+
+  /**
+   * Sets the initial heights and momenta of a member.
+   *
+   * @param i_setup setup of the member.
+   * @param io_waveProp patch of the member, which shares the common bathymetry.
+   * @return maximum initial height.
+   **/
+  t_real setMember(setups::Setup const &i_setup,
+                   patches::WavePropagation2d<> &io_waveProp) const;
+
+  /**
+   * Sets the initial heights and momenta of a member in a lane.
+   *
+   * @param i_setup setup of the member.
+   * @param i_lane lane of the member.
+   * @param io_lanes patch of the member's batch, which shares the common bathymetry.
+   * @return maximum initial height.
+   **/
+  t_real setMember(setups::Setup const &i_setup,
+                   t_idx i_lane,
+                   patches::WavePropagation2dLanes &io_lanes) const;
+
+  /**
+   * Runs one member on its own patch until the end time.
+   *
+   * @param i_member id of the member.
+   * @param i_setup setup of the member.
+   * @param i_endTime simulated time.
+   * @param i_finish called with the final state, nullptr if not required.
+   * @param io_finishMutex serializes the calls of i_finish.
+   * @return number of time steps.
+   **/
+  t_idx runMember(t_idx i_member,
+                  setups::Setup const &i_setup,
+                  t_real i_endTime,
+                  t_finish const &i_finish,
+                  std::mutex &io_finishMutex) const;
+
+  /**
+   * Runs a batch of members as the lanes of one patch until the end time.
+   *
+   * @param i_member0 id of the batch's first member.
+   * @param i_setups setups of the members of the batch.
+   * @param i_endTime simulated time.
+   * @param i_finish called with the final state of each member, nullptr if not required.
+   * @param io_finishMutex serializes the calls of i_finish.
+   * @return number of time steps of all members of the batch.
+   **/
+  t_idx runBatch(t_idx i_member0,
+                 std::vector<setups::Setup const *> const &i_setups,
+                 t_real i_endTime,
+                 t_finish const &i_finish,
+                 std::mutex &io_finishMutex) const;
+
+public:
+  /**
+   * Constructs the ensemble.
+   *
+   * @param i_nx number of cells in x-direction.
+   * @param i_ny number of cells in y-direction.
+   * @param i_dxy cell width in x- and y-direction.
+   * @param i_x_offset offset of the coordinates in x-direction, cell (ix, iy) lies at (ix * i_dxy - i_x_offset, iy * i_dxy - i_y_offset).
+   * @param i_y_offset offset of the coordinates in y-direction.
+   * @param i_state_boundary_left state of the left boundary (0 = open, 1 = closed).
+   * @param i_state_boundary_right state of the right boundary.
+   * @param i_state_boundary_top state of the top boundary.
+   * @param i_state_boundary_bottom state of the bottom boundary.
+   * @param i_cfl CFL number of the adaptive time steps.
+   **/
+  Ensemble(t_idx i_nx,
+           t_idx i_ny,
+           t_real i_dxy,
+           t_real i_x_offset,
+           t_real i_y_offset,
+           int i_state_boundary_left,
+           int i_state_boundary_right,
+           int i_state_boundary_top,
+           int i_state_boundary_bottom,
+           t_real i_cfl);
+
+  /**
+   * Destructor which frees the common bathymetry.
+   **/
+  ~Ensemble();
+
+  Ensemble(Ensemble const &) = delete;
+  Ensemble &operator=(Ensemble const &) = delete;
+
+  /**
+   * Sets the common bathymetry from a setup. All members have to have the same bathymetry.
+   *
+   * @param i_setup setup, e.g. the first member.
+   **/
+  void setBathymetry(setups::Setup const &i_setup);
+
+  /**
+   * Gets the common bathymetry including the ghost cells, with the stride of the fields passed to t_finish.
+   *
+   * @return bathymetry.
+   **/
+  t_real const *getBathymetry() const
+  {
+    return m_bathymetry->getBathymetry();
+  }
+
+  /**
+   * Runs the members until the end time.
+   *
+   * @param i_members setups of the members, whose bathymetry equals the common one.
+   * @param i_endTime simulated time of each member.
+   * @param i_nConcurrent number of members (batches of members with lanes) which run concurrently.
+   * @param i_finish called with the final state of each member, nullptr if not required.
+   * @param i_nLanes number of members which are advanced together in the lanes of one patch, 1 runs each member on its own patch.
+   * @return work and wall time of the run.
+   **/
+  Statistics run(std::vector<setups::Setup const *> const &i_members,
+                 t_real i_endTime,
+                 t_idx i_nConcurrent,
+                 t_finish i_finish,
+                 t_idx i_nLanes = 1);
+};
+
+#endif
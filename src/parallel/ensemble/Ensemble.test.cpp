@@ -0,0 +1,169 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Unit tests for the ensemble of scenarios sharing the bathymetry.
+ **/
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <vector>
+#include "Ensemble.h"
+
+/**
+ * Circular hump of water over a sloped bathymetry, the hump differs between the members.
+ **/
+class Hump : public tsunami_lab::setups::Setup
+{
+private:
+  tsunami_lab::t_real m_x;
+  tsunami_lab::t_real m_height;
+
+public:
+  Hump(tsunami_lab::t_real i_x,
+       tsunami_lab::t_real i_height) : m_x(i_x), m_height(i_height) {}
+
+  tsunami_lab::t_real getHeight(tsunami_lab::t_real i_x,
+                                tsunami_lab::t_real i_y) const
+  {
+    return (i_x - m_x) * (i_x - m_x) + (i_y - 20) * (i_y - 20) < 36 ? m_height : 10;
+  }
+
+  tsunami_lab::t_real getMomentumX(tsunami_lab::t_real,
+                                   tsunami_lab::t_real) const
+  {
+    return 0;
+  }
+
+  tsunami_lab::t_real getMomentumY(tsunami_lab::t_real,
+                                   tsunami_lab::t_real) const
+  {
+    return 0;
+  }
+
+  tsunami_lab::t_real getBathymetry(tsunami_lab::t_real i_x,
+                                    tsunami_lab::t_real) const
+  {
+    return -20 + i_x * 0.05f;
+  }
+};
+
+/**
+ * Runs a hump as single simulation with the time stepping of main.
+ *
+ * @param i_setup hump.
+ * @param o_h will be set to the final heights, including the ghost cells.
+ * @return number of time steps.
+ **/
+static tsunami_lab::t_idx runSingle(Hump const &i_setup,
+                                    std::vector<tsunami_lab::t_real> &o_h)
+{
+  tsunami_lab::patches::WavePropagation2d<> l_waveProp(50, 40, 1, 0, 0, 1);
+  tsunami_lab::t_real l_hMax = 0;
+  for (tsunami_lab::t_idx l_cy = 0; l_cy < 40; l_cy++)
+  {
+    for (tsunami_lab::t_idx l_cx = 0; l_cx < 50; l_cx++)
+    {
+      l_waveProp.setHeight(l_cx, l_cy, i_setup.getHeight(l_cx, l_cy));
+      l_waveProp.setMomentumX(l_cx, l_cy, 0);
+      l_waveProp.setMomentumY(l_cx, l_cy, 0);
+      l_waveProp.setBathymetry(l_cx, l_cy, i_setup.getBathymetry(l_cx, l_cy));
+      l_hMax = std::max(i_setup.getHeight(l_cx, l_cy), l_hMax);
+    }
+  }
+
+  tsunami_lab::t_real l_speedMax = std::sqrt(9.81 * l_hMax);
+  tsunami_lab::t_real l_dt = tsunami_lab::t_real(0.5) / l_speedMax;
+  tsunami_lab::t_real l_scaling = l_dt;
+  tsunami_lab::t_real l_simTime = 0;
+  tsunami_lab::t_idx l_timeStep = 0;
+  while (l_simTime < 5)
+  {
+    l_waveProp.timeStep(l_scaling);
+    l_timeStep++;
+    l_simTime += l_dt;
+    l_speedMax = l_waveProp.getMaxWaveSpeed();
+    if (l_speedMax > 0)
+    {
+      l_dt = tsunami_lab::t_real(0.5) / l_speedMax;
+      l_scaling = l_dt;
+    }
+  }
+
+  o_h.assign(l_waveProp.getHeight(), l_waveProp.getHeight() + 52 * 42);
+  return l_timeStep;
+}
+
+/**
+ * Runs three humps as ensemble and compares each member with a single simulation bitwise.
+ *
+ * @param i_nLanes number of members in the lanes of one patch.
+ **/
+static void compareWithSingle(tsunami_lab::t_idx i_nLanes)
+{
+  Hump l_hump0(10, 15);
+  Hump l_hump1(25, 18);
+  Hump l_hump2(40, 12);
+  std::vector<tsunami_lab::setups::Setup const *> l_members = {&l_hump0, &l_hump1, &l_hump2};
+
+  tsunami_lab::parallel::Ensemble l_ensemble(50, 40, 1, 0, 0, 1, 0, 0, 1, 0.5);
+  l_ensemble.setBathymetry(l_hump0);
+
+  std::vector<std::vector<tsunami_lab::t_real>> l_heights(3);
+  std::vector<tsunami_lab::t_idx> l_nTimeSteps(3, 0);
+  tsunami_lab::parallel::Ensemble::Statistics l_statistics = l_ensemble.run(l_members,
+                                                                             5,
+                                                                             2,
+                                                                             [&](tsunami_lab::t_idx i_member,
+                                                                                 tsunami_lab::t_real const *i_h,
+                                                                                 tsunami_lab::t_real const *,
+                                                                                 tsunami_lab::t_real const *,
+                                                                                 tsunami_lab::t_idx i_stride,
+                                                                                 tsunami_lab::t_real,
+                                                                                 tsunami_lab::t_idx i_nTimeSteps)
+                                                                             {
+                                                                               REQUIRE(i_stride == 52);
+                                                                               l_heights[i_member].assign(i_h, i_h + 52 * 42);
+                                                                               l_nTimeSteps[i_member] = i_nTimeSteps;
+                                                                             },
+                                                                             i_nLanes);
+
+  REQUIRE(l_statistics.m_nTimeSteps == l_nTimeSteps[0] + l_nTimeSteps[1] + l_nTimeSteps[2]);
+  REQUIRE(l_statistics.m_nCellUpdates == l_statistics.m_nTimeSteps * 50 * 40);
+  REQUIRE(l_statistics.getCellUpdatesPerSecond() > 0);
+
+  for (tsunami_lab::t_idx l_me = 0; l_me < 3; l_me++)
+  {
+    std::vector<tsunami_lab::t_real> l_h;
+    REQUIRE(l_nTimeSteps[l_me] == runSingle(*static_cast<Hump const *>(l_members[l_me]), l_h));
+    for (tsunami_lab::t_idx l_cy = 1; l_cy < 41; l_cy++)
+    {
+      for (tsunami_lab::t_idx l_cx = 1; l_cx < 51; l_cx++)
+      {
+        REQUIRE(l_heights[l_me][l_cx + l_cy * 52] == l_h[l_cx + l_cy * 52]);
+      }
+    }
+  }
+}
+
+TEST_CASE("Test the ensemble against single simulations.", "[Ensemble]")
+{
+  /*
+   * Test case:
+   *
+   *   Three humps at different positions and heights on 50 x 40 cells, the left and bottom boundaries are closed.
+   *   Two members run concurrently, each member has to match a single simulation with its own bathymetry bitwise.
+   */
+  compareWithSingle(1);
+}
+
+TEST_CASE("Test the ensemble with lanes against single simulations.", "[EnsembleLanes]")
+{
+  /*
+   * Test case:
+   *
+   *   Same humps as above in batches of two lanes, i.e. one full and one partial batch running concurrently.
+   *   The lanes take different time steps and finish at different steps, each has to match a single simulation bitwise.
+   */
+  compareWithSingle(2);
+}
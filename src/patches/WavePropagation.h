@@ -7,6 +7,7 @@
 #ifndef TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION
 #define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION
 
+#include <future>
 #include <string>
 
 #include "../constants.h"
@@ -29,10 +30,27 @@ public:
 
   /**
    * Performs a time step.
+   * Scaling, time step and simulated time are carried in double, the patches convert the scaling to their precision.
    *
    * @param i_scaling scaling of the time step.
    **/
-  virtual void timeStep(t_real i_scaling) = 0;
+  virtual void timeStep(double i_scaling) = 0;
+
+  /**
+   * Performs several time steps with the same scaling.
+   * The default implementation calls timeStep, patches on a device may enqueue all steps before synchronizing.
+   *
+   * @param i_nSteps number of time steps.
+   * @param i_scaling scaling of the time steps.
+   **/
+  virtual void timeSteps(t_idx i_nSteps,
+                         double i_scaling)
+  {
+    for (t_idx l_st = 0; l_st < i_nSteps; l_st++)
+    {
+      timeStep(i_scaling);
+    }
+  }
 
   /**
    * Sets the values of the ghost cells according to outflow boundary conditions.
@@ -46,6 +64,13 @@ public:
    **/
   virtual t_idx getStride() = 0;
 
+  /**
+   * Gets the maximum absolute wave speed of the last time step.
+   *
+   * @return maximum wave speed, 0 if unknown.
+   **/
+  virtual double getMaxWaveSpeed() = 0;
+
   /**
    * Gets cells' water heights.
    *
@@ -83,7 +108,7 @@ public:
    **/
   virtual void setHeight(t_idx i_ix,
                          t_idx i_iy,
-                         t_real i_h) = 0;
+                         double i_h) = 0;
 
   /**
    * Sets the momentum in x-direction to the given value.
@@ -94,7 +119,7 @@ public:
    **/
   virtual void setMomentumX(t_idx i_ix,
                             t_idx i_iy,
-                            t_real i_hu) = 0;
+                            double i_hu) = 0;
 
   /**
    * Sets the momentum in y-direction to the given value.
@@ -105,7 +130,7 @@ public:
    **/
   virtual void setMomentumY(t_idx i_ix,
                             t_idx i_iy,
-                            t_real i_hv) = 0;
+                            double i_hv) = 0;
 
   /**
    * @brief Set the Bathymetry
@@ -116,11 +141,90 @@ public:
    */
   virtual void setBathymetry(t_idx i_ix,
                              t_idx i_iy,
-                             t_real i_b) = 0;
+                             double i_b) = 0;
+
+  /**
+   * Sets height, momenta and bathymetry of a block of cells.
+   * The default implementation uses the setters of the single cells.
+   *
+   * @param i_ix0 id of the block's first cell in x-direction.
+   * @param i_iy0 id of the block's first cell in y-direction.
+   * @param i_nx number of cells of the block in x-direction.
+   * @param i_ny number of cells of the block in y-direction.
+   * @param i_stride stride of the input arrays in y-direction.
+   * @param i_h water heights, cell (i_ix0 + ix, i_iy0 + iy) at ix + iy * i_stride.
+   * @param i_hu momenta in x-direction.
+   * @param i_hv momenta in y-direction.
+   * @param i_b bathymetry.
+   **/
+  virtual void setCells(t_idx i_ix0,
+                        t_idx i_iy0,
+                        t_idx i_nx,
+                        t_idx i_ny,
+                        t_idx i_stride,
+                        t_real const *i_h,
+                        t_real const *i_hu,
+                        t_real const *i_hv,
+                        t_real const *i_b)
+  {
+    for (t_idx l_iy = 0; l_iy < i_ny; l_iy++)
+    {
+      for (t_idx l_ix = 0; l_ix < i_nx; l_ix++)
+      {
+        t_idx l_id = l_ix + l_iy * i_stride;
+        setHeight(i_ix0 + l_ix, i_iy0 + l_iy, i_h[l_id]);
+        setMomentumX(i_ix0 + l_ix, i_iy0 + l_iy, i_hu[l_id]);
+        setMomentumY(i_ix0 + l_ix, i_iy0 + l_iy, i_hv[l_id]);
+        setBathymetry(i_ix0 + l_ix, i_iy0 + l_iy, i_b[l_id]);
+      }
+    }
+  }
 
   virtual void setData() = 0;
 
   virtual void getData() = 0;
+
+  /**
+   * Gets the interior of heights and momenta averaged over blocks of cells, without updating the cells of the getters.
+   * The default implementation does not support it, the caller falls back to getData and downsamples on its own.
+   *
+   * @param i_div number of cells of a block in x- and y-direction.
+   * @param o_h will be set to the averaged heights, block (ix, iy) at ix + iy * (#cells in x-direction / i_div).
+   * @param o_hu will be set to the averaged momenta in x-direction.
+   * @param o_hv will be set to the averaged momenta in y-direction.
+   * @return true if the averaged data was copied, false if the patch does not support it.
+   **/
+  virtual bool getCoarseData(t_idx,
+                             t_real *,
+                             t_real *,
+                             t_real *)
+  {
+    return false;
+  }
+
+  /**
+   * Starts to get the interior of heights and momenta averaged over blocks of cells, see getCoarseData.
+   * The default implementation gets the data before returning.
+   *
+   * @param i_div number of cells of a block in x- and y-direction.
+   * @param o_h will be set to the averaged heights once the future is ready, has to stay valid until then.
+   * @param o_hu will be set to the averaged momenta in x-direction.
+   * @param o_hv will be set to the averaged momenta in y-direction.
+   * @return future which is ready once the output arrays are set, invalid if the patch does not support averaged data.
+   **/
+  virtual std::shared_future<void> getCoarseDataAsync(t_idx i_div,
+                                                      t_real *o_h,
+                                                      t_real *o_hu,
+                                                      t_real *o_hv)
+  {
+    if (!getCoarseData(i_div, o_h, o_hu, o_hv))
+    {
+      return std::shared_future<void>();
+    }
+    std::promise<void> l_done;
+    l_done.set_value();
+    return l_done.get_future().share();
+  }
 };
 
 #endif
\ No newline at end of file
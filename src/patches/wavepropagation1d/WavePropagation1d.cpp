@@ -12,9 +12,10 @@
 
 #include "../../solvers/f-wave/F_wave.h"
 
-tsunami_lab::patches::WavePropagation1d::WavePropagation1d(t_idx i_nCells,
-                                                           int state_boundary_left,
-                                                           int state_boundary_right)
+template <typename T_state, typename T_accum>
+tsunami_lab::patches::WavePropagation1d<T_state, T_accum>::WavePropagation1d(t_idx i_nCells,
+                                                                             int state_boundary_left,
+                                                                             int state_boundary_right)
 {
     m_nCells = i_nCells;
     m_state_boundary_left = state_boundary_left;
@@ -22,13 +23,18 @@ tsunami_lab::patches::WavePropagation1d::WavePropagation1d(t_idx i_nCells,
     // allocate memory including a single ghost cell on each side and initializing with 0
     for (unsigned short l_st = 0; l_st < 2; l_st++)
     {
-        m_h[l_st] = new t_real[m_nCells + 2]{0};
-        m_hu[l_st] = new t_real[m_nCells + 2]{0};
+        m_h[l_st] = new T_state[m_nCells + 2]{0};
+        m_hu[l_st] = new T_state[m_nCells + 2]{0};
+    }
+    m_b = new T_state[m_nCells + 2]{0};
+    for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+    {
+        m_netUpdates[l_nu] = new T_accum[m_nCells + 1];
     }
-    m_b = new t_real[m_nCells + 2]{0};
 }
 
-tsunami_lab::patches::WavePropagation1d::~WavePropagation1d()
+template <typename T_state, typename T_accum>
+tsunami_lab::patches::WavePropagation1d<T_state, T_accum>::~WavePropagation1d()
 {
     for (unsigned short l_st = 0; l_st < 2; l_st++)
     {
@@ -36,61 +42,57 @@ tsunami_lab::patches::WavePropagation1d::~WavePropagation1d()
         delete[] m_hu[l_st];
     }
     delete[] m_b;
+    for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+    {
+        delete[] m_netUpdates[l_nu];
+    }
 }
 
-void tsunami_lab::patches::WavePropagation1d::timeStep(t_real i_scaling)
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation1d<T_state, T_accum>::timeStep(double i_scaling)
 {
+    // the scaling is applied in the precision of the accumulation
+    T_accum l_scaling = i_scaling;
+
     setGhostOutflow();
     // pointers to old and new data
-    t_real *l_hOld = m_h[m_step];
-    t_real *l_huOld = m_hu[m_step];
+    T_state *l_hOld = m_h[m_step];
+    T_state *l_huOld = m_hu[m_step];
 
     m_step = (m_step + 1) % 2;
-    t_real *l_hNew = m_h[m_step];
-    t_real *l_huNew = m_hu[m_step];
-
-    t_real *l_b = m_b;
-
-    // init new cell quantities
+    T_state *l_hNew = m_h[m_step];
+    T_state *l_huNew = m_hu[m_step];
+
+    T_state *l_b = m_b;
+
+    // net-updates of all edges, edge l_ed lies between the cells l_ed and l_ed + 1
+    m_maxWaveSpeed = solvers::FWave<T_accum>::netUpdatesBatch(m_nCells + 1,
+                                                              l_hOld,
+                                                              l_hOld + 1,
+                                                              l_huOld,
+                                                              l_huOld + 1,
+                                                              l_b,
+                                                              l_b + 1,
+                                                              m_netUpdates[0],
+                                                              m_netUpdates[1],
+                                                              m_netUpdates[2],
+                                                              m_netUpdates[3]);
+
+    // update the cells' quantities, each cell is the right cell of edge l_ce - 1 and the left cell of edge l_ce
+#pragma omp simd
     for (t_idx l_ce = 1; l_ce < m_nCells + 1; l_ce++)
     {
-        l_hNew[l_ce] = l_hOld[l_ce];
-        l_huNew[l_ce] = l_huOld[l_ce];
-    }
-
-    // iterate over edges and update with Riemann solutions
-    for (t_idx l_ed = 0; l_ed < m_nCells + 1; l_ed++)
-    {
-        // determine left and right cell-id
-        t_idx l_ceL = l_ed;
-        t_idx l_ceR = l_ed + 1;
-
-        // compute net-updates
-        t_real l_netUpdates[2][2];
-
-        solvers::FWave::netUpdates(l_hOld[l_ceL],
-                                   l_hOld[l_ceR],
-                                   l_huOld[l_ceL],
-                                   l_huOld[l_ceR],
-                                   l_b[l_ceL],
-                                   l_b[l_ceR],
-                                   l_netUpdates[0],
-                                   l_netUpdates[1]);
-
-        // update the cells' quantities
-        l_hNew[l_ceL] -= i_scaling * l_netUpdates[0][0];
-        l_huNew[l_ceL] -= i_scaling * l_netUpdates[0][1];
-
-        l_hNew[l_ceR] -= i_scaling * l_netUpdates[1][0];
-        l_huNew[l_ceR] -= i_scaling * l_netUpdates[1][1];
+        l_hNew[l_ce] = l_hOld[l_ce] - l_scaling * m_netUpdates[2][l_ce - 1] - l_scaling * m_netUpdates[0][l_ce];
+        l_huNew[l_ce] = l_huOld[l_ce] - l_scaling * m_netUpdates[3][l_ce - 1] - l_scaling * m_netUpdates[1][l_ce];
     }
 }
 
-void tsunami_lab::patches::WavePropagation1d::setGhostOutflow()
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation1d<T_state, T_accum>::setGhostOutflow()
 {
-    t_real *l_h = m_h[m_step];
-    t_real *l_hu = m_hu[m_step];
-    t_real *l_b = m_b;
+    T_state *l_h = m_h[m_step];
+    T_state *l_hu = m_hu[m_step];
+    T_state *l_b = m_b;
 
     // set left boundary
     switch (m_state_boundary_left)
@@ -137,6 +139,22 @@ void tsunami_lab::patches::WavePropagation1d::setGhostOutflow()
     }
 }
 
-void tsunami_lab::patches::WavePropagation1d::setData(){};
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation1d<T_state, T_accum>::setData(){};
+
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation1d<T_state, T_accum>::getData()
+{
+    if constexpr (!std::is_same_v<T_state, t_real>)
+    {
+        T_state const *l_data[3] = {m_h[m_step], m_hu[m_step], m_b};
+        for (unsigned short l_view = 0; l_view < 3; l_view++)
+        {
+            m_views[l_view].assign(l_data[l_view], l_data[l_view] + m_nCells + 2);
+        }
+    }
+}
 
-void tsunami_lab::patches::WavePropagation1d::getData(){};
\ No newline at end of file
+template class tsunami_lab::patches::WavePropagation1d<float, float>;
+template class tsunami_lab::patches::WavePropagation1d<double, double>;
+template class tsunami_lab::patches::WavePropagation1d<float, double>;
@@ -8,6 +8,8 @@
 #define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_1D
 
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "../WavePropagation.h"
 
@@ -15,16 +17,27 @@ namespace tsunami_lab
 {
     namespace patches
     {
+        template <typename T_state = t_real, typename T_accum = T_state>
         class WavePropagation1d;
     }
 } // namespace tsunami_lab
 
+/**
+ * One-dimensional wave propagation patch.
+ *
+ * @tparam T_state floating point type in which the cell quantities are stored.
+ * @tparam T_accum floating point type in which the net-updates are computed and accumulated.
+ **/
+template <typename T_state, typename T_accum>
 class tsunami_lab::patches::WavePropagation1d : public WavePropagation
 {
 private:
     //! current step which indicates the active values in the arrays below
     unsigned short m_step = 0;
 
+    //! maximum absolute wave speed of the last time step
+    t_real m_maxWaveSpeed = 0;
+
     //! number of cells discretizing the computational domain
     t_idx m_nCells = 0;
 
@@ -35,13 +48,39 @@ private:
     int m_state_boundary_right = 0;
 
     //! water heights for the current and next time step for all cells
-    t_real *m_h[2] = {nullptr, nullptr};
+    T_state *m_h[2] = {nullptr, nullptr};
 
     //! momenta for the current and next time step for all cells
-    t_real *m_hu[2] = {nullptr, nullptr};
+    T_state *m_hu[2] = {nullptr, nullptr};
 
     //! bathymetry for all cells
-    t_real *m_b = nullptr;
+    T_state *m_b = nullptr;
+
+    //! net-updates of all edges: 0: left height, 1: left momentum, 2: right height, 3: right momentum
+    T_accum *m_netUpdates[4] = {nullptr, nullptr, nullptr, nullptr};
+
+    //! copies of height, momentum and bathymetry in t_real, updated by getData and used by the getters if T_state differs
+    std::vector<t_real> m_views[3];
+
+    /**
+     * Gets a t_real view of the given cells.
+     *
+     * @param i_data cells including the ghost cells.
+     * @param i_view id of the copy which is used if T_state differs from t_real.
+     * @return view of the cells including the ghost cells.
+     **/
+    t_real const *getView(T_state const *i_data,
+                          [[maybe_unused]] unsigned short i_view) const
+    {
+        if constexpr (std::is_same_v<T_state, t_real>)
+        {
+            return i_data;
+        }
+        else
+        {
+            return m_views[i_view].data();
+        }
+    }
 
 public:
     /**
@@ -63,7 +102,7 @@ public:
      *
      * @param i_scaling scaling of the time step (dt / dx).
      **/
-    void timeStep(t_real i_scaling);
+    void timeStep(double i_scaling);
 
     /**
      * Sets the values of the ghost cells according to outflow boundary conditions.
@@ -80,6 +119,16 @@ public:
         return m_nCells + 2;
     }
 
+    /**
+     * Gets the maximum absolute wave speed of the last time step.
+     *
+     * @return maximum wave speed.
+     **/
+    double getMaxWaveSpeed()
+    {
+        return m_maxWaveSpeed;
+    }
+
     /**
      * Gets cells' water heights.
      *
@@ -87,7 +136,7 @@ public:
      */
     t_real const *getHeight()
     {
-        return m_h[m_step] + 1;
+        return getView(m_h[m_step], 0) + 1;
     }
 
     /**
@@ -97,7 +146,7 @@ public:
      **/
     t_real const *getMomentumX()
     {
-        return m_hu[m_step] + 1;
+        return getView(m_hu[m_step], 1) + 1;
     }
 
     /**
@@ -115,7 +164,7 @@ public:
      **/
     t_real const *getBathymetry()
     {
-        return m_b + 1;
+        return getView(m_b, 2) + 1;
     }
 
     /**
@@ -126,7 +175,7 @@ public:
      **/
     void setHeight(t_idx i_ix,
                    t_idx,
-                   t_real i_h)
+                   double i_h)
     {
         m_h[m_step][i_ix + 1] = i_h;
     }
@@ -139,7 +188,7 @@ public:
      **/
     void setMomentumX(t_idx i_ix,
                       t_idx,
-                      t_real i_hu)
+                      double i_hu)
     {
         m_hu[m_step][i_ix + 1] = i_hu;
     }
@@ -149,7 +198,7 @@ public:
      **/
     void setMomentumY(t_idx,
                       t_idx,
-                      t_real){};
+                      double){};
 
     /**
      * @brief Set the bathymetry
@@ -159,14 +208,22 @@ public:
      */
     void setBathymetry(t_idx i_ix,
                        t_idx,
-                       t_real i_b)
+                       double i_b)
     {
         m_b[i_ix + 1] = i_b;
     }
 
     void setData();
 
+    /**
+     * Converts the cells to the copies returned by the getters if T_state differs from t_real.
+     * The copies are only updated by this call, i.e., once per output step instead of once per getter call.
+     **/
     void getData();
 };
 
+extern template class tsunami_lab::patches::WavePropagation1d<float, float>;
+extern template class tsunami_lab::patches::WavePropagation1d<double, double>;
+extern template class tsunami_lab::patches::WavePropagation1d<float, double>;
+
 #endif
\ No newline at end of file
@@ -7,19 +7,29 @@
  **/
 #include "WavePropagation2d.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 #include <string>
-#include <algorithm>
 
 #include "../../solvers/f-wave/F_wave.h"
 
-tsunami_lab::patches::WavePropagation2d::WavePropagation2d(t_idx i_nCells_x,
-                                                           t_idx i_nCells_y,
-                                                           int state_boundary_left,
-                                                           int state_boundary_right,
-                                                           int state_boundary_top,
-                                                           int state_boundary_bottom)
+template <typename T_state, typename T_accum>
+tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::WavePropagation2d(t_idx i_nCells_x,
+                                                                             t_idx i_nCells_y,
+                                                                             int state_boundary_left,
+                                                                             int state_boundary_right,
+                                                                             int state_boundary_top,
+                                                                             int state_boundary_bottom,
+                                                                             t_idx i_tileSize_x,
+                                                                             t_idx i_tileSize_y,
+                                                                             t_real i_activationTolerance,
+                                                                             unsigned short i_nClasses,
+                                                                             bool i_unsplit)
 {
     m_nCells_x = i_nCells_x;
     m_nCells_y = i_nCells_y;
@@ -27,69 +37,213 @@ tsunami_lab::patches::WavePropagation2d::WavePropagation2d(t_idx i_nCells_x,
     m_state_boundary_right = state_boundary_right;
     m_state_boundary_top = state_boundary_top;
     m_state_boundary_bottom = state_boundary_bottom;
+    if (i_tileSize_x > 0 && i_tileSize_y > 0)
+    {
+        m_tileSize_x = std::min(i_tileSize_x, m_nCells_x);
+        m_tileSize_y = std::min(i_tileSize_y, m_nCells_y);
+        m_nTiles_x = (m_nCells_x + m_tileSize_x - 1) / m_tileSize_x;
+        m_nTiles_y = (m_nCells_y + m_tileSize_y - 1) / m_tileSize_y;
+
+        // all tiles are computed in the first time step, which derives the wet tiles
+        m_tileWet.assign(m_nTiles_x * m_nTiles_y, 1);
+        m_tileSettled.assign(m_nTiles_x * m_nTiles_y, 0);
+        m_tileSkip.assign(m_nTiles_x * m_nTiles_y, 0);
+
+        // with activation, the tiles start inactive and are checked against the state of rest before the first time step
+        m_activationTolerance = i_activationTolerance;
+        m_tileActive.assign(m_nTiles_x * m_nTiles_y, m_activationTolerance < 0);
+        m_tileChecked.assign(m_nTiles_x * m_nTiles_y, m_activationTolerance < 0);
+        m_tileDeviates.assign(m_nTiles_x * m_nTiles_y, 0);
+
+        // the first time step uses the shortest sub-step in all tiles
+        m_nClasses = std::max<unsigned short>(i_nClasses, 1);
+        m_tileClass.assign(m_nTiles_x * m_nTiles_y, 0);
+        m_tileSpeed.assign(m_nTiles_x * m_nTiles_y, 0);
+        m_tileUpdate.assign(m_nTiles_x * m_nTiles_y, 0);
+        if (m_nClasses > 1)
+        {
+            for (unsigned short l_fi = 0; l_fi < 2; l_fi++)
+            {
+                m_register_x[l_fi].assign((m_nTiles_x + 1) * m_nCells_y, 0);
+                m_register_y[l_fi].assign((m_nTiles_y + 1) * m_nCells_x, 0);
+            }
+        }
+    }
 
     // allocate memory including a single ghost cell on each side and initializing with 0
     // The 2d x-y grid is being flattened into a 1d array
-    m_h = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_hu = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_hv = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_b = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_hTemp = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_huTemp = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_hvTemp = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
+    for (unsigned short l_st = 0; l_st < 2; l_st++)
+    {
+        m_h[l_st] = allocateFirstTouch<T_state>(m_nCells_y + 2, m_nCells_x + 2);
+        m_hu[l_st] = allocateFirstTouch<T_state>(m_nCells_y + 2, m_nCells_x + 2);
+        m_hv[l_st] = allocateFirstTouch<T_state>(m_nCells_y + 2, m_nCells_x + 2);
+    }
+    m_b = allocateFirstTouch<T_state>(m_nCells_y + 2, m_nCells_x + 2);
+
+    // edge buffers of the untiled time step, shared by the x- and y-sweep
+    m_unsplit = i_unsplit && m_tileSize_x == 0;
+    if (m_tileSize_x == 0 && !m_unsplit)
+    {
+        for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+        {
+            m_netUpdates[l_nu] = allocateFirstTouch<T_accum>(m_nCells_y + 1, m_nCells_x + 1);
+        }
+    }
+}
+
+template <typename T_state, typename T_accum>
+template <typename T>
+T *tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::allocateFirstTouch(t_idx i_nRows,
+                                                                               t_idx i_rowSize) const
+{
+    T *l_field = new T[i_nRows * i_rowSize];
+
+    // same static schedule as the row loops of the untiled sweeps
+    if (m_tileSize_x == 0)
+    {
+#pragma omp parallel for schedule(static)
+        for (t_idx l_row = 0; l_row < i_nRows; l_row++)
+        {
+            std::fill(l_field + l_row * i_rowSize, l_field + (l_row + 1) * i_rowSize, T(0));
+        }
+        return l_field;
+    }
+
+    // same static schedule as the tile loop of the tiled sweeps
+#pragma omp parallel for schedule(static)
+    for (t_idx l_ti = 0; l_ti < m_nTiles_x * m_nTiles_y; l_ti++)
+    {
+        t_idx l_tx = l_ti % m_nTiles_x;
+        t_idx l_ty = l_ti / m_nTiles_x;
+        t_idx l_x0 = l_tx == 0 ? 0 : 1 + l_tx * m_tileSize_x;
+        t_idx l_x1 = l_tx + 1 == m_nTiles_x ? i_rowSize : 1 + (l_tx + 1) * m_tileSize_x;
+        t_idx l_y0 = l_ty == 0 ? 0 : 1 + l_ty * m_tileSize_y;
+        t_idx l_y1 = l_ty + 1 == m_nTiles_y ? i_nRows : 1 + (l_ty + 1) * m_tileSize_y;
+        for (t_idx l_row = l_y0; l_row < l_y1; l_row++)
+        {
+            std::fill(l_field + l_row * i_rowSize + l_x0, l_field + l_row * i_rowSize + l_x1, T(0));
+        }
+    }
+
+    return l_field;
+}
+
+template <typename T_state, typename T_accum>
+tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::~WavePropagation2d()
+{
+    for (unsigned short l_st = 0; l_st < 2; l_st++)
+    {
+        delete[] m_h[l_st];
+        delete[] m_hu[l_st];
+        delete[] m_hv[l_st];
+    }
+    if (m_ownsBathymetry)
+    {
+        delete[] m_b;
+    }
+    for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+    {
+        delete[] m_netUpdates[l_nu];
+    }
 }
 
-tsunami_lab::patches::WavePropagation2d::~WavePropagation2d()
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::getAutoTileSize(t_idx i_nCells_x,
+                                                                                t_idx i_nCells_y,
+                                                                                t_idx &o_tileSize_x,
+                                                                                t_idx &o_tileSize_y)
 {
+    long l_cacheSize = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (l_cacheSize <= 0)
+    {
+        l_cacheSize = 1 << 20;
+    }
 
-    delete[] m_h;
-    delete[] m_hu;
-    delete[] m_hv;
-    delete[] m_b;
-    delete[] m_hTemp;
-    delete[] m_huTemp;
-    delete[] m_hvTemp;
+    // per cell: old and new height and momenta, bathymetry and the tile's heights after the x-sweep
+    t_idx l_nCells = (l_cacheSize / 2) / (8 * sizeof(T_state));
+
+    // keep rows long enough for the vectorized sweeps, the halo rows cost 2 / o_tileSize_y
+    o_tileSize_x = std::min<t_idx>(i_nCells_x, 512);
+    o_tileSize_y = std::clamp<t_idx>(l_nCells / o_tileSize_x, 8, std::max<t_idx>(i_nCells_y, 8));
+    o_tileSize_y = std::min(o_tileSize_y, i_nCells_y);
 }
 
-void tsunami_lab::patches::WavePropagation2d::timeStep(t_real i_scaling)
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::timeStep(double i_scaling)
 {
+    // the scaling is applied in the precision of the accumulation
+    T_accum l_scaling = i_scaling;
+
+    if (m_tileSize_x > 0)
+    {
+        timeStepTiled(l_scaling);
+        return;
+    }
+    if (m_unsplit)
+    {
+        timeStepUnsplit(l_scaling);
+        return;
+    }
+
     //
     // X-AXIS
     //
     setGhostOutflow();
-    // pointers to old and new data
 
-    std::copy(m_h, m_h + (m_nCells_x + 2) * (m_nCells_y + 2), m_hTemp);
-    std::copy(m_hu, m_hu + (m_nCells_x + 2) * (m_nCells_y + 2), m_huTemp);
+    // pointers to old and new data, the momenta in y-direction are not changed by the x-sweep
+    T_state *l_hOld = m_h[m_step_h];
+    T_state *l_huOld = m_hu[m_step_hu];
+
+    m_step_h = (m_step_h + 1) % 2;
+    m_step_hu = (m_step_hu + 1) % 2;
+    T_state *l_hNew = m_h[m_step_h];
+    T_state *l_huNew = m_hu[m_step_hu];
 
-// iterate over edges and update with Riemann solutions in x-direction
-#pragma omp parallel for schedule(guided)
-    for (t_idx l_y = 0; l_y < m_nCells_y + 1; l_y++)
+    // maximum wave speed of both sweeps
+    T_accum l_speedMax = 0;
+
+    // edges in x-direction: row y - 1 holds the edges between the cells x and x + 1 of row y
+    t_idx l_nEdges_x = m_nCells_x + 1;
+
+#pragma omp parallel
     {
-        for (t_idx l_x = 0; l_x < m_nCells_x + 1; l_x++)
+        // phase one: net-updates of all edges
+#pragma omp for schedule(static) reduction(max : l_speedMax)
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
+        {
+            t_idx l_coord = getCoordinates(0, l_y);
+            t_idx l_edge = (l_y - 1) * l_nEdges_x;
+
+            l_speedMax = std::max(l_speedMax, solvers::FWave<T_accum>::netUpdatesBatch(l_nEdges_x,
+                                                                                       l_hOld + l_coord,
+                                                                                       l_hOld + l_coord + 1,
+                                                                                       l_huOld + l_coord,
+                                                                                       l_huOld + l_coord + 1,
+                                                                                       m_b + l_coord,
+                                                                                       m_b + l_coord + 1,
+                                                                                       m_netUpdates[0] + l_edge,
+                                                                                       m_netUpdates[1] + l_edge,
+                                                                                       m_netUpdates[2] + l_edge,
+                                                                                       m_netUpdates[3] + l_edge));
+        }
+
+        // phase two: each cell gathers the right net-updates of edge x - 1 and the left net-updates of edge x
+#pragma omp for schedule(static)
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
         {
-            // determine left and right cell-id
-            t_idx l_coord_L = getCoordinates(l_x, l_y);
-            t_idx l_coord_R = getCoordinates(l_x + 1, l_y);
-
-            // compute net-updates
-            t_real l_netUpdates[2][2];
-
-            solvers::FWave::netUpdates(m_hTemp[l_coord_L],
-                                       m_hTemp[l_coord_R],
-                                       m_huTemp[l_coord_L],
-                                       m_huTemp[l_coord_R],
-                                       m_b[l_coord_L],
-                                       m_b[l_coord_R],
-                                       l_netUpdates[0],
-                                       l_netUpdates[1]);
-
-            // update the cells' quantities
-            m_h[l_coord_L] -= i_scaling * l_netUpdates[0][0];
-            m_hu[l_coord_L] -= i_scaling * l_netUpdates[0][1];
-
-            m_h[l_coord_R] -= i_scaling * l_netUpdates[1][0];
-            m_hu[l_coord_R] -= i_scaling * l_netUpdates[1][1];
+            t_idx l_coord = getCoordinates(0, l_y);
+            T_accum const *l_netUpdates[4];
+            for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+            {
+                l_netUpdates[l_nu] = m_netUpdates[l_nu] + (l_y - 1) * l_nEdges_x;
+            }
+
+#pragma omp simd
+            for (t_idx l_x = 1; l_x < m_nCells_x + 1; l_x++)
+            {
+                l_hNew[l_coord + l_x] = l_hOld[l_coord + l_x] - l_scaling * l_netUpdates[2][l_x - 1] - l_scaling * l_netUpdates[0][l_x];
+                l_huNew[l_coord + l_x] = l_huOld[l_coord + l_x] - l_scaling * l_netUpdates[3][l_x - 1] - l_scaling * l_netUpdates[1][l_x];
+            }
         }
     }
 
@@ -98,182 +252,948 @@ void tsunami_lab::patches::WavePropagation2d::timeStep(t_real i_scaling)
     //
     setGhostOutflow();
 
-    std::copy(m_h, m_h + (m_nCells_x + 2) * (m_nCells_y + 2), m_hTemp);
-    std::copy(m_hv, m_hv + (m_nCells_x + 2) * (m_nCells_y + 2), m_hvTemp);
-    // pointers to old and new data
+    // pointers to old and new data, the momenta in x-direction are not changed by the y-sweep
+    l_hOld = m_h[m_step_h];
+    T_state *l_hvOld = m_hv[m_step_hv];
+
+    m_step_h = (m_step_h + 1) % 2;
+    m_step_hv = (m_step_hv + 1) % 2;
+    l_hNew = m_h[m_step_h];
+    T_state *l_hvNew = m_hv[m_step_hv];
 
-// iterate over edges and update with Riemann solutions in y-direction
-#pragma omp parallel for schedule(guided)
-    for (t_idx l_y = 0; l_y < m_nCells_y + 1; l_y++)
+    // edges in y-direction: row y holds the edges between the cells of row y and y + 1, without the ghost columns
+    t_idx l_nEdges_y = m_nCells_x;
+
+#pragma omp parallel
     {
-        for (t_idx l_x = 0; l_x < m_nCells_x + 1; l_x++)
+        // phase one: net-updates of all edges
+#pragma omp for schedule(static) reduction(max : l_speedMax)
+        for (t_idx l_y = 0; l_y < m_nCells_y + 1; l_y++)
+        {
+            t_idx l_coord_down = getCoordinates(1, l_y);
+            t_idx l_coord_up = getCoordinates(1, l_y + 1);
+            t_idx l_edge = l_y * l_nEdges_y;
+
+            l_speedMax = std::max(l_speedMax, solvers::FWave<T_accum>::netUpdatesBatch(l_nEdges_y,
+                                                                                       l_hOld + l_coord_down,
+                                                                                       l_hOld + l_coord_up,
+                                                                                       l_hvOld + l_coord_down,
+                                                                                       l_hvOld + l_coord_up,
+                                                                                       m_b + l_coord_down,
+                                                                                       m_b + l_coord_up,
+                                                                                       m_netUpdates[0] + l_edge,
+                                                                                       m_netUpdates[1] + l_edge,
+                                                                                       m_netUpdates[2] + l_edge,
+                                                                                       m_netUpdates[3] + l_edge));
+        }
+
+        // phase two: each cell gathers the up net-updates of the edge below and the down net-updates of the edge above
+#pragma omp for schedule(static)
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
         {
-            // determine left and right cell-id
-            t_idx l_coord_down = getCoordinates(l_x, l_y);
-            t_idx l_coord_up = getCoordinates(l_x, l_y + 1);
-
-            // compute net-updates
-            t_real l_netUpdates[2][2];
-
-            solvers::FWave::netUpdates(m_hTemp[l_coord_down],
-                                       m_hTemp[l_coord_up],
-                                       m_hvTemp[l_coord_down],
-                                       m_hvTemp[l_coord_up],
-                                       m_b[l_coord_down],
-                                       m_b[l_coord_up],
-                                       l_netUpdates[0],
-                                       l_netUpdates[1]);
-
-            // update the cells' quantities
-            m_h[l_coord_down] -= i_scaling * l_netUpdates[0][0];
-            m_hv[l_coord_down] -= i_scaling * l_netUpdates[0][1];
-
-            m_h[l_coord_up] -= i_scaling * l_netUpdates[1][0];
-            m_hv[l_coord_up] -= i_scaling * l_netUpdates[1][1];
+            t_idx l_coord = getCoordinates(1, l_y);
+            T_accum const *l_netUpdatesUp[2] = {m_netUpdates[2] + (l_y - 1) * l_nEdges_y,
+                                                m_netUpdates[3] + (l_y - 1) * l_nEdges_y};
+            T_accum const *l_netUpdatesDown[2] = {m_netUpdates[0] + l_y * l_nEdges_y,
+                                                  m_netUpdates[1] + l_y * l_nEdges_y};
+
+#pragma omp simd
+            for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+            {
+                l_hNew[l_coord + l_x] = l_hOld[l_coord + l_x] - l_scaling * l_netUpdatesUp[0][l_x] - l_scaling * l_netUpdatesDown[0][l_x];
+                l_hvNew[l_coord + l_x] = l_hvOld[l_coord + l_x] - l_scaling * l_netUpdatesUp[1][l_x] - l_scaling * l_netUpdatesDown[1][l_x];
+            }
         }
     }
+
+    m_maxWaveSpeed = l_speedMax;
 }
 
-void tsunami_lab::patches::WavePropagation2d::setGhostOutflow()
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::timeStepUnsplit(T_accum i_scaling)
 {
-    t_real *l_h = m_h;
-    t_real *l_hu = m_hu;
-    t_real *l_hv = m_hv;
-    t_real *l_b = m_b;
+    setGhostOutflow();
+
+    // pointers to old and new data, all fields are updated from the old data
+    T_state *l_hOld = m_h[m_step_h];
+    T_state *l_huOld = m_hu[m_step_hu];
+    T_state *l_hvOld = m_hv[m_step_hv];
+
+    m_step_h = (m_step_h + 1) % 2;
+    m_step_hu = (m_step_hu + 1) % 2;
+    m_step_hv = (m_step_hv + 1) % 2;
+    T_state *l_hNew = m_h[m_step_h];
+    T_state *l_huNew = m_hu[m_step_hu];
+    T_state *l_hvNew = m_hv[m_step_hv];
+
+    // maximum wave speed of both directions
+    T_accum l_speedMax = 0;
 
-    // set left boundary
-    switch (m_state_boundary_left)
+#pragma omp parallel
     {
-    // open
-    case 0:
-        for (t_idx l_y = 0; l_y < m_nCells_y; l_y++)
+        // net-updates of one row of edges in x-direction: 0: left height, 1: left momentum, 2: right height, 3: right momentum
+        std::vector<T_accum> l_netUpdatesX[4];
+        // net-updates of the edges below and above a row in y-direction: 0: down height, 1: down momentum, 2: up height, 3: up momentum
+        std::vector<T_accum> l_netUpdatesBelow[4];
+        std::vector<T_accum> l_netUpdatesAbove[4];
+        for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
         {
-            t_idx l_coord_l = getCoordinates(0, l_y);
-            t_idx l_coord_r = getCoordinates(1, l_y);
-            l_h[l_coord_l] = l_h[l_coord_r];
-            l_hu[l_coord_l] = l_hu[l_coord_r];
-            l_hv[l_coord_l] = l_hv[l_coord_r];
-            l_b[l_coord_l] = l_b[l_coord_r];
+            l_netUpdatesX[l_nu].resize(m_nCells_x + 1);
+            l_netUpdatesBelow[l_nu].resize(m_nCells_x);
+            l_netUpdatesAbove[l_nu].resize(m_nCells_x);
         }
-        break;
-    // closed
-    case 1:
-        for (t_idx l_y = 0; l_y < m_nCells_y; l_y++)
+
+        // row whose edges below are the edges above of the thread's previous row, the rows of a thread are contiguous
+        t_idx l_yNext = 0;
+
+#pragma omp for schedule(static) reduction(max : l_speedMax)
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
         {
-            t_idx l_coord = getCoordinates(0, l_y);
-            l_h[l_coord] = 0;
-            l_hu[l_coord] = 0;
-            l_hv[l_coord] = 0;
-            l_b[l_coord] = 25;
+            if (l_y == l_yNext)
+            {
+                for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+                {
+                    l_netUpdatesBelow[l_nu].swap(l_netUpdatesAbove[l_nu]);
+                }
+            }
+            else
+            {
+                t_idx l_coord_down = getCoordinates(1, l_y - 1);
+                t_idx l_coord_up = getCoordinates(1, l_y);
+
+                l_speedMax = std::max(l_speedMax, solvers::FWave<T_accum>::netUpdatesBatch(m_nCells_x,
+                                                                                           l_hOld + l_coord_down,
+                                                                                           l_hOld + l_coord_up,
+                                                                                           l_hvOld + l_coord_down,
+                                                                                           l_hvOld + l_coord_up,
+                                                                                           m_b + l_coord_down,
+                                                                                           m_b + l_coord_up,
+                                                                                           l_netUpdatesBelow[0].data(),
+                                                                                           l_netUpdatesBelow[1].data(),
+                                                                                           l_netUpdatesBelow[2].data(),
+                                                                                           l_netUpdatesBelow[3].data()));
+            }
+            l_yNext = l_y + 1;
+
+            // edges in y-direction above the row
+            t_idx l_coord = getCoordinates(1, l_y);
+            t_idx l_coord_up = getCoordinates(1, l_y + 1);
+
+            l_speedMax = std::max(l_speedMax, solvers::FWave<T_accum>::netUpdatesBatch(m_nCells_x,
+                                                                                       l_hOld + l_coord,
+                                                                                       l_hOld + l_coord_up,
+                                                                                       l_hvOld + l_coord,
+                                                                                       l_hvOld + l_coord_up,
+                                                                                       m_b + l_coord,
+                                                                                       m_b + l_coord_up,
+                                                                                       l_netUpdatesAbove[0].data(),
+                                                                                       l_netUpdatesAbove[1].data(),
+                                                                                       l_netUpdatesAbove[2].data(),
+                                                                                       l_netUpdatesAbove[3].data()));
+
+            // edges in x-direction of the row, left cells start at the ghost cell
+            l_speedMax = std::max(l_speedMax, solvers::FWave<T_accum>::netUpdatesBatch(m_nCells_x + 1,
+                                                                                       l_hOld + l_coord - 1,
+                                                                                       l_hOld + l_coord,
+                                                                                       l_huOld + l_coord - 1,
+                                                                                       l_huOld + l_coord,
+                                                                                       m_b + l_coord - 1,
+                                                                                       m_b + l_coord,
+                                                                                       l_netUpdatesX[0].data(),
+                                                                                       l_netUpdatesX[1].data(),
+                                                                                       l_netUpdatesX[2].data(),
+                                                                                       l_netUpdatesX[3].data()));
+
+            // each cell is the right cell of edge x - 1, the left cell of edge x, the up cell of the edge below and the down cell of the edge above
+#pragma omp simd
+            for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+            {
+                l_hNew[l_coord + l_x] = l_hOld[l_coord + l_x] - i_scaling * l_netUpdatesX[2][l_x] - i_scaling * l_netUpdatesX[0][l_x + 1] - i_scaling * l_netUpdatesBelow[2][l_x] - i_scaling * l_netUpdatesAbove[0][l_x];
+                l_huNew[l_coord + l_x] = l_huOld[l_coord + l_x] - i_scaling * l_netUpdatesX[3][l_x] - i_scaling * l_netUpdatesX[1][l_x + 1];
+                l_hvNew[l_coord + l_x] = l_hvOld[l_coord + l_x] - i_scaling * l_netUpdatesBelow[3][l_x] - i_scaling * l_netUpdatesAbove[1][l_x];
+            }
         }
-        break;
+    }
 
-    default:
-        std::cerr << "undefined state for left boundary" << std::endl;
-        exit(EXIT_FAILURE);
-        break;
+    m_maxWaveSpeed = l_speedMax;
+}
+
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::timeStepTiled(T_accum i_scaling)
+{
+    // tiles whose cells were set are checked against the state of rest
+    if (m_activationTolerance >= 0)
+    {
+        for (t_idx l_ti = 0; l_ti < m_nTiles_x * m_nTiles_y; l_ti++)
+        {
+            if (!m_tileChecked[l_ti])
+            {
+                m_tileChecked[l_ti] = 1;
+                m_tileDeviates[l_ti] = getTileDeviation(l_ti % m_nTiles_x, l_ti / m_nTiles_x) > m_activationTolerance;
+            }
+        }
+        for (t_idx l_ti = 0; l_ti < m_nTiles_x * m_nTiles_y; l_ti++)
+        {
+            if (m_tileDeviates[l_ti])
+            {
+                activateNeighborhood(l_ti % m_nTiles_x, l_ti / m_nTiles_x);
+                m_tileDeviates[l_ti] = 0;
+            }
+        }
+    }
+
+    // skip inactive tiles and tiles which are dry together with their eight neighbors, since all of their edges are dry
+    for (t_idx l_ty = 0; l_ty < m_nTiles_y; l_ty++)
+    {
+        for (t_idx l_tx = 0; l_tx < m_nTiles_x; l_tx++)
+        {
+            unsigned char l_wet = 0;
+            for (t_idx l_ny = (l_ty > 0 ? l_ty - 1 : 0); l_ny < std::min(l_ty + 2, m_nTiles_y); l_ny++)
+            {
+                for (t_idx l_nx = (l_tx > 0 ? l_tx - 1 : 0); l_nx < std::min(l_tx + 2, m_nTiles_x); l_nx++)
+                {
+                    l_wet |= m_tileWet[l_nx + l_ny * m_nTiles_x];
+                }
+            }
+            l_wet &= m_tileActive[l_tx + l_ty * m_nTiles_x];
+            m_tileSkip[l_tx + l_ty * m_nTiles_x] = !l_wet;
+        }
+    }
+
+    // local time stepping: class k tiles take 2^k sub-steps at once, all classes meet at the end of the time step
+    t_idx l_nSubSteps = t_idx(1) << m_tileClassMax;
+    if (m_nClasses > 1)
+    {
+        for (unsigned short l_fi = 0; l_fi < 2; l_fi++)
+        {
+            std::fill(m_register_x[l_fi].begin(), m_register_x[l_fi].end(), 0);
+            std::fill(m_register_y[l_fi].begin(), m_register_y[l_fi].end(), 0);
+        }
+        std::fill(m_tileSpeed.begin(), m_tileSpeed.end(), 0);
+    }
+
+    // maximum wave speed of all sub-steps
+    T_accum l_speedMax = 0;
+    m_nTilesComputed = 0;
+    for (t_idx l_ss = 1; l_ss < l_nSubSteps + 1; l_ss++)
+    {
+        l_speedMax = std::max(l_speedMax, subStepTiled(i_scaling / l_nSubSteps, l_ss));
+    }
+
+    // the disturbance spreads from the active tiles at the front to their inactive neighbors
+    if (m_activationTolerance >= 0)
+    {
+#pragma omp parallel for schedule(dynamic)
+        for (t_idx l_ti = 0; l_ti < m_nTiles_x * m_nTiles_y; l_ti++)
+        {
+            t_idx l_tx = l_ti % m_nTiles_x;
+            t_idx l_ty = l_ti / m_nTiles_x;
+            if (m_tileSkip[l_ti])
+            {
+                continue;
+            }
+
+            bool l_front = false;
+            for (t_idx l_ny = (l_ty > 0 ? l_ty - 1 : 0); l_ny < std::min(l_ty + 2, m_nTiles_y); l_ny++)
+            {
+                for (t_idx l_nx = (l_tx > 0 ? l_tx - 1 : 0); l_nx < std::min(l_tx + 2, m_nTiles_x); l_nx++)
+                {
+                    l_front = l_front || !m_tileActive[l_nx + l_ny * m_nTiles_x];
+                }
+            }
+            if (l_front)
+            {
+                m_tileDeviates[l_ti] = getTileDeviation(l_tx, l_ty) > m_activationTolerance;
+            }
+        }
+
+        // newly activated tiles contribute to the time step of the next step
+        for (t_idx l_ti = 0; l_ti < m_nTiles_x * m_nTiles_y; l_ti++)
+        {
+            if (m_tileDeviates[l_ti])
+            {
+                l_speedMax = std::max(l_speedMax, activateNeighborhood(l_ti % m_nTiles_x, l_ti / m_nTiles_x));
+                m_tileDeviates[l_ti] = 0;
+            }
+        }
+    }
+
+    // the next time step is derived from the slowest class
+    if (m_nClasses > 1)
+    {
+        setTileClasses(l_speedMax);
+        m_maxWaveSpeed = l_speedMax / (t_idx(1) << m_tileClassMax);
+    }
+    else
+    {
+        m_maxWaveSpeed = l_speedMax;
     }
+}
 
-    // set right boundary
-    switch (m_state_boundary_right)
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::setTileClasses(T_accum i_speedMax)
+{
+    // class k allows a time step of 2^k times the one of the fastest tile, waves of the neighbors enter the tile like the activation halo
+    for (t_idx l_ty = 0; l_ty < m_nTiles_y; l_ty++)
+    {
+        for (t_idx l_tx = 0; l_tx < m_nTiles_x; l_tx++)
+        {
+            T_accum l_speed = 0;
+            for (t_idx l_ny = (l_ty > 0 ? l_ty - 1 : 0); l_ny < std::min(l_ty + 2, m_nTiles_y); l_ny++)
+            {
+                for (t_idx l_nx = (l_tx > 0 ? l_tx - 1 : 0); l_nx < std::min(l_tx + 2, m_nTiles_x); l_nx++)
+                {
+                    l_speed = std::max(l_speed, m_tileSpeed[l_nx + l_ny * m_nTiles_x]);
+                }
+            }
+
+            unsigned char l_class = 0;
+            while (l_class + 1 < m_nClasses && l_speed * (t_idx(2) << l_class) <= i_speedMax)
+            {
+                l_class++;
+            }
+            m_tileClass[l_tx + l_ty * m_nTiles_x] = l_class;
+        }
+    }
+
+    // neighboring classes differ by at most one, such that waves entering a tile are resolved by the time step
+    for (unsigned short l_pass = 0; l_pass < m_nClasses; l_pass++)
+    {
+        for (t_idx l_ty = 0; l_ty < m_nTiles_y; l_ty++)
+        {
+            for (t_idx l_tx = 0; l_tx < m_nTiles_x; l_tx++)
+            {
+                unsigned char &l_class = m_tileClass[l_tx + l_ty * m_nTiles_x];
+                for (t_idx l_ny = (l_ty > 0 ? l_ty - 1 : 0); l_ny < std::min(l_ty + 2, m_nTiles_y); l_ny++)
+                {
+                    for (t_idx l_nx = (l_tx > 0 ? l_tx - 1 : 0); l_nx < std::min(l_tx + 2, m_nTiles_x); l_nx++)
+                    {
+                        l_class = std::min<unsigned char>(l_class, m_tileClass[l_nx + l_ny * m_nTiles_x] + 1);
+                    }
+                }
+            }
+        }
+    }
+
+    m_tileClassMax = *std::max_element(m_tileClass.begin(), m_tileClass.end());
+}
+
+template <typename T_state, typename T_accum>
+T_accum tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::subStepTiled(T_accum i_scaling,
+                                                                                t_idx i_subStep)
+{
+    // tiles of class k are updated in every 2^k-th sub-step
+    t_idx l_nUpdates = 0;
+    for (t_idx l_ti = 0; l_ti < m_nTiles_x * m_nTiles_y; l_ti++)
+    {
+        m_tileUpdate[l_ti] = !m_tileSkip[l_ti] && i_subStep % (t_idx(1) << m_tileClass[l_ti]) == 0;
+        l_nUpdates += m_tileUpdate[l_ti];
+    }
+    m_nTilesComputed += l_nUpdates;
+
+    // ghost cells next to a tile are read if the tile or one of its neighbors is updated
+    for (t_idx l_ty = 0; l_ty < m_nTiles_y; l_ty++)
+    {
+        for (t_idx l_tx = 0; l_tx < m_nTiles_x; l_tx++)
+        {
+            if (l_tx > 0 && l_tx < m_nTiles_x - 1 && l_ty > 0 && l_ty < m_nTiles_y - 1)
+            {
+                continue;
+            }
+
+            bool l_read = false;
+            for (t_idx l_ny = (l_ty > 0 ? l_ty - 1 : 0); l_ny < std::min(l_ty + 2, m_nTiles_y); l_ny++)
+            {
+                for (t_idx l_nx = (l_tx > 0 ? l_tx - 1 : 0); l_nx < std::min(l_tx + 2, m_nTiles_x); l_nx++)
+                {
+                    l_read = l_read || m_tileUpdate[l_nx + l_ny * m_nTiles_x];
+                }
+            }
+            if (!l_read)
+            {
+                continue;
+            }
+
+            t_idx l_x0 = 1 + l_tx * m_tileSize_x;
+            t_idx l_y0 = 1 + l_ty * m_tileSize_y;
+            t_idx l_x1 = std::min(l_x0 + m_tileSize_x, m_nCells_x + 1);
+            t_idx l_y1 = std::min(l_y0 + m_tileSize_y, m_nCells_y + 1);
+
+            if (l_tx == 0)
+            {
+                setGhostColumn(0, 1, m_state_boundary_left, "left", l_y0, l_y1);
+            }
+            if (l_tx == m_nTiles_x - 1)
+            {
+                setGhostColumn(m_nCells_x + 1, m_nCells_x, m_state_boundary_right, "right", l_y0, l_y1);
+            }
+            if (l_ty == 0)
+            {
+                setGhostRow(0, 1, m_state_boundary_top, "top", l_x0, l_x1);
+            }
+            if (l_ty == m_nTiles_y - 1)
+            {
+                setGhostRow(m_nCells_y + 1, m_nCells_y, m_state_boundary_bottom, "bottom", l_x0, l_x1);
+            }
+        }
+    }
+
+    // pointers to old and new data, every tile reads the old data of its halo and writes only its own cells
+    T_state *l_hOld = m_h[m_step_h];
+    T_state *l_huOld = m_hu[m_step_hu];
+    T_state *l_hvOld = m_hv[m_step_hv];
+
+    m_step_h = (m_step_h + 1) % 2;
+    m_step_hu = (m_step_hu + 1) % 2;
+    m_step_hv = (m_step_hv + 1) % 2;
+    T_state *l_hNew = m_h[m_step_h];
+    T_state *l_huNew = m_hu[m_step_hu];
+    T_state *l_hvNew = m_hv[m_step_hv];
+
+    // maximum wave speed of both sweeps
+    T_accum l_speedMax = 0;
+
+#pragma omp parallel
+    {
+        // heights of the tile's rows and the halo rows below and above after the x-sweep
+        std::vector<T_state> l_hTile((m_tileSize_y + 2) * m_tileSize_x);
+
+        // net-updates of one row of edges in x-direction: 0: left height, 1: left momentum, 2: right height, 3: right momentum
+        std::vector<T_accum> l_netUpdates[4];
+        // net-updates of the edges below and above a row in y-direction: 0: down height, 1: down momentum, 2: up height, 3: up momentum
+        std::vector<T_accum> l_netUpdatesBelow[4];
+        std::vector<T_accum> l_netUpdatesAbove[4];
+        for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+        {
+            l_netUpdates[l_nu].resize(m_tileSize_x + 1);
+            l_netUpdatesBelow[l_nu].resize(m_tileSize_x);
+            l_netUpdatesAbove[l_nu].resize(m_tileSize_x);
+        }
+
+        // finer classes first, since their net-updates are accumulated in the registers of the coarser neighbors
+        for (unsigned char l_class = 0; l_class < m_nClasses; l_class++)
+        {
+            // static like the first touch, such that each thread computes the tiles whose pages it placed
+#pragma omp for schedule(static) reduction(max : l_speedMax)
+            for (t_idx l_ti = 0; l_ti < m_nTiles_x * m_nTiles_y; l_ti++)
+            {
+                if (m_tileClass[l_ti] != l_class)
+                {
+                    continue;
+                }
+
+                // first cell and number of cells of the tile
+                t_idx l_x0 = 1 + (l_ti % m_nTiles_x) * m_tileSize_x;
+                t_idx l_y0 = 1 + (l_ti / m_nTiles_x) * m_tileSize_y;
+                t_idx l_nx = std::min(m_tileSize_x, m_nCells_x + 1 - l_x0);
+                t_idx l_ny = std::min(m_tileSize_y, m_nCells_y + 1 - l_y0);
+
+                // tiles which are not updated keep their values, which have to be copied to the new buffers once
+                if (!m_tileUpdate[l_ti])
+                {
+                    if (!m_tileSettled[l_ti])
+                    {
+                        for (t_idx l_y = l_y0; l_y < l_y0 + l_ny; l_y++)
+                        {
+                            t_idx l_coord = getCoordinates(l_x0, l_y);
+                            std::copy(l_hOld + l_coord, l_hOld + l_coord + l_nx, l_hNew + l_coord);
+                            std::copy(l_huOld + l_coord, l_huOld + l_coord + l_nx, l_huNew + l_coord);
+                            std::copy(l_hvOld + l_coord, l_hvOld + l_coord + l_nx, l_hvNew + l_coord);
+                        }
+                        m_tileSettled[l_ti] = 1;
+                    }
+                    continue;
+                }
+                m_tileSettled[l_ti] = 0;
+
+                // scaling of the tile's class, classes of the neighbors at the sides or the tile's class at the domain boundary
+                T_accum l_scaling = i_scaling * (t_idx(1) << l_class);
+                t_idx l_tileX = l_ti % m_nTiles_x;
+                t_idx l_tileY = l_ti / m_nTiles_x;
+                unsigned char l_classLeft = l_tileX > 0 ? m_tileClass[l_ti - 1] : l_class;
+                unsigned char l_classRight = l_tileX + 1 < m_nTiles_x ? m_tileClass[l_ti + 1] : l_class;
+                unsigned char l_classDown = l_tileY > 0 ? m_tileClass[l_ti - m_nTiles_x] : l_class;
+                unsigned char l_classUp = l_tileY + 1 < m_nTiles_y ? m_tileClass[l_ti + m_nTiles_x] : l_class;
+
+                // maximum wave speed of the tile
+                T_accum l_tileSpeed = 0;
+
+                // wet cells of the tile after the time step
+                int l_wet = 0;
+
+                //
+                // X-AXIS
+                //
+                for (t_idx l_ty = 0; l_ty < l_ny + 2; l_ty++)
+                {
+                    // ghost rows are set after the sweep
+                    t_idx l_y = l_y0 - 1 + l_ty;
+                    if (l_y == 0 || l_y == m_nCells_y + 1)
+                    {
+                        continue;
+                    }
+
+                    // left cells of the edges start at x0 - 1, right cells at x0
+                    t_idx l_coord = getCoordinates(l_x0 - 1, l_y);
+
+                    l_tileSpeed = std::max(l_tileSpeed, solvers::FWave<T_accum>::netUpdatesBatch(l_nx + 1,
+                                                                                                 l_hOld + l_coord,
+                                                                                                 l_hOld + l_coord + 1,
+                                                                                                 l_huOld + l_coord,
+                                                                                                 l_huOld + l_coord + 1,
+                                                                                                 m_b + l_coord,
+                                                                                                 m_b + l_coord + 1,
+                                                                                                 l_netUpdates[0].data(),
+                                                                                                 l_netUpdates[1].data(),
+                                                                                                 l_netUpdates[2].data(),
+                                                                                                 l_netUpdates[3].data()));
+
+                    // edges of the tile's rows to neighbors of other classes
+                    if (l_ty > 0 && l_ty < l_ny + 1)
+                    {
+                        t_idx l_register = l_tileX * m_nCells_y + l_y - 1;
+                        coupleEdge(l_class,
+                                   l_classLeft,
+                                   l_netUpdates[2][0],
+                                   l_netUpdates[3][0],
+                                   l_netUpdates[0][0],
+                                   l_netUpdates[1][0],
+                                   m_register_x[0][l_register],
+                                   m_register_x[1][l_register]);
+                        coupleEdge(l_class,
+                                   l_classRight,
+                                   l_netUpdates[0][l_nx],
+                                   l_netUpdates[1][l_nx],
+                                   l_netUpdates[2][l_nx],
+                                   l_netUpdates[3][l_nx],
+                                   m_register_x[0][l_register + m_nCells_y],
+                                   m_register_x[1][l_register + m_nCells_y]);
+                    }
+
+                    // each cell is the right cell of edge x - 1 and the left cell of edge x
+                    T_state *l_hRow = l_hTile.data() + l_ty * m_tileSize_x;
+#pragma omp simd
+                    for (t_idx l_x = 0; l_x < l_nx; l_x++)
+                    {
+                        l_hRow[l_x] = l_hOld[l_coord + 1 + l_x] - l_scaling * l_netUpdates[2][l_x] - l_scaling * l_netUpdates[0][l_x + 1];
+                    }
+
+                    // momenta in x-direction are final after the x-sweep, halo rows belong to the neighboring tiles
+                    if (l_ty > 0 && l_ty < l_ny + 1)
+                    {
+#pragma omp simd
+                        for (t_idx l_x = 0; l_x < l_nx; l_x++)
+                        {
+                            l_huNew[l_coord + 1 + l_x] = l_huOld[l_coord + 1 + l_x] - l_scaling * l_netUpdates[3][l_x] - l_scaling * l_netUpdates[1][l_x + 1];
+                        }
+                    }
+                }
+
+                // ghost rows of the swept heights, same rules as in setGhostOutflow
+                if (l_y0 == 1)
+                {
+                    for (t_idx l_x = 0; l_x < l_nx; l_x++)
+                    {
+                        l_hTile[l_x] = m_state_boundary_top == 0 ? l_hTile[m_tileSize_x + l_x] : 0;
+                    }
+                }
+                if (l_y0 + l_ny == m_nCells_y + 1)
+                {
+                    for (t_idx l_x = 0; l_x < l_nx; l_x++)
+                    {
+                        l_hTile[(l_ny + 1) * m_tileSize_x + l_x] = m_state_boundary_bottom == 0 ? l_hTile[l_ny * m_tileSize_x + l_x] : 0;
+                    }
+                }
+
+                //
+                // Y-AXIS
+                //
+                for (t_idx l_ty = 1; l_ty < l_ny + 1; l_ty++)
+                {
+                    t_idx l_y = l_y0 - 1 + l_ty;
+
+                    // the edge row below is the previous row's edge row above, except for the tile's first row
+                    if (l_ty > 1)
+                    {
+                        for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+                        {
+                            l_netUpdatesBelow[l_nu].swap(l_netUpdatesAbove[l_nu]);
+                        }
+                    }
+                    else
+                    {
+                        t_idx l_coord_down = getCoordinates(l_x0, l_y - 1);
+                        t_idx l_coord_up = getCoordinates(l_x0, l_y);
+
+                        l_tileSpeed = std::max(l_tileSpeed, solvers::FWave<T_accum>::netUpdatesBatch(l_nx,
+                                                                                                     l_hTile.data(),
+                                                                                                     l_hTile.data() + m_tileSize_x,
+                                                                                                     l_hvOld + l_coord_down,
+                                                                                                     l_hvOld + l_coord_up,
+                                                                                                     m_b + l_coord_down,
+                                                                                                     m_b + l_coord_up,
+                                                                                                     l_netUpdatesBelow[0].data(),
+                                                                                                     l_netUpdatesBelow[1].data(),
+                                                                                                     l_netUpdatesBelow[2].data(),
+                                                                                                     l_netUpdatesBelow[3].data()));
+
+                        // the tile's first row is the up cell of the edges to the tile below
+                        for (t_idx l_x = 0; l_x < l_nx; l_x++)
+                        {
+                            t_idx l_register = l_tileY * m_nCells_x + l_x0 - 1 + l_x;
+                            coupleEdge(l_class,
+                                       l_classDown,
+                                       l_netUpdatesBelow[2][l_x],
+                                       l_netUpdatesBelow[3][l_x],
+                                       l_netUpdatesBelow[0][l_x],
+                                       l_netUpdatesBelow[1][l_x],
+                                       m_register_y[0][l_register],
+                                       m_register_y[1][l_register]);
+                        }
+                    }
+
+                    // determine down and up row of the edge row above
+                    t_idx l_coord_down = getCoordinates(l_x0, l_y);
+                    t_idx l_coord_up = getCoordinates(l_x0, l_y + 1);
+                    T_state *l_hRow = l_hTile.data() + l_ty * m_tileSize_x;
+
+                    l_tileSpeed = std::max(l_tileSpeed, solvers::FWave<T_accum>::netUpdatesBatch(l_nx,
+                                                                                                 l_hRow,
+                                                                                                 l_hRow + m_tileSize_x,
+                                                                                                 l_hvOld + l_coord_down,
+                                                                                                 l_hvOld + l_coord_up,
+                                                                                                 m_b + l_coord_down,
+                                                                                                 m_b + l_coord_up,
+                                                                                                 l_netUpdatesAbove[0].data(),
+                                                                                                 l_netUpdatesAbove[1].data(),
+                                                                                                 l_netUpdatesAbove[2].data(),
+                                                                                                 l_netUpdatesAbove[3].data()));
+
+                    // the tile's last row is the down cell of the edges to the tile above
+                    if (l_ty == l_ny)
+                    {
+                        for (t_idx l_x = 0; l_x < l_nx; l_x++)
+                        {
+                            t_idx l_register = (l_tileY + 1) * m_nCells_x + l_x0 - 1 + l_x;
+                            coupleEdge(l_class,
+                                       l_classUp,
+                                       l_netUpdatesAbove[0][l_x],
+                                       l_netUpdatesAbove[1][l_x],
+                                       l_netUpdatesAbove[2][l_x],
+                                       l_netUpdatesAbove[3][l_x],
+                                       m_register_y[0][l_register],
+                                       m_register_y[1][l_register]);
+                        }
+                    }
+
+                    // each cell is the up cell of the edge below and the down cell of the edge above
+#pragma omp simd reduction(| : l_wet)
+                    for (t_idx l_x = 0; l_x < l_nx; l_x++)
+                    {
+                        l_hNew[l_coord_down + l_x] = l_hRow[l_x] - l_scaling * l_netUpdatesBelow[2][l_x] - l_scaling * l_netUpdatesAbove[0][l_x];
+                        l_hvNew[l_coord_down + l_x] = l_hvOld[l_coord_down + l_x] - l_scaling * l_netUpdatesBelow[3][l_x] - l_scaling * l_netUpdatesAbove[1][l_x];
+                        l_wet |= l_hNew[l_coord_down + l_x] > 0;
+                    }
+                }
+                m_tileWet[l_ti] = l_wet;
+                m_tileSpeed[l_ti] = std::max(m_tileSpeed[l_ti], l_tileSpeed);
+                l_speedMax = std::max(l_speedMax, l_tileSpeed);
+            }
+        }
+    }
+
+    return l_speedMax;
+}
+
+template <typename T_state, typename T_accum>
+T_accum tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::getTileDeviation(t_idx i_tx,
+                                                                                    t_idx i_ty)
+{
+    T_state const *l_h = m_h[m_step_h];
+    T_state const *l_hu = m_hu[m_step_hu];
+    T_state const *l_hv = m_hv[m_step_hv];
+
+    // cells of the tile and the adjacent cells of the neighboring tiles, without the ghost cells
+    t_idx l_x0 = std::max<t_idx>(i_tx * m_tileSize_x, 1);
+    t_idx l_y0 = std::max<t_idx>(i_ty * m_tileSize_y, 1);
+    t_idx l_x1 = std::min((i_tx + 1) * m_tileSize_x + 2, m_nCells_x + 1);
+    t_idx l_y1 = std::min((i_ty + 1) * m_tileSize_y + 2, m_nCells_y + 1);
+
+    T_accum l_momentumMax = 0;
+    T_accum l_surfaceMin = std::numeric_limits<T_accum>::max();
+    T_accum l_surfaceMax = std::numeric_limits<T_accum>::lowest();
+    for (t_idx l_y = l_y0; l_y < l_y1; l_y++)
+    {
+        for (t_idx l_x = l_x0; l_x < l_x1; l_x++)
+        {
+            t_idx l_coord = getCoordinates(l_x, l_y);
+            l_momentumMax = std::max({l_momentumMax, std::abs(T_accum(l_hu[l_coord])), std::abs(T_accum(l_hv[l_coord]))});
+            if (l_h[l_coord] > 0)
+            {
+                T_accum l_surface = T_accum(l_h[l_coord]) + T_accum(m_b[l_coord]);
+                l_surfaceMin = std::min(l_surfaceMin, l_surface);
+                l_surfaceMax = std::max(l_surfaceMax, l_surface);
+            }
+        }
+    }
+
+    return std::max(l_momentumMax, l_surfaceMax - l_surfaceMin);
+}
+
+template <typename T_state, typename T_accum>
+T_accum tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::getTileWaveSpeed(t_idx i_tx,
+                                                                                    t_idx i_ty)
+{
+    T_state const *l_h = m_h[m_step_h];
+    T_state const *l_hu = m_hu[m_step_hu];
+    T_state const *l_hv = m_hv[m_step_hv];
+
+    t_idx l_x0 = 1 + i_tx * m_tileSize_x;
+    t_idx l_y0 = 1 + i_ty * m_tileSize_y;
+    t_idx l_x1 = std::min(l_x0 + m_tileSize_x, m_nCells_x + 1);
+    t_idx l_y1 = std::min(l_y0 + m_tileSize_y, m_nCells_y + 1);
+
+    T_accum l_speedMax = 0;
+    for (t_idx l_y = l_y0; l_y < l_y1; l_y++)
+    {
+        for (t_idx l_x = l_x0; l_x < l_x1; l_x++)
+        {
+            t_idx l_coord = getCoordinates(l_x, l_y);
+            if (l_h[l_coord] > 0)
+            {
+                T_accum l_velocity = std::max(std::abs(T_accum(l_hu[l_coord])), std::abs(T_accum(l_hv[l_coord]))) / l_h[l_coord];
+                l_speedMax = std::max(l_speedMax, l_velocity + std::sqrt(solvers::FWave<T_accum>::m_g * l_h[l_coord]));
+            }
+        }
+    }
+
+    return l_speedMax;
+}
+
+template <typename T_state, typename T_accum>
+T_accum tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::activateNeighborhood(t_idx i_tx,
+                                                                                        t_idx i_ty)
+{
+    T_accum l_speedMax = 0;
+    for (t_idx l_ny = (i_ty > 0 ? i_ty - 1 : 0); l_ny < std::min(i_ty + 2, m_nTiles_y); l_ny++)
+    {
+        for (t_idx l_nx = (i_tx > 0 ? i_tx - 1 : 0); l_nx < std::min(i_tx + 2, m_nTiles_x); l_nx++)
+        {
+            if (!m_tileActive[l_nx + l_ny * m_nTiles_x])
+            {
+                m_tileActive[l_nx + l_ny * m_nTiles_x] = 1;
+                m_tileSpeed[l_nx + l_ny * m_nTiles_x] = getTileWaveSpeed(l_nx, l_ny);
+                l_speedMax = std::max(l_speedMax, m_tileSpeed[l_nx + l_ny * m_nTiles_x]);
+            }
+        }
+    }
+
+    return l_speedMax;
+}
+
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::setGhostColumn(t_idx i_x_ghost,
+                                                                              t_idx i_x_inner,
+                                                                              int i_state,
+                                                                              std::string const &i_side,
+                                                                              t_idx i_y_start,
+                                                                              t_idx i_y_end)
+{
+    T_state *l_h = m_h[m_step_h];
+    T_state *l_hu = m_hu[m_step_hu];
+    T_state *l_hv = m_hv[m_step_hv];
+    T_state *l_b = m_b;
+
+    switch (i_state)
     {
     // open
     case 0:
-        for (t_idx l_y = 0; l_y < m_nCells_y; l_y++)
+        for (t_idx l_y = i_y_start; l_y < i_y_end; l_y++)
         {
-            t_idx l_coord_l = getCoordinates(m_nCells_x, l_y);
-            t_idx l_coord_r = getCoordinates(m_nCells_x + 1, l_y);
-            l_h[l_coord_r] = l_h[l_coord_l];
-            l_hu[l_coord_r] = l_hu[l_coord_l];
-            l_hv[l_coord_r] = l_hv[l_coord_l];
-            l_b[l_coord_r] = l_b[l_coord_l];
+            t_idx l_coord_ghost = getCoordinates(i_x_ghost, l_y);
+            t_idx l_coord_inner = getCoordinates(i_x_inner, l_y);
+            l_h[l_coord_ghost] = l_h[l_coord_inner];
+            l_hu[l_coord_ghost] = l_hu[l_coord_inner];
+            l_hv[l_coord_ghost] = l_hv[l_coord_inner];
+            if (!m_bathymetryFixed)
+            {
+                l_b[l_coord_ghost] = l_b[l_coord_inner];
+            }
         }
         break;
     // closed
     case 1:
-        for (t_idx l_y = 0; l_y < m_nCells_y; l_y++)
+        for (t_idx l_y = i_y_start; l_y < i_y_end; l_y++)
         {
-            t_idx l_coord = getCoordinates(m_nCells_x + 1, l_y);
+            t_idx l_coord = getCoordinates(i_x_ghost, l_y);
             l_h[l_coord] = 0;
             l_hu[l_coord] = 0;
             l_hv[l_coord] = 0;
-            l_b[l_coord] = 25;
+            if (!m_bathymetryFixed)
+            {
+                l_b[l_coord] = 25;
+            }
         }
         break;
 
     default:
-        std::cerr << "undefined state for right boundary" << std::endl;
+        std::cerr << "undefined state for " << i_side << " boundary" << std::endl;
         exit(EXIT_FAILURE);
         break;
     }
+}
+
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::setGhostRow(t_idx i_y_ghost,
+                                                                           t_idx i_y_inner,
+                                                                           int i_state,
+                                                                           std::string const &i_side,
+                                                                           t_idx i_x_start,
+                                                                           t_idx i_x_end)
+{
+    T_state *l_h = m_h[m_step_h];
+    T_state *l_hu = m_hu[m_step_hu];
+    T_state *l_hv = m_hv[m_step_hv];
+    T_state *l_b = m_b;
 
-    // set top boundary
-    switch (m_state_boundary_top)
+    switch (i_state)
     {
     // open
     case 0:
-        for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+        for (t_idx l_x = i_x_start; l_x < i_x_end; l_x++)
         {
-            t_idx l_coord_l = getCoordinates(l_x, 0);
-            t_idx l_coord_r = getCoordinates(l_x, 1);
-            l_h[l_coord_l] = l_h[l_coord_r];
-            l_hu[l_coord_l] = l_hu[l_coord_r];
-            l_hv[l_coord_l] = l_hv[l_coord_r];
-            l_b[l_coord_l] = l_b[l_coord_r];
+            t_idx l_coord_ghost = getCoordinates(l_x, i_y_ghost);
+            t_idx l_coord_inner = getCoordinates(l_x, i_y_inner);
+            l_h[l_coord_ghost] = l_h[l_coord_inner];
+            l_hu[l_coord_ghost] = l_hu[l_coord_inner];
+            l_hv[l_coord_ghost] = l_hv[l_coord_inner];
+            if (!m_bathymetryFixed)
+            {
+                l_b[l_coord_ghost] = l_b[l_coord_inner];
+            }
         }
         break;
     // closed
     case 1:
-        for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+        for (t_idx l_x = i_x_start; l_x < i_x_end; l_x++)
         {
-            t_idx l_coord = getCoordinates(l_x, 0);
+            t_idx l_coord = getCoordinates(l_x, i_y_ghost);
             l_h[l_coord] = 0;
             l_hu[l_coord] = 0;
             l_hv[l_coord] = 0;
-            l_b[l_coord] = 25;
+            if (!m_bathymetryFixed)
+            {
+                l_b[l_coord] = 25;
+            }
         }
         break;
 
     default:
-        std::cerr << "undefined state for top boundary" << std::endl;
+        std::cerr << "undefined state for " << i_side << " boundary" << std::endl;
         exit(EXIT_FAILURE);
         break;
     }
+}
+
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::setGhostOutflow()
+{
+    // the columns include the corners, which are then overwritten by the rows
+    setGhostColumn(0, 1, m_state_boundary_left, "left", 0, m_nCells_y + 2);
+    setGhostColumn(m_nCells_x + 1, m_nCells_x, m_state_boundary_right, "right", 0, m_nCells_y + 2);
+    setGhostRow(0, 1, m_state_boundary_top, "top", 0, m_nCells_x + 2);
+    setGhostRow(m_nCells_y + 1, m_nCells_y, m_state_boundary_bottom, "bottom", 0, m_nCells_x + 2);
+}
 
-    // set bottom boundary
-    switch (m_state_boundary_bottom)
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::setCells(t_idx i_ix0,
+                                                                        t_idx i_iy0,
+                                                                        t_idx i_nx,
+                                                                        t_idx i_ny,
+                                                                        t_idx i_stride,
+                                                                        t_real const *i_h,
+                                                                        t_real const *i_hu,
+                                                                        t_real const *i_hv,
+                                                                        t_real const *i_b)
+{
+#pragma omp parallel for schedule(static)
+    for (t_idx l_iy = 0; l_iy < i_ny; l_iy++)
     {
-    // open
-    case 0:
-        for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+        t_idx l_coord = getCoordinates(i_ix0 + 1, i_iy0 + l_iy + 1);
+        t_idx l_id = l_iy * i_stride;
+        std::copy(i_h + l_id, i_h + l_id + i_nx, m_h[m_step_h] + l_coord);
+        std::copy(i_hu + l_id, i_hu + l_id + i_nx, m_hu[m_step_hu] + l_coord);
+        std::copy(i_hv + l_id, i_hv + l_id + i_nx, m_hv[m_step_hv] + l_coord);
+        if (m_ownsBathymetry)
         {
-            t_idx l_coord_l = getCoordinates(l_x, m_nCells_y);
-            t_idx l_coord_r = getCoordinates(l_x, m_nCells_y + 1);
-            l_h[l_coord_r] = l_h[l_coord_l];
-            l_hu[l_coord_r] = l_hu[l_coord_l];
-            l_hv[l_coord_r] = l_hv[l_coord_l];
-            l_b[l_coord_r] = l_b[l_coord_l];
+            std::copy(i_b + l_id, i_b + l_id + i_nx, m_b + l_coord);
         }
-        break;
-    // closed
-    case 1:
-        for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+    }
+
+    // one cell per tile marks the tile as changed
+    if (m_tileSize_x > 0 && i_nx > 0 && i_ny > 0)
+    {
+        for (t_idx l_ty = i_iy0 / m_tileSize_y; l_ty <= (i_iy0 + i_ny - 1) / m_tileSize_y; l_ty++)
         {
-            t_idx l_coord = getCoordinates(l_x, m_nCells_y + 1);
-            l_h[l_coord] = 0;
-            l_hu[l_coord] = 0;
-            l_hv[l_coord] = 0;
-            l_b[l_coord] = 25;
+            for (t_idx l_tx = i_ix0 / m_tileSize_x; l_tx <= (i_ix0 + i_nx - 1) / m_tileSize_x; l_tx++)
+            {
+                touchTile(l_tx * m_tileSize_x, l_ty * m_tileSize_y);
+            }
         }
-        break;
+    }
+}
 
-    default:
-        std::cerr << "undefined state for bottom boundary" << std::endl;
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::fixBathymetry()
+{
+    // the ghost cells of the bathymetry only depend on the boundary conditions
+    m_bathymetryFixed = false;
+    setGhostOutflow();
+    m_bathymetryFixed = true;
+}
+
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::shareBathymetry(WavePropagation2d &i_owner)
+{
+    if (i_owner.m_nCells_x != m_nCells_x || i_owner.m_nCells_y != m_nCells_y ||
+        i_owner.m_state_boundary_left != m_state_boundary_left || i_owner.m_state_boundary_right != m_state_boundary_right ||
+        i_owner.m_state_boundary_top != m_state_boundary_top || i_owner.m_state_boundary_bottom != m_state_boundary_bottom)
+    {
+        std::cerr << "the bathymetry can only be shared by patches with the same cells and boundary conditions" << std::endl;
         exit(EXIT_FAILURE);
-        break;
     }
+
+    if (!i_owner.m_bathymetryFixed)
+    {
+        i_owner.fixBathymetry();
+    }
+
+    if (m_ownsBathymetry)
+    {
+        delete[] m_b;
+    }
+    m_b = i_owner.m_b;
+    m_ownsBathymetry = false;
+    m_bathymetryFixed = true;
 }
 
-void tsunami_lab::patches::WavePropagation2d::setData(){};
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::setData(){};
+
+template <typename T_state, typename T_accum>
+void tsunami_lab::patches::WavePropagation2d<T_state, T_accum>::getData()
+{
+    if constexpr (!std::is_same_v<T_state, t_real>)
+    {
+        t_idx l_nCells = (m_nCells_x + 2) * (m_nCells_y + 2);
+        T_state const *l_data[4] = {m_h[m_step_h], m_hu[m_step_hu], m_hv[m_step_hv], m_b};
+        for (unsigned short l_view = 0; l_view < 4; l_view++)
+        {
+            m_views[l_view].assign(l_data[l_view], l_data[l_view] + l_nCells);
+        }
+    }
+}
 
-void tsunami_lab::patches::WavePropagation2d::getData(){};
\ No newline at end of file
+template class tsunami_lab::patches::WavePropagation2d<float, float>;
+template class tsunami_lab::patches::WavePropagation2d<double, double>;
+template class tsunami_lab::patches::WavePropagation2d<float, double>;
@@ -9,6 +9,7 @@
 #define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D
 
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "../WavePropagation.h"
@@ -17,15 +18,28 @@ namespace tsunami_lab
 {
     namespace patches
     {
+        template <typename T_state = t_real, typename T_accum = T_state>
         class WavePropagation2d;
     }
 } // namespace tsunami_lab
 
+/**
+ * Two-dimensional wave propagation patch.
+ *
+ * @tparam T_state floating point type in which the cell quantities are stored.
+ * @tparam T_accum floating point type in which the net-updates are computed and accumulated.
+ **/
+template <typename T_state, typename T_accum>
 class tsunami_lab::patches::WavePropagation2d : public WavePropagation
 {
 private:
-    //! current step which indicates the active values in the arrays below
-    unsigned short m_step = 0;
+    //! current steps which indicate the active buffers of the height and the momenta below
+    unsigned short m_step_h = 0;
+    unsigned short m_step_hu = 0;
+    unsigned short m_step_hv = 0;
+
+    //! maximum absolute wave speed of the last time step
+    t_real m_maxWaveSpeed = 0;
 
     //! number of cells in x-direction discretizing the computational domain
     t_idx m_nCells_x = 0;
@@ -45,19 +59,107 @@ private:
     //! state of bottom boundary, 0 = open, 1 = closed
     int m_state_boundary_bottom = 0;
 
-    //! water heights for the current and next time step for all cells
-    t_real *m_h = {nullptr};
-    //! momenta for the current and next time step for all cells in x-direction
-    t_real *m_hu = {nullptr};
-    //! momenta for the current and next time step for all cells in y-direction
-    t_real *m_hv = {nullptr};
+    //! number of cells of a tile in x-direction, 0 disables the tiled time step
+    t_idx m_tileSize_x = 0;
+
+    //! number of cells of a tile in y-direction, 0 disables the tiled time step
+    t_idx m_tileSize_y = 0;
+
+    //! number of tiles in x-direction
+    t_idx m_nTiles_x = 0;
+
+    //! number of tiles in y-direction
+    t_idx m_nTiles_y = 0;
+
+    //! number of tiles computed in the last time step
+    t_idx m_nTilesComputed = 0;
+
+    //! per tile: 1 if a cell of the tile was wet after the last time step or has been set since
+    std::vector<unsigned char> m_tileWet;
+
+    //! per tile: 1 if both buffers hold the same values for all cells of the tile
+    std::vector<unsigned char> m_tileSettled;
+
+    //! per tile: 1 if the tile is skipped in the current time step
+    std::vector<unsigned char> m_tileSkip;
+
+    //! deviation from the state of rest which activates the neighboring tiles, negative if all tiles are active
+    t_real m_activationTolerance = -1;
+
+    //! per tile: 1 if the tile is active, active tiles stay active
+    std::vector<unsigned char> m_tileActive;
+
+    //! per tile: 1 if the tile has been checked against the state of rest since its cells were set
+    std::vector<unsigned char> m_tileChecked;
+
+    //! per tile: 1 if the tile deviates from the state of rest by more than the activation tolerance
+    std::vector<unsigned char> m_tileDeviates;
 
-    t_real *m_hTemp = {nullptr};
-    t_real *m_huTemp = {nullptr};
-    t_real *m_hvTemp = {nullptr};
+    //! number of time step classes of the local time stepping, 1 disables it
+    unsigned short m_nClasses = 1;
+
+    //! per tile: class k of the local time stepping, the tile takes time steps of 2^k sub-steps
+    std::vector<unsigned char> m_tileClass;
+
+    //! largest class of all tiles
+    unsigned char m_tileClassMax = 0;
+
+    //! per tile: maximum wave speed in the current time step
+    std::vector<T_accum> m_tileSpeed;
+
+    //! per tile: 1 if the tile is updated in the current sub-step
+    std::vector<unsigned char> m_tileUpdate;
+
+    //! flux registers of the edges in x-direction at the borders of the tiles, 0: height, 1: momentum in x-direction
+    std::vector<T_accum> m_register_x[2];
+
+    //! flux registers of the edges in y-direction at the borders of the tiles, 0: height, 1: momentum in y-direction
+    std::vector<T_accum> m_register_y[2];
+
+    //! water heights for the current and next sweep for all cells
+    T_state *m_h[2] = {nullptr, nullptr};
+    //! momenta for the current and next sweep for all cells in x-direction
+    T_state *m_hu[2] = {nullptr, nullptr};
+    //! momenta for the current and next sweep for all cells in y-direction
+    T_state *m_hv[2] = {nullptr, nullptr};
 
     //! bathymetry for all cells
-    t_real *m_b = nullptr;
+    T_state *m_b = nullptr;
+
+    //! true if the bathymetry belongs to this patch, false if it is shared with another patch
+    bool m_ownsBathymetry = true;
+
+    //! true if the ghost cells of the bathymetry are set once, such that the time steps only read the bathymetry
+    bool m_bathymetryFixed = false;
+
+    //! true if the untiled time step applies the net-updates of both directions in a single pass
+    bool m_unsplit = false;
+
+    //! net-updates of all edges of a sweep in the untiled time step: 0: left/down height, 1: left/down momentum, 2: right/up height, 3: right/up momentum
+    T_accum *m_netUpdates[4] = {nullptr, nullptr, nullptr, nullptr};
+
+    //! copies of height, momenta and bathymetry in t_real, updated by getData and used by the getters if T_state differs
+    std::vector<t_real> m_views[4];
+
+    /**
+     * Gets a t_real view of the given cells.
+     *
+     * @param i_data cells including the ghost cells.
+     * @param i_view id of the copy which is used if T_state differs from t_real.
+     * @return view of the cells including the ghost cells.
+     **/
+    t_real const *getView(T_state const *i_data,
+                          [[maybe_unused]] unsigned short i_view) const
+    {
+        if constexpr (std::is_same_v<T_state, t_real>)
+        {
+            return i_data;
+        }
+        else
+        {
+            return m_views[i_view].data();
+        }
+    }
 
     /**
      * @brief Get the 2d Coordinates of the 1d array (x-y grid is being made flat into one line)
@@ -73,6 +175,186 @@ private:
         return i_x + i_y * getStride();
     };
 
+    /**
+     * Marks the tile of a cell as wet and not settled, since the cell's values were changed from outside.
+     *
+     * @param i_ix id of the cell in x-direction.
+     * @param i_iy id of the cell in y-direction.
+     **/
+    void touchTile(t_idx i_ix,
+                   t_idx i_iy)
+    {
+        if (m_tileSize_x > 0)
+        {
+            t_idx l_ti = i_ix / m_tileSize_x + (i_iy / m_tileSize_y) * m_nTiles_x;
+            m_tileWet[l_ti] = 1;
+            m_tileSettled[l_ti] = 0;
+            m_tileChecked[l_ti] = 0;
+        }
+    }
+
+    /**
+     * Gets the deviation of a tile from the state of rest, i.e., zero momenta and a flat water surface.
+     * The cells next to the tile are included, such that steps of the water surface between tiles are detected.
+     *
+     * @param i_tx id of the tile in x-direction.
+     * @param i_ty id of the tile in y-direction.
+     * @return maximum of the absolute momenta and the range of the water surface of the wet cells.
+     **/
+    T_accum getTileDeviation(t_idx i_tx,
+                             t_idx i_ty);
+
+    /**
+     * Gets the maximum wave speed of a tile's cells, used when a tile is activated.
+     *
+     * @param i_tx id of the tile in x-direction.
+     * @param i_ty id of the tile in y-direction.
+     * @return maximum of |u| + sqrt(g*h) and |v| + sqrt(g*h) of the wet cells.
+     **/
+    T_accum getTileWaveSpeed(t_idx i_tx,
+                             t_idx i_ty);
+
+    /**
+     * Activates a tile and its eight neighbors.
+     *
+     * @param i_tx id of the tile in x-direction.
+     * @param i_ty id of the tile in y-direction.
+     * @return maximum wave speed of the tiles which were inactive before.
+     **/
+    T_accum activateNeighborhood(t_idx i_tx,
+                                 t_idx i_ty);
+
+    /**
+     * Sets the ghost cells of one ghost column according to the boundary's state.
+     *
+     * @param i_x_ghost x-coordinate of the ghost column.
+     * @param i_x_inner x-coordinate of the adjacent inner column.
+     * @param i_state state of the boundary, 0 = open, 1 = closed.
+     * @param i_side name of the boundary for error messages.
+     * @param i_y_start first row which is set.
+     * @param i_y_end row after the last row which is set.
+     **/
+    void setGhostColumn(t_idx i_x_ghost,
+                        t_idx i_x_inner,
+                        int i_state,
+                        std::string const &i_side,
+                        t_idx i_y_start,
+                        t_idx i_y_end);
+
+    /**
+     * Sets the ghost cells of one ghost row according to the boundary's state.
+     *
+     * @param i_y_ghost y-coordinate of the ghost row.
+     * @param i_y_inner y-coordinate of the adjacent inner row.
+     * @param i_state state of the boundary, 0 = open, 1 = closed.
+     * @param i_side name of the boundary for error messages.
+     * @param i_x_start first column which is set.
+     * @param i_x_end column after the last column which is set.
+     **/
+    void setGhostRow(t_idx i_y_ghost,
+                     t_idx i_y_inner,
+                     int i_state,
+                     std::string const &i_side,
+                     t_idx i_x_start,
+                     t_idx i_x_end);
+
+    /**
+     * Couples an edge between a tile and a neighbor of another class of the local time stepping.
+     * If the neighbor is finer, the tile's net-updates are replaced by the ones accumulated in the register, which is reset.
+     * If the neighbor is coarser, the neighbor's net-updates are accumulated in the register, weighted by the tile's sub-steps.
+     *
+     * @param i_class class of the tile.
+     * @param i_classNeighbor class of the neighbor.
+     * @param io_netUpdateH height net-update of the tile's cell.
+     * @param io_netUpdateHu momentum net-update of the tile's cell.
+     * @param i_netUpdateNeighborH height net-update of the neighbor's cell.
+     * @param i_netUpdateNeighborHu momentum net-update of the neighbor's cell.
+     * @param io_registerH register of the height net-updates.
+     * @param io_registerHu register of the momentum net-updates.
+     **/
+    static void coupleEdge(unsigned char i_class,
+                           unsigned char i_classNeighbor,
+                           T_accum &io_netUpdateH,
+                           T_accum &io_netUpdateHu,
+                           T_accum i_netUpdateNeighborH,
+                           T_accum i_netUpdateNeighborHu,
+                           T_accum &io_registerH,
+                           T_accum &io_registerHu)
+    {
+        if (i_classNeighbor < i_class)
+        {
+            // 2^-k is exact, the register holds the net-updates in units of the shortest sub-step
+            T_accum l_weight = T_accum(1) / (t_idx(1) << i_class);
+            io_netUpdateH = io_registerH * l_weight;
+            io_netUpdateHu = io_registerHu * l_weight;
+            io_registerH = 0;
+            io_registerHu = 0;
+        }
+        else if (i_classNeighbor > i_class)
+        {
+            T_accum l_weight = t_idx(1) << i_class;
+            io_registerH += l_weight * i_netUpdateNeighborH;
+            io_registerHu += l_weight * i_netUpdateNeighborHu;
+        }
+    }
+
+    /**
+     * Performs a sub-step of the tiled time step: every tile whose class divides the sub-step is updated.
+     *
+     * @param i_scaling scaling of the shortest sub-step (dt / dx).
+     * @param i_subStep id of the sub-step, starting at 1.
+     * @return maximum wave speed of the updated tiles.
+     **/
+    T_accum subStepTiled(T_accum i_scaling,
+                         t_idx i_subStep);
+
+    /**
+     * Derives the classes of the local time stepping from the tiles' wave speeds of the last time step.
+     * A tile is classified by the maximum wave speed of itself and its neighbors, since their waves enter the tile within one step.
+     *
+     * @param i_speedMax maximum wave speed of all tiles.
+     **/
+    void setTileClasses(T_accum i_speedMax);
+
+    /**
+     * Performs an unsplit time step. The net-updates of the edges in x- and y-direction are computed from the same old
+     * data and applied in a single pass over the cells, without intermediate data between the directions.
+     * Stable for CFL numbers up to 0.5.
+     *
+     * @param i_scaling scaling of the time step (dt / dx).
+     **/
+    void timeStepUnsplit(T_accum i_scaling);
+
+    /**
+     * Performs a time step tile by tile. Each tile runs the x-sweep on its rows and one halo row on each side,
+     * followed by the y-sweep, while the tile's data is still in cache.
+     * Tiles which are dry together with their eight neighbors are skipped, since all of their edges are dry.
+     * The result is identical to the one of the untiled time step.
+     * If the activation is enabled, inactive tiles are skipped as well. A tile which deviates from the state of rest
+     * by more than the tolerance activates itself and its neighbors after the time step.
+     * With local time stepping, a tile of class k is updated in every 2^k-th sub-step with a 2^k times larger step.
+     * Net-updates at the borders to coarser tiles are accumulated in flux registers, which the coarser tile applies
+     * instead of its own net-updates, such that the scheme is conservative. The time step is split into
+     * 2^(largest class) sub-steps.
+     *
+     * @param i_scaling scaling of the time step (dt / dx).
+     **/
+    void timeStepTiled(T_accum i_scaling);
+
+    /**
+     * Allocates a field and initializes it with 0 in parallel. The rows of the untiled and the tiles of the tiled
+     * time step are distributed over the threads like in the sweeps, such that each page is first touched and thus
+     * placed in the NUMA domain of the thread which computes its cells. Ghost cells belong to the adjacent rows or tiles.
+     *
+     * @tparam T type of the values.
+     * @param i_nRows number of rows, m_nCells_y + 2 if tiled.
+     * @param i_rowSize number of values per row, m_nCells_x + 2 if tiled.
+     * @return allocated field, freed with delete[].
+     **/
+    template <typename T>
+    T *allocateFirstTouch(t_idx i_nRows,
+                          t_idx i_rowSize) const;
+
 public:
     /**
      *
@@ -84,13 +366,36 @@ public:
      * @param state_boundary_right type int, defines the state of the right boundary. Possible values: 0 = "open" and 1 = "closed".
      * @param state_boundary_top type int, defines the state of the top boundary. Possible values: 0 = "open" and 1 = "closed".
      * @param state_boundary_bottom type int, defines the state of the bottom boundary. Possible values: 0 = "open" and 1 = "closed".
+     * @param i_tileSize_x number of cells of a tile in x-direction, 0 disables tiling.
+     * @param i_tileSize_y number of cells of a tile in y-direction, 0 disables tiling.
+     * @param i_activationTolerance deviation from the state of rest which activates tiles, negative disables the activation. Requires tiling.
+     * @param i_nClasses number of time step classes of the local time stepping, 1 disables it. Requires tiling.
+     * @param i_unsplit true to use the unsplit time step instead of the dimensional splitting. Ignored with tiling.
      **/
     WavePropagation2d(t_idx i_nCells_x,
                       t_idx i_nCells_y,
                       int state_boundary_left,
                       int state_boundary_right,
                       int state_boundary_top,
-                      int state_boundary_bottom);
+                      int state_boundary_bottom,
+                      t_idx i_tileSize_x = 0,
+                      t_idx i_tileSize_y = 0,
+                      t_real i_activationTolerance = -1,
+                      unsigned short i_nClasses = 1,
+                      bool i_unsplit = false);
+
+    /**
+     * Derives a tile size from the size of the L2 cache, such that the working set of a tile fits into half of it.
+     *
+     * @param i_nCells_x number of cells in x-direction.
+     * @param i_nCells_y number of cells in y-direction.
+     * @param o_tileSize_x will be set to the number of cells of a tile in x-direction.
+     * @param o_tileSize_y will be set to the number of cells of a tile in y-direction.
+     **/
+    static void getAutoTileSize(t_idx i_nCells_x,
+                                t_idx i_nCells_y,
+                                t_idx &o_tileSize_x,
+                                t_idx &o_tileSize_y);
 
     /**
      * Destructor which frees all allocated memory.
@@ -99,10 +404,13 @@ public:
 
     /**
      * Performs a time step.
+     * Without tiling, each sweep first stores the net-updates of all edges and then applies them cell by cell.
+     * Both phases are free of races, and the result does not depend on the number of threads.
+     * The unsplit time step replaces both sweeps if selected.
      *
      * @param i_scaling scaling of the time step (dt / dx).
      **/
-    void timeStep(t_real i_scaling);
+    void timeStep(double i_scaling);
 
     /**
      * Sets the values of the ghost cells according to outflow boundary conditions.
@@ -119,6 +427,26 @@ public:
         return m_nCells_x + 2;
     }
 
+    /**
+     * Gets the maximum absolute wave speed of the last time step.
+     *
+     * @return maximum wave speed.
+     **/
+    double getMaxWaveSpeed()
+    {
+        return m_maxWaveSpeed;
+    }
+
+    /**
+     * Gets the number of tiles computed in the last time step of the tiled mode.
+     *
+     * @return number of computed tiles.
+     **/
+    t_idx getNumberOfComputedTiles()
+    {
+        return m_nTilesComputed;
+    }
+
     /**
      * Gets cells' water heights.
      *
@@ -126,7 +454,7 @@ public:
      */
     t_real const *getHeight()
     {
-        return m_h;
+        return getView(m_h[m_step_h], 0);
     }
 
     /**
@@ -136,7 +464,7 @@ public:
      **/
     t_real const *getMomentumX()
     {
-        return m_hu;
+        return getView(m_hu[m_step_hu], 1);
     }
 
     /**
@@ -146,7 +474,7 @@ public:
      **/
     t_real const *getMomentumY()
     {
-        return m_hv;
+        return getView(m_hv[m_step_hv], 2);
     }
 
     /**
@@ -156,7 +484,7 @@ public:
      **/
     t_real const *getBathymetry()
     {
-        return m_b;
+        return getView(m_b, 3);
     }
 
     /**
@@ -168,9 +496,10 @@ public:
      **/
     void setHeight(t_idx i_ix,
                    t_idx i_iy,
-                   t_real i_h)
+                   double i_h)
     {
-        m_h[getCoordinates(i_ix + 1, i_iy + 1)] = i_h;
+        m_h[m_step_h][getCoordinates(i_ix + 1, i_iy + 1)] = i_h;
+        touchTile(i_ix, i_iy);
     }
 
     /**
@@ -182,9 +511,10 @@ public:
      **/
     void setMomentumX(t_idx i_ix,
                       t_idx i_iy,
-                      t_real i_hu)
+                      double i_hu)
     {
-        m_hu[getCoordinates(i_ix + 1, i_iy + 1)] = i_hu;
+        m_hu[m_step_hu][getCoordinates(i_ix + 1, i_iy + 1)] = i_hu;
+        touchTile(i_ix, i_iy);
     }
 
     /**
@@ -196,28 +526,82 @@ public:
      **/
     void setMomentumY(t_idx i_ix,
                       t_idx i_iy,
-                      t_real i_hv)
+                      double i_hv)
     {
-        m_hv[getCoordinates(i_ix + 1, i_iy + 1)] = i_hv;
+        m_hv[m_step_hv][getCoordinates(i_ix + 1, i_iy + 1)] = i_hv;
+        touchTile(i_ix, i_iy);
     }
 
     /**
      * @brief Set the bathymetry
+     * This is a no-op if the bathymetry is shared with another patch, see shareBathymetry; the bathymetry of the
+     * owner is used instead.
      *
      * @param i_ix id of the cell in x-direction.
      * @param i_iy id of the cell in y-direction.
-     * @param i_b bathymetry
+     * @param i_b bathymetry, ignored if the bathymetry is shared with another patch.
      */
     void setBathymetry(t_idx i_ix,
                        t_idx i_iy,
-                       t_real i_b)
+                       double i_b)
     {
-        m_b[getCoordinates(i_ix + 1, i_iy + 1)] = i_b;
+        if (m_ownsBathymetry)
+        {
+            m_b[getCoordinates(i_ix + 1, i_iy + 1)] = i_b;
+        }
+        touchTile(i_ix, i_iy);
     }
 
+    /**
+     * Sets height, momenta and bathymetry of a block of cells, copying the rows in parallel.
+     *
+     * @param i_ix0 id of the block's first cell in x-direction.
+     * @param i_iy0 id of the block's first cell in y-direction.
+     * @param i_nx number of cells of the block in x-direction.
+     * @param i_ny number of cells of the block in y-direction.
+     * @param i_stride stride of the input arrays in y-direction.
+     * @param i_h water heights, cell (i_ix0 + ix, i_iy0 + iy) at ix + iy * i_stride.
+     * @param i_hu momenta in x-direction.
+     * @param i_hv momenta in y-direction.
+     * @param i_b bathymetry, ignored if the bathymetry is shared with another patch.
+     **/
+    void setCells(t_idx i_ix0,
+                  t_idx i_iy0,
+                  t_idx i_nx,
+                  t_idx i_ny,
+                  t_idx i_stride,
+                  t_real const *i_h,
+                  t_real const *i_hu,
+                  t_real const *i_hv,
+                  t_real const *i_b);
+
+    /**
+     * Sets the ghost cells of the bathymetry once, afterwards the time steps only read the bathymetry.
+     * The bathymetry has to be set before.
+     **/
+    void fixBathymetry();
+
+    /**
+     * Uses the bathymetry of another patch with the same number of cells and boundary conditions, e.g. for the
+     * members of an ensemble. The bathymetry of the other patch is fixed, such that the time steps of both
+     * patches only read it and can run concurrently. The other patch has to outlive this one.
+     * Patches may share the bathymetry concurrently if it was fixed before.
+     *
+     * @param i_owner patch which holds the bathymetry.
+     **/
+    void shareBathymetry(WavePropagation2d &i_owner);
+
     void setData();
 
+    /**
+     * Converts the cells to the copies returned by the getters if T_state differs from t_real.
+     * The copies are only updated by this call, i.e., once per output step instead of once per getter call.
+     **/
     void getData();
 };
 
+extern template class tsunami_lab::patches::WavePropagation2d<float, float>;
+extern template class tsunami_lab::patches::WavePropagation2d<double, double>;
+extern template class tsunami_lab::patches::WavePropagation2d<float, double>;
+
 #endif
\ No newline at end of file
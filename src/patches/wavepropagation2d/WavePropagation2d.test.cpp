@@ -7,9 +7,112 @@
  **/
 
 #include <catch2/catch.hpp>
+#include <chrono>
+#include <iostream>
+#include <omp.h>
+#include <vector>
 #include "WavePropagation2d.h"
 #include "../../constants.h"
 
+/**
+ * Radial dam break at rest over a linear bathymetry, coordinates are given in cells.
+ **/
+struct DamBreak
+{
+    //! number of cells in x-direction
+    tsunami_lab::t_idx nx;
+    //! number of cells in y-direction
+    tsunami_lab::t_idx ny;
+    //! x-coordinate of the center
+    double x0;
+    //! y-coordinate of the center
+    double y0;
+    //! squared radius
+    double r2;
+    //! water height inside of the dam
+    tsunami_lab::t_real hIn;
+    //! water height outside of the dam
+    tsunami_lab::t_real hOut;
+    //! bathymetry of the first cell
+    tsunami_lab::t_real b;
+    //! change of the bathymetry per cell in x-direction
+    tsunami_lab::t_real bSlopeX;
+    //! change of the bathymetry per cell in y-direction
+    tsunami_lab::t_real bSlopeY;
+};
+
+/**
+ * Sets the cells of a patch to a dam break.
+ *
+ * @param io_waveProp patch.
+ * @param i_damBreak dam break.
+ **/
+static void setDamBreak(tsunami_lab::patches::WavePropagation &io_waveProp,
+                        DamBreak const &i_damBreak)
+{
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < i_damBreak.ny; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 0; l_cx < i_damBreak.nx; l_cx++)
+        {
+            double l_dx = l_cx - i_damBreak.x0;
+            double l_dy = l_cy - i_damBreak.y0;
+            bool l_inside = l_dx * l_dx + l_dy * l_dy < i_damBreak.r2;
+            io_waveProp.setHeight(l_cx, l_cy, l_inside ? i_damBreak.hIn : i_damBreak.hOut);
+            io_waveProp.setMomentumX(l_cx, l_cy, 0);
+            io_waveProp.setMomentumY(l_cx, l_cy, 0);
+            io_waveProp.setBathymetry(l_cx, l_cy, i_damBreak.b + i_damBreak.bSlopeX * l_cx + i_damBreak.bSlopeY * l_cy);
+        }
+    }
+}
+
+/**
+ * Sets the cells of a patch to a dam break and runs time steps with a scaling of 0.05.
+ *
+ * @param io_waveProp patch.
+ * @param i_damBreak dam break.
+ * @param i_nSteps number of time steps.
+ **/
+static void runDamBreak(tsunami_lab::patches::WavePropagation &io_waveProp,
+                        DamBreak const &i_damBreak,
+                        int i_nSteps)
+{
+    setDamBreak(io_waveProp, i_damBreak);
+    for (int l_st = 0; l_st < i_nSteps; l_st++)
+    {
+        io_waveProp.timeStep(0.05);
+    }
+}
+
+/**
+ * Requires that the inner cells of two patches match bitwise.
+ *
+ * @param i_waveProp patch.
+ * @param i_reference reference patch with the same number of cells.
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ **/
+static void requireBitwiseEqual(tsunami_lab::patches::WavePropagation &i_waveProp,
+                                tsunami_lab::patches::WavePropagation &i_reference,
+                                tsunami_lab::t_idx i_nx,
+                                tsunami_lab::t_idx i_ny)
+{
+    tsunami_lab::t_idx l_stride = i_nx + 2;
+    REQUIRE(i_waveProp.getStride() == l_stride);
+    REQUIRE(i_reference.getStride() == l_stride);
+
+    for (tsunami_lab::t_idx l_cy = 1; l_cy < i_ny + 1; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 1; l_cx < i_nx + 1; l_cx++)
+        {
+            tsunami_lab::t_idx l_id = l_cx + l_cy * l_stride;
+            REQUIRE(i_waveProp.getHeight()[l_id] == i_reference.getHeight()[l_id]);
+            REQUIRE(i_waveProp.getMomentumX()[l_id] == i_reference.getMomentumX()[l_id]);
+            REQUIRE(i_waveProp.getMomentumY()[l_id] == i_reference.getMomentumY()[l_id]);
+            REQUIRE(i_waveProp.getBathymetry()[l_id] == i_reference.getBathymetry()[l_id]);
+        }
+    }
+}
+
 TEST_CASE("Test the 2d wave propagation fwave-solver x-direction.", "[WaveProp2dFWavedX]")
 {
     /*
@@ -33,12 +136,12 @@ TEST_CASE("Test the 2d wave propagation fwave-solver x-direction.", "[WaveProp2d
 
     int stride = 102;
 
-    tsunami_lab::patches::WavePropagation2d m_waveProp(100,
-                                                       100,
-                                                       0,
-                                                       0,
-                                                       0,
-                                                       0);
+    tsunami_lab::patches::WavePropagation2d<> m_waveProp(100,
+                                                         100,
+                                                         0,
+                                                         0,
+                                                         0,
+                                                         0);
 
     for (std::size_t l_cx = 0; l_cx < 50; l_cx++)
     {
@@ -143,12 +246,12 @@ TEST_CASE("Test the 2d wave propagation fwave-solver y-direction.", "[WaveProp2d
 
     int stride = 102;
 
-    tsunami_lab::patches::WavePropagation2d m_waveProp(100,
-                                                       100,
-                                                       0,
-                                                       0,
-                                                       0,
-                                                       0);
+    tsunami_lab::patches::WavePropagation2d<> m_waveProp(100,
+                                                         100,
+                                                         0,
+                                                         0,
+                                                         0,
+                                                         0);
 
     for (std::size_t l_cy = 0; l_cy < 50; l_cy++)
     {
@@ -253,12 +356,12 @@ TEST_CASE("Test the 2d wave propagation roe-solver x-direction.", "[WaveProp2dRo
 
     int stride = 102;
 
-    tsunami_lab::patches::WavePropagation2d m_waveProp(100,
-                                                       100,
-                                                       0,
-                                                       0,
-                                                       0,
-                                                       0);
+    tsunami_lab::patches::WavePropagation2d<> m_waveProp(100,
+                                                         100,
+                                                         0,
+                                                         0,
+                                                         0,
+                                                         0);
 
     for (std::size_t l_cx = 0; l_cx < 50; l_cx++)
     {
@@ -363,12 +466,12 @@ TEST_CASE("Test the 2d wave propagation roe-solver y-direction.", "[WaveProp2dRo
 
     int stride = 102;
 
-    tsunami_lab::patches::WavePropagation2d m_waveProp(100,
-                                                       100,
-                                                       0,
-                                                       0,
-                                                       0,
-                                                       0);
+    tsunami_lab::patches::WavePropagation2d<> m_waveProp(100,
+                                                         100,
+                                                         0,
+                                                         0,
+                                                         0,
+                                                         0);
 
     for (std::size_t l_cy = 0; l_cy < 50; l_cy++)
     {
@@ -448,4 +551,457 @@ TEST_CASE("Test the 2d wave propagation roe-solver y-direction.", "[WaveProp2dRo
             REQUIRE(m_waveProp.getBathymetry()[l_cx + l_cy * stride] == Approx(0));
         }
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Test the 2d wave propagation in double and mixed precision.", "[WaveProp2dPrecision]")
+{
+    /*
+     * Test case:
+     *
+     *   Radial dam break computed with float, double and mixed (float state, double accumulation) precision.
+     *   All three have to agree within the accuracy of float.
+     */
+    tsunami_lab::patches::WavePropagation2d<float, float> l_waveFloat(40, 30, 0, 0, 0, 0);
+    tsunami_lab::patches::WavePropagation2d<double, double> l_waveDouble(40, 30, 0, 0, 0, 0);
+    tsunami_lab::patches::WavePropagation2d<float, double> l_waveMixed(40, 30, 0, 0, 0, 0);
+
+    DamBreak l_damBreak = {40, 30, 20, 15, 25, 10, 5, -5, 0, 0};
+    tsunami_lab::patches::WavePropagation *l_waveProps[3] = {&l_waveFloat, &l_waveDouble, &l_waveMixed};
+    for (tsunami_lab::patches::WavePropagation *l_waveProp : l_waveProps)
+    {
+        runDamBreak(*l_waveProp, l_damBreak, 50);
+        l_waveProp->getData();
+    }
+
+    int stride = 42;
+    for (std::size_t l_cy = 1; l_cy < 31; l_cy++)
+    {
+        for (std::size_t l_cx = 1; l_cx < 41; l_cx++)
+        {
+            std::size_t l_id = l_cx + l_cy * stride;
+            for (tsunami_lab::patches::WavePropagation *l_waveProp : {l_waveProps[1], l_waveProps[2]})
+            {
+                REQUIRE(l_waveProp->getHeight()[l_id] == Approx(l_waveFloat.getHeight()[l_id]).margin(1E-3));
+                REQUIRE(l_waveProp->getMomentumX()[l_id] == Approx(l_waveFloat.getMomentumX()[l_id]).margin(1E-3));
+                REQUIRE(l_waveProp->getMomentumY()[l_id] == Approx(l_waveFloat.getMomentumY()[l_id]).margin(1E-3));
+                REQUIRE(l_waveProp->getBathymetry()[l_id] == Approx(-5));
+            }
+        }
+    }
+}
+
+TEST_CASE("Test the tiled 2d wave propagation against the untiled one.", "[WaveProp2dTiled]")
+{
+    /*
+     * Test case:
+     *
+     *   Radial dam break over a sloped bathymetry with open left and bottom boundaries and closed right and top boundaries.
+     *   The tiles do not divide the domain evenly, the tiled time steps have to reproduce the untiled ones bitwise.
+     */
+    tsunami_lab::patches::WavePropagation2d<> l_waveUntiled(37, 29, 0, 1, 1, 0);
+    tsunami_lab::patches::WavePropagation2d<> l_waveTiled(37, 29, 0, 1, 1, 0, 8, 5);
+
+    tsunami_lab::t_idx l_tileSize_x = 0;
+    tsunami_lab::t_idx l_tileSize_y = 0;
+    tsunami_lab::patches::WavePropagation2d<>::getAutoTileSize(37, 29, l_tileSize_x, l_tileSize_y);
+    REQUIRE(l_tileSize_x > 0);
+    REQUIRE(l_tileSize_x <= 37);
+    REQUIRE(l_tileSize_y > 0);
+    REQUIRE(l_tileSize_y <= 29);
+
+    DamBreak l_damBreak = {37, 29, 10, 20, 36, 10, 5, -5, -0.1f, 0};
+    runDamBreak(l_waveUntiled, l_damBreak, 60);
+    runDamBreak(l_waveTiled, l_damBreak, 60);
+
+    requireBitwiseEqual(l_waveTiled, l_waveUntiled, 37, 29);
+}
+
+TEST_CASE("Test the skipping of dry tiles in the tiled 2d wave propagation.", "[WaveProp2dDryTiles]")
+{
+    /*
+     * Test case:
+     *
+     *   Dam break in the left half of the domain, the right half is dry land which the wave does not reach.
+     *   Tiles of 6x5 cells: the columns of tiles 5-7 are dry together with their neighbors and are skipped.
+     *   After some time steps, water is dropped onto the land, which has to activate the tiles again.
+     *   The tiled time steps have to reproduce the untiled ones bitwise.
+     */
+    tsunami_lab::patches::WavePropagation2d<> l_waveUntiled(48, 40, 0, 1, 1, 0);
+    tsunami_lab::patches::WavePropagation2d<> l_waveTiled(48, 40, 0, 1, 1, 0, 6, 5);
+
+    tsunami_lab::patches::WavePropagation *l_waveProps[2] = {&l_waveUntiled, &l_waveTiled};
+
+    for (tsunami_lab::patches::WavePropagation *l_waveProp : l_waveProps)
+    {
+        for (std::size_t l_cy = 0; l_cy < 40; l_cy++)
+        {
+            for (std::size_t l_cx = 0; l_cx < 48; l_cx++)
+            {
+                bool l_land = l_cx >= 24;
+                l_waveProp->setHeight(l_cx, l_cy, l_land ? 0 : (l_cx < 8 ? 10 : 5));
+                l_waveProp->setMomentumX(l_cx, l_cy, 0);
+                l_waveProp->setMomentumY(l_cx, l_cy, 0);
+                l_waveProp->setBathymetry(l_cx, l_cy, l_land ? 20 : -5);
+            }
+        }
+
+        for (int l_st = 0; l_st < 30; l_st++)
+        {
+            l_waveProp->timeStep(0.05);
+        }
+    }
+    REQUIRE(l_waveTiled.getNumberOfComputedTiles() == 40);
+
+    for (tsunami_lab::patches::WavePropagation *l_waveProp : l_waveProps)
+    {
+        l_waveProp->setHeight(40, 20, 2);
+        for (int l_st = 0; l_st < 30; l_st++)
+        {
+            l_waveProp->timeStep(0.05);
+        }
+    }
+    REQUIRE(l_waveTiled.getNumberOfComputedTiles() > 40);
+
+    requireBitwiseEqual(l_waveTiled, l_waveUntiled, 48, 40);
+}
+
+TEST_CASE("Test the activation of tiles in the tiled 2d wave propagation.", "[WaveProp2dActivation]")
+{
+    /*
+     * Test case:
+     *
+     *   Radial dam break in the corner of a lake at rest with flat bathymetry, tiles of 6x6 cells.
+     *   Initially, only the tiles around the dam break are active, the others are activated by the wave.
+     *   With a tolerance of 0, the result has to match the untiled time steps bitwise.
+     */
+    tsunami_lab::patches::WavePropagation2d<> l_waveUntiled(60, 60, 1, 0, 1, 0);
+    tsunami_lab::patches::WavePropagation2d<> l_waveActive(60, 60, 1, 0, 1, 0, 6, 6, 0);
+
+    DamBreak l_damBreak = {60, 60, 3, 3, 9, 15, 10, -10, 0, 0};
+    setDamBreak(l_waveUntiled, l_damBreak);
+    setDamBreak(l_waveActive, l_damBreak);
+
+    // the dam break reaches the border of the first tile, which activates the 3x3 tiles around it
+    l_waveActive.timeStep(0.05);
+    REQUIRE(l_waveActive.getNumberOfComputedTiles() == 9);
+    l_waveUntiled.timeStep(0.05);
+
+    for (int l_st = 0; l_st < 40; l_st++)
+    {
+        l_waveUntiled.timeStep(0.05);
+        l_waveActive.timeStep(0.05);
+    }
+    REQUIRE(l_waveActive.getNumberOfComputedTiles() > 9);
+    REQUIRE(l_waveActive.getNumberOfComputedTiles() < 100);
+
+    requireBitwiseEqual(l_waveActive, l_waveUntiled, 60, 60);
+}
+
+TEST_CASE("Test the bulk cell setter of the 2d wave propagation.", "[WaveProp2dSetCells]")
+{
+    /*
+     * Test case:
+     *
+     *   Radial dam break of the activation test, once set cell by cell and once set in two bands of rows
+     *   through the bulk setter of the tiled patch. The bulk setter has to mark the touched tiles,
+     *   such that the result matches bitwise.
+     */
+    tsunami_lab::patches::WavePropagation2d<> l_waveCells(60, 60, 1, 0, 1, 0);
+    tsunami_lab::patches::WavePropagation2d<> l_waveBulk(60, 60, 1, 0, 1, 0, 6, 6, 0);
+
+    std::vector<tsunami_lab::t_real> l_h(60 * 60);
+    std::vector<tsunami_lab::t_real> l_hu(60 * 60, 0);
+    std::vector<tsunami_lab::t_real> l_hv(60 * 60, 0);
+    std::vector<tsunami_lab::t_real> l_b(60 * 60, -10);
+    for (std::size_t l_cy = 0; l_cy < 60; l_cy++)
+    {
+        for (std::size_t l_cx = 0; l_cx < 60; l_cx++)
+        {
+            bool l_inside = (l_cx - 3.0) * (l_cx - 3.0) + (l_cy - 3.0) * (l_cy - 3.0) < 9;
+            l_h[l_cx + l_cy * 60] = l_inside ? 15 : 10;
+        }
+    }
+
+    l_waveBulk.setCells(0, 0, 60, 25, 60, l_h.data(), l_hu.data(), l_hv.data(), l_b.data());
+    l_waveBulk.setCells(0, 25, 60, 35, 60, &l_h[25 * 60], &l_hu[25 * 60], &l_hv[25 * 60], &l_b[25 * 60]);
+    setDamBreak(l_waveCells, {60, 60, 3, 3, 9, 15, 10, -10, 0, 0});
+
+    for (int l_st = 0; l_st < 40; l_st++)
+    {
+        l_waveCells.timeStep(0.05);
+        l_waveBulk.timeStep(0.05);
+    }
+
+    requireBitwiseEqual(l_waveBulk, l_waveCells, 60, 60);
+}
+
+TEST_CASE("Test the local time stepping of the tiled 2d wave propagation.", "[WaveProp2dLocalTimeStepping]")
+{
+    /*
+     * Test case:
+     *
+     *   Radial dam break in a deep basin (b = -100) next to a shallow shelf (b = -1) with closed boundaries.
+     *   Tiles of 8x8 cells, the shelf tiles take up to 8 times larger time steps than the basin tiles.
+     *   Both patches are advanced with time steps derived from their maximum wave speeds until t = 2.
+     *
+     *   The local time stepping has to conserve the mass, stay close to the global time stepping
+     *   and update fewer tiles.
+     */
+    tsunami_lab::patches::WavePropagation2d<> l_waveGlobal(64, 32, 1, 1, 1, 1, 8, 8);
+    tsunami_lab::patches::WavePropagation2d<> l_waveLocal(64, 32, 1, 1, 1, 1, 8, 8, -1, 4);
+
+    tsunami_lab::patches::WavePropagation2d<> *l_waveProps[2] = {&l_waveGlobal, &l_waveLocal};
+    double l_mass[2] = {0, 0};
+    std::size_t l_nTileUpdates[2] = {0, 0};
+
+    for (int l_wp = 0; l_wp < 2; l_wp++)
+    {
+        for (std::size_t l_cy = 0; l_cy < 32; l_cy++)
+        {
+            for (std::size_t l_cx = 0; l_cx < 64; l_cx++)
+            {
+                float l_b = l_cx < 24 ? -100 : -1;
+                bool l_inside = (l_cx - 10.0) * (l_cx - 10.0) + (l_cy - 16.0) * (l_cy - 16.0) < 16;
+                l_waveProps[l_wp]->setHeight(l_cx, l_cy, -l_b + (l_inside ? 5 : 0));
+                l_waveProps[l_wp]->setMomentumX(l_cx, l_cy, 0);
+                l_waveProps[l_wp]->setMomentumY(l_cx, l_cy, 0);
+                l_waveProps[l_wp]->setBathymetry(l_cx, l_cy, l_b);
+                l_mass[l_wp] += -l_b + (l_inside ? 5 : 0);
+            }
+        }
+
+        float l_time = 0;
+        float l_speedMax = std::sqrt(9.80665f * 105);
+        while (l_time < 2)
+        {
+            float l_dt = std::min(0.5f / l_speedMax, 2 - l_time);
+            l_waveProps[l_wp]->timeStep(l_dt);
+            l_time += l_dt;
+            l_speedMax = l_waveProps[l_wp]->getMaxWaveSpeed();
+            l_nTileUpdates[l_wp] += l_waveProps[l_wp]->getNumberOfComputedTiles();
+        }
+    }
+
+    double l_massLocal = 0;
+    float l_diffMax = 0;
+    int stride = 66;
+    for (std::size_t l_cy = 1; l_cy < 33; l_cy++)
+    {
+        for (std::size_t l_cx = 1; l_cx < 65; l_cx++)
+        {
+            std::size_t l_id = l_cx + l_cy * stride;
+            l_massLocal += l_waveLocal.getHeight()[l_id];
+            l_diffMax = std::max(l_diffMax, std::abs(l_waveLocal.getHeight()[l_id] - l_waveGlobal.getHeight()[l_id]));
+        }
+    }
+
+    REQUIRE(l_massLocal == Approx(l_mass[1]).epsilon(1E-5));
+    REQUIRE(l_diffMax < 0.25);
+    REQUIRE(l_nTileUpdates[1] < l_nTileUpdates[0]);
+}
+
+TEST_CASE("Test a bore crossing the class interfaces of the local time stepping.", "[WaveProp2dLocalTimeSteppingBore]")
+{
+    /*
+     * Test case:
+     *
+     *   Bore in x-direction (h = 10 for x < 8) running into a shallow lake at rest (h = 1) with closed boundaries.
+     *   Tiles of 8x8 cells, the tiles of the lake ahead of the bore take larger time steps.
+     *   Tiles next to the bore have to take its time step before the bore enters them.
+     *
+     *   The local time stepping has to conserve the mass, keep the bore stable and stay close to the global time stepping.
+     */
+    tsunami_lab::patches::WavePropagation2d<> l_waveGlobal(96, 16, 1, 1, 1, 1, 8, 8);
+    tsunami_lab::patches::WavePropagation2d<> l_waveLocal(96, 16, 1, 1, 1, 1, 8, 8, -1, 4);
+
+    tsunami_lab::patches::WavePropagation2d<> *l_waveProps[2] = {&l_waveGlobal, &l_waveLocal};
+    double l_mass = 0;
+    std::size_t l_nTileUpdates[2] = {0, 0};
+
+    for (int l_wp = 0; l_wp < 2; l_wp++)
+    {
+        l_mass = 0;
+        for (std::size_t l_cy = 0; l_cy < 16; l_cy++)
+        {
+            for (std::size_t l_cx = 0; l_cx < 96; l_cx++)
+            {
+                tsunami_lab::t_real l_h = l_cx < 8 ? 10 : 1;
+                l_waveProps[l_wp]->setHeight(l_cx, l_cy, l_h);
+                l_waveProps[l_wp]->setMomentumX(l_cx, l_cy, 0);
+                l_waveProps[l_wp]->setMomentumY(l_cx, l_cy, 0);
+                l_waveProps[l_wp]->setBathymetry(l_cx, l_cy, -1);
+                l_mass += l_h;
+            }
+        }
+
+        float l_time = 0;
+        float l_speedMax = std::sqrt(9.80665f * 10);
+        while (l_time < 6)
+        {
+            float l_dt = std::min(0.5f / l_speedMax, 6 - l_time);
+            l_waveProps[l_wp]->timeStep(l_dt);
+            l_time += l_dt;
+            l_speedMax = l_waveProps[l_wp]->getMaxWaveSpeed();
+            l_nTileUpdates[l_wp] += l_waveProps[l_wp]->getNumberOfComputedTiles();
+        }
+    }
+
+    double l_massLocal = 0;
+    float l_hMin = 10;
+    float l_hMax = 0;
+    float l_diffMax = 0;
+    int stride = 98;
+    for (std::size_t l_cy = 1; l_cy < 17; l_cy++)
+    {
+        for (std::size_t l_cx = 1; l_cx < 97; l_cx++)
+        {
+            std::size_t l_id = l_cx + l_cy * stride;
+            l_massLocal += l_waveLocal.getHeight()[l_id];
+            l_hMin = std::min(l_hMin, l_waveLocal.getHeight()[l_id]);
+            l_hMax = std::max(l_hMax, l_waveLocal.getHeight()[l_id]);
+            l_diffMax = std::max(l_diffMax, std::abs(l_waveLocal.getHeight()[l_id] - l_waveGlobal.getHeight()[l_id]));
+        }
+    }
+    REQUIRE(l_massLocal == Approx(l_mass).epsilon(1E-5));
+    REQUIRE(l_hMin >= 1 - 1E-3);
+    REQUIRE(l_hMax <= 10 + 1E-3);
+    REQUIRE(l_diffMax < 0.02);
+    REQUIRE(l_nTileUpdates[1] < l_nTileUpdates[0]);
+}
+
+TEST_CASE("Test the unsplit 2d wave propagation.", "[WaveProp2dUnsplit]")
+{
+    /*
+     * Test case 1:
+     *
+     *   Dam break in x-direction which is constant in y-direction.
+     *   The net-updates in y-direction vanish, both schemes have to match bitwise.
+     *
+     * Test case 2:
+     *
+     *   Radial dam break, both schemes have to agree within the splitting error.
+     */
+    for (int l_case = 0; l_case < 2; l_case++)
+    {
+        tsunami_lab::patches::WavePropagation2d<> l_waveSplit(30, 20, 0, 0, 0, 0);
+        tsunami_lab::patches::WavePropagation2d<> l_waveUnsplit(30, 20, 0, 0, 0, 0, 0, 0, -1, 1, true);
+
+        tsunami_lab::patches::WavePropagation *l_waveProps[2] = {&l_waveSplit, &l_waveUnsplit};
+
+        for (tsunami_lab::patches::WavePropagation *l_waveProp : l_waveProps)
+        {
+            if (l_case == 0)
+            {
+                for (std::size_t l_cy = 0; l_cy < 20; l_cy++)
+                {
+                    for (std::size_t l_cx = 0; l_cx < 30; l_cx++)
+                    {
+                        l_waveProp->setHeight(l_cx, l_cy, l_cx < 15 ? 10 : 5);
+                        l_waveProp->setMomentumX(l_cx, l_cy, 0);
+                        l_waveProp->setMomentumY(l_cx, l_cy, 0);
+                        l_waveProp->setBathymetry(l_cx, l_cy, -5);
+                    }
+                }
+                for (int l_st = 0; l_st < 20; l_st++)
+                {
+                    l_waveProp->timeStep(0.05);
+                }
+            }
+            else
+            {
+                runDamBreak(*l_waveProp, {30, 20, 15, 10, 25, 10, 5, -5, 0, 0}, 20);
+            }
+        }
+
+        int stride = 32;
+        for (std::size_t l_cy = 1; l_cy < 21; l_cy++)
+        {
+            for (std::size_t l_cx = 1; l_cx < 31; l_cx++)
+            {
+                std::size_t l_id = l_cx + l_cy * stride;
+                if (l_case == 0)
+                {
+                    REQUIRE(l_waveUnsplit.getHeight()[l_id] == l_waveSplit.getHeight()[l_id]);
+                    REQUIRE(l_waveUnsplit.getMomentumX()[l_id] == l_waveSplit.getMomentumX()[l_id]);
+                    REQUIRE(l_waveUnsplit.getMomentumY()[l_id] == 0);
+                }
+                else
+                {
+                    REQUIRE(l_waveUnsplit.getHeight()[l_id] == Approx(l_waveSplit.getHeight()[l_id]).margin(0.25));
+                    REQUIRE(l_waveUnsplit.getMomentumX()[l_id] == Approx(l_waveSplit.getMomentumX()[l_id]).margin(1));
+                    REQUIRE(l_waveUnsplit.getMomentumY()[l_id] == Approx(l_waveSplit.getMomentumY()[l_id]).margin(1));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Benchmark the split and the unsplit 2d wave propagation.", "[.benchmark]")
+{
+    /*
+     * Radial dam break on 1024x1024 cells, 20 time steps per scheme.
+     * Reports the cell updates per second and the modelled memory traffic per cell update:
+     *   split, per sweep:  net-updates read 3 fields and write 4 edge arrays,
+     *                      the update reads 4 edge arrays and 2 fields and writes 2 fields
+     *   unsplit:           reads 4 fields once and writes 3 fields, net-updates stay in row buffers
+     */
+    tsunami_lab::t_idx l_nCells = 1024;
+    int l_nSteps = 20;
+
+    for (bool l_unsplit : {false, true})
+    {
+        tsunami_lab::patches::WavePropagation2d<> l_waveProp(l_nCells, l_nCells, 0, 0, 0, 0, 0, 0, -1, 1, l_unsplit);
+        for (tsunami_lab::t_idx l_cy = 0; l_cy < l_nCells; l_cy++)
+        {
+            for (tsunami_lab::t_idx l_cx = 0; l_cx < l_nCells; l_cx++)
+            {
+                double l_dx = l_cx - l_nCells / 2.0;
+                double l_dy = l_cy - l_nCells / 2.0;
+                l_waveProp.setHeight(l_cx, l_cy, l_dx * l_dx + l_dy * l_dy < l_nCells * l_nCells / 16.0 ? 10 : 5);
+                l_waveProp.setBathymetry(l_cx, l_cy, -5);
+            }
+        }
+
+        auto l_start = std::chrono::steady_clock::now();
+        for (int l_st = 0; l_st < l_nSteps; l_st++)
+        {
+            l_waveProp.timeStep(0.05);
+        }
+        std::chrono::duration<double> l_duration = std::chrono::steady_clock::now() - l_start;
+
+        double l_cellUpdates = double(l_nCells) * l_nCells * l_nSteps;
+        double l_bytes = l_unsplit ? 7 * sizeof(float) : 2 * (7 * sizeof(float) + 8 * sizeof(float));
+        std::cout << (l_unsplit ? "unsplit: " : "split:   ")
+                  << l_cellUpdates / l_duration.count() * 1E-6 << " MCUPS, "
+                  << l_bytes << " bytes per cell update, "
+                  << l_cellUpdates * l_bytes / l_duration.count() * 1E-9 << " GB/s" << std::endl;
+
+        REQUIRE(l_waveProp.getMaxWaveSpeed() > 0);
+    }
+}
+
+TEST_CASE("Test the reproducibility of the 2d wave propagation across thread counts.", "[WaveProp2dThreads]")
+{
+    /*
+     * Test case:
+     *
+     *   Radial dam break over a sloped bathymetry, computed untiled and tiled with one and with four threads.
+     *   Every cell has to match bitwise.
+     */
+    int l_nThreads = omp_get_max_threads();
+
+    for (tsunami_lab::t_idx l_tileSize : {0, 6})
+    {
+        tsunami_lab::patches::WavePropagation2d<> l_waveSerial(33, 41, 0, 0, 1, 0, l_tileSize, l_tileSize);
+        tsunami_lab::patches::WavePropagation2d<> l_waveThreads(33, 41, 0, 0, 1, 0, l_tileSize, l_tileSize);
+
+        DamBreak l_damBreak = {33, 41, 15, 12, 36, 10, 5, -5, 0, -0.1f};
+        omp_set_num_threads(1);
+        runDamBreak(l_waveSerial, l_damBreak, 60);
+        omp_set_num_threads(4);
+        runDamBreak(l_waveThreads, l_damBreak, 60);
+
+        requireBitwiseEqual(l_waveThreads, l_waveSerial, 33, 41);
+    }
+
+    omp_set_num_threads(l_nThreads);
+}
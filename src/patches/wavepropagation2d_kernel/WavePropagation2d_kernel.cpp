@@ -9,17 +9,31 @@
 #define CL_TARGET_OPENCL_VERSION 300
 #define CL_USE_DEPRECATED_OPENCL_1_2_APIS
 
-#define KERNEL_X_AXIS_FUNC "updateXAxisKernel"
-#define KERNEL_Y_AXIS_FUNC "updateYAxisKernel"
-#define KERNEL_GHOSTCELLS_LR "setGhostOutflowLeftRight"
-#define KERNEL_GHOSTCELLS_TB "setGhostOutflowTopBottom"
-#define KERNEL_COPY "copy"
+#define KERNEL_X_EDGES_FUNC "netUpdatesXKernel"
+#define KERNEL_Y_EDGES_FUNC "netUpdatesYKernel"
+#define KERNEL_X_CELLS_FUNC "updateXCellsKernel"
+#define KERNEL_Y_CELLS_FUNC "updateYCellsKernel"
+#define KERNEL_X_TILED_FUNC "sweepXTiledKernel"
+#define KERNEL_Y_TILED_FUNC "sweepYTiledKernel"
+#define KERNEL_COARSEN_FUNC "coarsenKernel"
 
 #include "WavePropagation2d_kernel.h"
+#include "kernel_source.h"
 
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 #include <filesystem>
 #include "../../solvers/f-wave/F_wave.h"
 #include <cmath>
@@ -61,42 +75,22 @@ cl_device_id create_device()
 }
 
 // build program from https://github.com/rsnemmen/OpenCL-examples
-cl_program build_program(cl_context ctx, cl_device_id dev, const char *filename)
+cl_program build_program(cl_context ctx, cl_device_id dev, const char *program_buffer, size_t program_size)
 
 {
 
     cl_program program;
-    FILE *program_handle;
-    char *program_buffer, *program_log;
-    size_t program_size, log_size;
+    char *program_log;
+    size_t log_size;
     int err;
 
-    program_handle = fopen(filename, "rb");
-    if (program_handle == NULL)
-    {
-        perror("Couldn't find the program file");
-        exit(1);
-    }
-    fseek(program_handle, 0, SEEK_END);
-    program_size = ftell(program_handle);
-    rewind(program_handle);
-    program_buffer = (char *)malloc(program_size + 1);
-    program_buffer[program_size] = '\0';
-    size_t items_read = fread(program_buffer, sizeof(char), program_size, program_handle);
-    if (items_read != program_size)
-    {
-        exit(1);
-    }
-    fclose(program_handle);
-
     program = clCreateProgramWithSource(ctx, 1,
-                                        (const char **)&program_buffer, &program_size, &err);
+                                        &program_buffer, &program_size, &err);
     if (err < 0)
     {
         perror("Couldn't create the program");
         exit(1);
     }
-    free(program_buffer);
 
     err = clBuildProgram(program, 0, NULL, NULL, NULL, NULL);
     if (err < 0)
@@ -117,7 +111,149 @@ cl_program build_program(cl_context ctx, cl_device_id dev, const char *filename)
     return program;
 }
 
-// depricated
+/**
+ * Gets the directory of the files cached between runs: $TSUNAMI_LAB_CACHE if set, otherwise ~/.cache/tsunami_lab.
+ *
+ * @return directory, which might not exist yet, or an empty path if there is no home directory.
+ **/
+std::filesystem::path getCacheDirectory()
+{
+    if (char const *l_cache = std::getenv("TSUNAMI_LAB_CACHE"))
+    {
+        return l_cache;
+    }
+    if (char const *l_home = std::getenv("HOME"))
+    {
+        return std::filesystem::path(l_home) / ".cache" / "tsunami_lab";
+    }
+    return std::filesystem::path();
+}
+
+/**
+ * Gets a string property of a device.
+ *
+ * @param i_device device.
+ * @param i_param property, e.g. CL_DEVICE_NAME.
+ * @return value without the terminating null character.
+ **/
+std::string getDeviceString(cl_device_id i_device,
+                            cl_device_info i_param)
+{
+    size_t l_size = 0;
+    clGetDeviceInfo(i_device, i_param, 0, NULL, &l_size);
+    std::string l_value(l_size, '\0');
+    clGetDeviceInfo(i_device, i_param, l_size, &l_value[0], NULL);
+    return l_value.c_str();
+}
+
+/**
+ * Hashes a string with 64-bit FNV-1a, which unlike std::hash is the same for every build and run.
+ *
+ * @param i_data string.
+ * @return hash as 16 hexadecimal digits.
+ **/
+std::string hashString(std::string const &i_data)
+{
+    uint64_t l_hash = 14695981039346656037ull;
+    for (unsigned char l_char : i_data)
+    {
+        l_hash = (l_hash ^ l_char) * 1099511628211ull;
+    }
+    std::ostringstream l_hex;
+    l_hex << std::hex << std::setw(16) << std::setfill('0') << l_hash;
+    return l_hex.str();
+}
+
+/**
+ * Builds the program, using a binary cached on disk if a previous run built the same source for the same device and driver.
+ * The file of a binary starts with its key, a binary which the runtime rejects is rebuilt from source and replaced.
+ *
+ * @param i_context context.
+ * @param i_device device.
+ * @param i_source source of the program.
+ * @return built program.
+ **/
+cl_program load_program(cl_context i_context,
+                        cl_device_id i_device,
+                        std::string const &i_source)
+{
+    std::string l_key = "device: " + getDeviceString(i_device, CL_DEVICE_NAME) + "\n" +
+                        "driver: " + getDeviceString(i_device, CL_DRIVER_VERSION) + "\n" +
+                        "source: " + hashString(i_source) + "\n";
+    std::filesystem::path l_directory = getCacheDirectory();
+    std::filesystem::path l_path;
+    if (!l_directory.empty())
+    {
+        l_path = l_directory / ("kernel_" + hashString(l_key) + ".bin");
+    }
+
+    // binary of a previous run
+    std::ifstream l_cached(l_path, std::ios::binary);
+    if (!l_path.empty() && l_cached)
+    {
+        std::string l_file((std::istreambuf_iterator<char>(l_cached)), std::istreambuf_iterator<char>());
+        if (l_file.compare(0, l_key.size(), l_key) == 0 && l_file.size() > l_key.size())
+        {
+            size_t l_size = l_file.size() - l_key.size();
+            unsigned char const *l_binary = reinterpret_cast<unsigned char const *>(l_file.data() + l_key.size());
+            cl_int l_status = CL_SUCCESS;
+            cl_int l_err = CL_SUCCESS;
+            cl_program l_program = clCreateProgramWithBinary(i_context, 1, &i_device, &l_size, &l_binary, &l_status, &l_err);
+            if (l_err == CL_SUCCESS && l_status == CL_SUCCESS)
+            {
+                l_err = clBuildProgram(l_program, 0, NULL, NULL, NULL, NULL);
+                if (l_err == CL_SUCCESS)
+                {
+                    std::cout << "Kernel binary: " << l_path.string() << std::endl;
+                    return l_program;
+                }
+            }
+            if (l_program != nullptr)
+            {
+                clReleaseProgram(l_program);
+            }
+        }
+        std::cout << "Kernel binary " << l_path.string() << " is outdated, rebuilding" << std::endl;
+    }
+
+    cl_program l_program = build_program(i_context, i_device, i_source.data(), i_source.size());
+    if (l_path.empty())
+    {
+        return l_program;
+    }
+
+    // the binary is written to a temporary file first, concurrent runs never read a partial binary
+    size_t l_size = 0;
+    clGetProgramInfo(l_program, CL_PROGRAM_BINARY_SIZES, sizeof(size_t), &l_size, NULL);
+    std::vector<unsigned char> l_binary(l_size);
+    unsigned char *l_binaryPtr = l_binary.data();
+    std::error_code l_error;
+    std::filesystem::create_directories(l_directory, l_error);
+    std::filesystem::path l_tmpPath = l_path;
+    l_tmpPath += "." + std::to_string(getpid());
+    if (l_size > 0 && clGetProgramInfo(l_program, CL_PROGRAM_BINARIES, sizeof(unsigned char *), &l_binaryPtr, NULL) == CL_SUCCESS)
+    {
+        std::ofstream l_out(l_tmpPath, std::ios::binary);
+        l_out << l_key;
+        l_out.write(reinterpret_cast<char const *>(l_binary.data()), l_size);
+        l_out.close();
+        if (l_out)
+        {
+            std::filesystem::rename(l_tmpPath, l_path, l_error);
+        }
+        if (!l_out || l_error)
+        {
+            std::filesystem::remove(l_tmpPath, l_error);
+            std::cout << "Could not cache the kernel binary in " << l_path.string() << std::endl;
+        }
+        else
+        {
+            std::cout << "Kernel binary cached in " << l_path.string() << std::endl;
+        }
+    }
+    return l_program;
+}
+
 size_t findMaxLocalSize(cl_device_id device)
 {
     size_t maxLocalSize;
@@ -177,7 +313,6 @@ size_t *findLocalWorker(cl_device_id device, size_t *global_size)
 
     return localSize;
 }
-//
 
 tsunami_lab::patches::WavePropagation2d_kernel::WavePropagation2d_kernel(t_idx i_nCells_x,
                                                                          t_idx i_nCells_y,
@@ -193,158 +328,919 @@ tsunami_lab::patches::WavePropagation2d_kernel::WavePropagation2d_kernel(t_idx i
     m_state_boundary_top = state_boundary_top;
     m_state_boundary_bottom = state_boundary_bottom;
 
-    // allocate memory including a single ghost cell on each side and initializing with 0
-    // The 2d x-y grid is being flattened into a 1d array
-    m_h = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_hu = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_hv = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
-    m_b = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
+    m_size = sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2);
 
     device = create_device();
 
     context = clCreateContext(NULL, 1, &device, NULL, NULL, &err);
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not create the context (" << err << ")." << std::endl;
+        exit(EXIT_FAILURE);
+    }
 
-    std::filesystem::path currentPath = std::filesystem::current_path();
-    std::string kernel_path = currentPath.string() + "/src/patches/wavepropagation2d_kernel/kernel.cl";
-    const char *kernel_path_char = kernel_path.c_str();
-
-    std::cout << "Kernel path: " << kernel_path_char << std::endl;
+    // the source of the kernels is embedded by the build, the executable runs from any directory
+    program = load_program(context, device, g_kernelSource);
+    cl_kernel *l_kernels[5] = {&knetUpdatesX, &knetUpdatesY, &kupdateCellsX, &kupdateCellsY, &kcoarsen};
+    char const *l_names[5] = {KERNEL_X_EDGES_FUNC, KERNEL_Y_EDGES_FUNC, KERNEL_X_CELLS_FUNC, KERNEL_Y_CELLS_FUNC, KERNEL_COARSEN_FUNC};
+    for (unsigned short l_ke = 0; l_ke < 5; l_ke++)
+    {
+        *l_kernels[l_ke] = clCreateKernel(program, l_names[l_ke], &err);
+        if (err != CL_SUCCESS)
+        {
+            std::cerr << "Error: Could not create the kernel " << l_names[l_ke] << " (" << err << ")." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    program = build_program(context, device, kernel_path_char);
-    ksetGhostOutflowLR = clCreateKernel(program, KERNEL_GHOSTCELLS_LR, &err);
-    ksetGhostOutflowTB = clCreateKernel(program, KERNEL_GHOSTCELLS_TB, &err);
-    kcopy = clCreateKernel(program, KERNEL_COPY, &err);
-    knetUpdatesX = clCreateKernel(program, KERNEL_X_AXIS_FUNC, &err);
-    knetUpdatesY = clCreateKernel(program, KERNEL_Y_AXIS_FUNC, &err);
+    for (cl_command_queue *l_queue : {&queue, &m_transferQueue})
+    {
+        *l_queue = clCreateCommandQueue(context, device, 0, &err);
+        if (err != CL_SUCCESS)
+        {
+            std::cerr << "Error: Could not create a command queue (" << err << ")." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
 
-    queue = clCreateCommandQueue(context, device, 0, &err);
+    // allocate pinned memory including a single ghost cell on each side and initializing with 0
+    // The 2d x-y grid is being flattened into a 1d array
+    m_h = mapHostBuffer(m_size, m_host_buff[0]);
+    m_hu = mapHostBuffer(m_size, m_host_buff[1]);
+    m_hv = mapHostBuffer(m_size, m_host_buff[2]);
+    m_b = mapHostBuffer(m_size, m_host_buff[3]);
 
     global_size[0] = {m_nCells_x + 2};
     global_size[1] = {m_nCells_y + 2};
+    for (unsigned short l_ke = 0; l_ke < 4; l_ke++)
+    {
+        setLocalSizeUntiled(l_ke, 0, 0);
+    }
 
-    // depricated
-    localWorker = findLocalWorker(device, global_size);
+    // default work-group size of the tiled kernels, which cover the interior cells
+    size_t l_interior[2] = {m_nCells_x, m_nCells_y};
+    localWorker = findLocalWorker(device, l_interior);
 
-    std::cout << "Local size (depricated): " << localWorker[0] << " " << localWorker[1] << std::endl;
+    std::cout << "Default work-group size of the tiled kernels: " << localWorker[0] << " " << localWorker[1] << std::endl;
 }
 
 tsunami_lab::patches::WavePropagation2d_kernel::~WavePropagation2d_kernel()
 {
+    // the readback of the last output writes to the pinned memory
+    if (m_coarseTransfer.valid())
+    {
+        m_coarseTransfer.wait();
+    }
+    clFinish(queue);
+    clFinish(m_transferQueue);
 
-    delete[] m_h;
-    delete[] m_hu;
-    delete[] m_hv;
-    delete[] m_b;
+    unmapHostBuffer(m_host_buff[0], m_h);
+    unmapHostBuffer(m_host_buff[1], m_hu);
+    unmapHostBuffer(m_host_buff[2], m_hv);
+    unmapHostBuffer(m_host_buff[3], m_b);
+    if (m_coarseHost_buff != nullptr)
+    {
+        unmapHostBuffer(m_coarseHost_buff, m_coarseHost);
+    }
+    delete[] localWorker;
 
     clReleaseProgram(program);
     clReleaseContext(context);
-    clReleaseMemObject(m_h_buff);
-    clReleaseMemObject(m_hu_buff);
-    clReleaseMemObject(m_hv_buff);
-    clReleaseMemObject(m_b_buff);
-    clReleaseMemObject(m_hTemp_buff);
-    clReleaseMemObject(m_huvTemp_buff);
-    clReleaseKernel(ksetGhostOutflowLR);
-    clReleaseKernel(ksetGhostOutflowTB);
-    clReleaseKernel(kcopy);
+    // the buffers only exist after setData
+    for (cl_mem l_buff : {m_h_buff, m_hu_buff, m_hv_buff, m_b_buff,
+                          m_netUpdates_buff[0], m_netUpdates_buff[1], m_netUpdates_buff[2], m_netUpdates_buff[3],
+                          m_hNext_buff, m_huNext_buff, m_hvNext_buff, m_coarse_buff})
+    {
+        if (l_buff != nullptr)
+        {
+            clReleaseMemObject(l_buff);
+        }
+    }
+    for (cl_kernel *l_kernels : m_tiledKernels)
+    {
+        for (unsigned short l_ke = 0; l_ke < 2; l_ke++)
+        {
+            if (l_kernels[l_ke] != nullptr)
+            {
+                clReleaseKernel(l_kernels[l_ke]);
+            }
+        }
+    }
     clReleaseKernel(knetUpdatesX);
     clReleaseKernel(knetUpdatesY);
+    clReleaseKernel(kupdateCellsX);
+    clReleaseKernel(kupdateCellsY);
+    clReleaseKernel(kcoarsen);
     clReleaseCommandQueue(queue);
+    clReleaseCommandQueue(m_transferQueue);
 }
 
-void tsunami_lab::patches::WavePropagation2d_kernel::timeStep(t_real i_scaling)
+tsunami_lab::t_real *tsunami_lab::patches::WavePropagation2d_kernel::mapHostBuffer(size_t i_size,
+                                                                                   cl_mem &o_buff)
 {
-    // set ghost cells
-    clSetKernelArg(ksetGhostOutflowLR, 0, sizeof(cl_mem), &m_h_buff);
-    clSetKernelArg(ksetGhostOutflowLR, 1, sizeof(cl_mem), &m_hu_buff);
-    clSetKernelArg(ksetGhostOutflowLR, 2, sizeof(cl_mem), &m_b_buff);
-    clSetKernelArg(ksetGhostOutflowLR, 3, sizeof(size_t), &m_nCells_x);
-    clSetKernelArg(ksetGhostOutflowLR, 4, sizeof(size_t), &m_nCells_y);
-    clSetKernelArg(ksetGhostOutflowLR, 5, sizeof(int), &m_state_boundary_left);
-    clSetKernelArg(ksetGhostOutflowLR, 6, sizeof(int), &m_state_boundary_right);
+    // the runtime allocates pinned memory, which the device transfers from and to without staging copies
+    cl_int l_err = CL_SUCCESS;
+    o_buff = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, i_size, NULL, &l_err);
+    t_real *l_mapped = nullptr;
+    if (l_err == CL_SUCCESS)
+    {
+        l_mapped = static_cast<t_real *>(clEnqueueMapBuffer(queue, o_buff, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, i_size, 0, NULL, NULL, &l_err));
+    }
+    if (l_err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not map pinned host memory of " << i_size << " bytes (" << l_err << ")." << std::endl;
+        exit(EXIT_FAILURE);
+    }
 
-    clEnqueueNDRangeKernel(queue, ksetGhostOutflowLR, 2, NULL, global_size, NULL, 0, NULL, NULL);
+    std::fill(l_mapped, l_mapped + i_size / sizeof(t_real), t_real(0));
+    return l_mapped;
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::unmapHostBuffer(cl_mem &io_buff,
+                                                                     t_real *i_mapped)
+{
+    clEnqueueUnmapMemObject(queue, io_buff, i_mapped, 0, NULL, NULL);
     clFinish(queue);
+    clReleaseMemObject(io_buff);
+    io_buff = nullptr;
+}
 
-    // copy data
-    clSetKernelArg(kcopy, 0, sizeof(cl_mem), &m_h_buff);
-    clSetKernelArg(kcopy, 1, sizeof(cl_mem), &m_hu_buff);
-    clSetKernelArg(kcopy, 2, sizeof(size_t), &m_nCells_x);
-    clSetKernelArg(kcopy, 3, sizeof(size_t), &m_nCells_y);
-    clSetKernelArg(kcopy, 4, sizeof(cl_mem), &m_hTemp_buff);
-    clSetKernelArg(kcopy, 5, sizeof(cl_mem), &m_huvTemp_buff);
+void tsunami_lab::patches::WavePropagation2d_kernel::bindScaling(t_real i_scaling)
+{
+    // the kernels keep their arguments between launches, only a new scaling has to be set
+    if (i_scaling == m_scaling)
+    {
+        return;
+    }
 
-    clEnqueueNDRangeKernel(queue, kcopy, 2, NULL, global_size, NULL, 0, NULL, NULL);
-    clFinish(queue);
+    // the tiled kernels only exist if they were bound, e.g. for the tuning both kinds are bound
+    err = clSetKernelArg(kupdateCellsX, 8, sizeof(float), &i_scaling);
+    err |= clSetKernelArg(kupdateCellsY, 8, sizeof(float), &i_scaling);
+    for (cl_kernel *l_kernels : m_tiledKernels)
+    {
+        if (l_kernels[0] != nullptr)
+        {
+            err |= clSetKernelArg(l_kernels[0], 5, sizeof(float), &i_scaling);
+            err |= clSetKernelArg(l_kernels[1], 5, sizeof(float), &i_scaling);
+        }
+    }
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not set the scaling of the cell kernels." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    m_scaling = i_scaling;
+}
 
-    // update x-axis
-    clSetKernelArg(knetUpdatesX, 0, sizeof(cl_mem), &m_hTemp_buff);
-    clSetKernelArg(knetUpdatesX, 1, sizeof(cl_mem), &m_huvTemp_buff);
-    clSetKernelArg(knetUpdatesX, 2, sizeof(cl_mem), &m_b_buff);
-    clSetKernelArg(knetUpdatesX, 3, sizeof(size_t), &m_nCells_x);
-    clSetKernelArg(knetUpdatesX, 4, sizeof(size_t), &m_nCells_y);
-    clSetKernelArg(knetUpdatesX, 5, sizeof(float), &i_scaling);
-    clSetKernelArg(knetUpdatesX, 6, sizeof(cl_mem), &m_h_buff);
-    clSetKernelArg(knetUpdatesX, 7, sizeof(cl_mem), &m_hu_buff);
-
-    clEnqueueNDRangeKernel(queue, knetUpdatesX, 2, NULL, global_size, NULL, 0, NULL, NULL);
-    clFinish(queue);
+void tsunami_lab::patches::WavePropagation2d_kernel::enqueueTimeStep(cl_command_queue i_queue,
+                                                                     cl_event *o_events)
+{
+    // the queue is in-order, thus each kernel starts after the previous one has finished
+    err = CL_SUCCESS;
+    if (m_tiled)
+    {
+        // the sweeps of even and odd steps swap the buffers of the momenta
+        cl_kernel *l_kernels = m_tiledKernels[m_step];
+        for (unsigned short l_ke = 0; l_ke < 2; l_ke++)
+        {
+            err |= clEnqueueNDRangeKernel(i_queue, l_kernels[l_ke], 2, NULL, m_globalSizeTiled[l_ke], m_localSize[l_ke], 0, NULL,
+                                          o_events == nullptr ? NULL : o_events + l_ke);
+        }
+        m_step = (m_step + 1) % 2;
+    }
+    else
+    {
+        cl_kernel l_kernels[4] = {knetUpdatesX, kupdateCellsX, knetUpdatesY, kupdateCellsY};
 
-    // set ghost cells
-    clSetKernelArg(ksetGhostOutflowTB, 0, sizeof(cl_mem), &m_h_buff);
-    clSetKernelArg(ksetGhostOutflowTB, 1, sizeof(cl_mem), &m_hv_buff);
-    clSetKernelArg(ksetGhostOutflowTB, 2, sizeof(cl_mem), &m_b_buff);
-    clSetKernelArg(ksetGhostOutflowTB, 3, sizeof(size_t), &m_nCells_x);
-    clSetKernelArg(ksetGhostOutflowTB, 4, sizeof(size_t), &m_nCells_y);
-    clSetKernelArg(ksetGhostOutflowTB, 5, sizeof(int), &m_state_boundary_top);
-    clSetKernelArg(ksetGhostOutflowTB, 6, sizeof(int), &m_state_boundary_bottom);
+        for (unsigned short l_ke = 0; l_ke < 4; l_ke++)
+        {
+            size_t const *l_localSize = m_localSizeUntiled[l_ke][0] > 0 ? m_localSizeUntiled[l_ke] : NULL;
+            err |= clEnqueueNDRangeKernel(i_queue, l_kernels[l_ke], 2, NULL, m_globalSizeUntiled[l_ke], l_localSize, 0, NULL,
+                                          o_events == nullptr ? NULL : o_events + l_ke);
+        }
+    }
 
-    clEnqueueNDRangeKernel(queue, ksetGhostOutflowTB, 2, NULL, global_size, NULL, 0, NULL, NULL);
-    clFinish(queue);
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not enqueue a kernel of the time step (" << err << ")." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
 
-    // copy data
-    clSetKernelArg(kcopy, 0, sizeof(cl_mem), &m_h_buff);
-    clSetKernelArg(kcopy, 1, sizeof(cl_mem), &m_hv_buff);
-    clSetKernelArg(kcopy, 2, sizeof(size_t), &m_nCells_x);
-    clSetKernelArg(kcopy, 3, sizeof(size_t), &m_nCells_y);
-    clSetKernelArg(kcopy, 4, sizeof(cl_mem), &m_hTemp_buff);
-    clSetKernelArg(kcopy, 5, sizeof(cl_mem), &m_huvTemp_buff);
+bool tsunami_lab::patches::WavePropagation2d_kernel::fitsWorkGroup(cl_kernel i_kernel,
+                                                                   size_t i_localSize_x,
+                                                                   size_t i_localSize_y,
+                                                                   bool i_tiled) const
+{
+    // the maximum work-group size of a kernel might be below the one of the device, e.g. due to its registers
+    size_t l_maxKernel = findMaxLocalSize(device);
+    if (i_kernel != nullptr)
+    {
+        clGetKernelWorkGroupInfo(i_kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(l_maxKernel), &l_maxKernel, NULL);
+    }
+    // a device reports the maximum number of work-items per dimension for each of its dimensions, at least three
+    cl_uint l_nDims = 3;
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, sizeof(l_nDims), &l_nDims, NULL);
+    std::vector<size_t> l_maxItems(std::max(l_nDims, cl_uint(2)), 0);
+    clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(size_t) * l_maxItems.size(), l_maxItems.data(), NULL);
+    if (i_localSize_x == 0 || i_localSize_y == 0 || i_localSize_x * i_localSize_y > l_maxKernel ||
+        i_localSize_x > l_maxItems[0] || i_localSize_y > l_maxItems[1])
+    {
+        return false;
+    }
+    if (!i_tiled)
+    {
+        return true;
+    }
 
-    clEnqueueNDRangeKernel(queue, kcopy, 2, NULL, global_size, NULL, 0, NULL, NULL);
-    clFinish(queue);
+    // a work-group stages its cells with the halo and the net-updates of its edges in local memory
+    size_t l_localMemX = sizeof(float) * (3 * (i_localSize_x + 2) * i_localSize_y + 4 * (i_localSize_x + 1) * i_localSize_y);
+    size_t l_localMemY = sizeof(float) * (3 * i_localSize_x * (i_localSize_y + 2) + 4 * i_localSize_x * (i_localSize_y + 1));
+    cl_ulong l_localMemDevice = 0;
+    clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(l_localMemDevice), &l_localMemDevice, NULL);
+    return std::max(l_localMemX, l_localMemY) <= l_localMemDevice;
+}
 
-    // update y-axis
-    clSetKernelArg(knetUpdatesY, 0, sizeof(cl_mem), &m_hTemp_buff);
-    clSetKernelArg(knetUpdatesY, 1, sizeof(cl_mem), &m_huvTemp_buff);
-    clSetKernelArg(knetUpdatesY, 2, sizeof(cl_mem), &m_b_buff);
-    clSetKernelArg(knetUpdatesY, 3, sizeof(size_t), &m_nCells_x);
-    clSetKernelArg(knetUpdatesY, 4, sizeof(size_t), &m_nCells_y);
-    clSetKernelArg(knetUpdatesY, 5, sizeof(float), &i_scaling);
-    clSetKernelArg(knetUpdatesY, 6, sizeof(cl_mem), &m_h_buff);
-    clSetKernelArg(knetUpdatesY, 7, sizeof(cl_mem), &m_hv_buff);
-
-    clEnqueueNDRangeKernel(queue, knetUpdatesY, 2, NULL, global_size, NULL, 0, NULL, NULL);
-    clFinish(queue);
+void tsunami_lab::patches::WavePropagation2d_kernel::setLocalSizeUntiled(unsigned short i_kernel,
+                                                                         size_t i_localSize_x,
+                                                                         size_t i_localSize_y)
+{
+    // the kernels skip the work-items outside of the cells
+    m_localSizeUntiled[i_kernel][0] = i_localSize_x;
+    m_localSizeUntiled[i_kernel][1] = i_localSize_y;
+    for (unsigned short l_di = 0; l_di < 2; l_di++)
+    {
+        size_t l_local = std::max(m_localSizeUntiled[i_kernel][l_di], size_t(1));
+        m_globalSizeUntiled[i_kernel][l_di] = (global_size[l_di] + l_local - 1) / l_local * l_local;
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::setLocalSizeTiled(unsigned short i_sweep,
+                                                                       size_t i_localSize_x,
+                                                                       size_t i_localSize_y)
+{
+    m_localSize[i_sweep][0] = i_localSize_x;
+    m_localSize[i_sweep][1] = i_localSize_y;
+    m_globalSizeTiled[i_sweep][0] = (m_nCells_x + i_localSize_x - 1) / i_localSize_x * i_localSize_x;
+    m_globalSizeTiled[i_sweep][1] = (m_nCells_y + i_localSize_y - 1) / i_localSize_y * i_localSize_y;
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::setTiling(t_idx i_localSize_x,
+                                                               t_idx i_localSize_y)
+{
+    if (i_localSize_x == 0 || i_localSize_y == 0)
+    {
+        m_tiled = false;
+        return;
+    }
+
+    createTiledKernels();
+    if (!fitsWorkGroup(m_tiledKernels[0][0], i_localSize_x, i_localSize_y, true) ||
+        !fitsWorkGroup(m_tiledKernels[0][1], i_localSize_x, i_localSize_y, true))
+    {
+        std::cerr << "Error: The work-group size " << i_localSize_x << " x " << i_localSize_y
+                  << " exceeds the maximum work-group size or the local memory of the device." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    m_tiled = true;
+    setLocalSizeTiled(0, i_localSize_x, i_localSize_y);
+    setLocalSizeTiled(1, i_localSize_x, i_localSize_y);
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::bindUntiledKernels()
+{
+    // the net-updates of an edge are stored at the id of its left/lower cell
+    err = CL_SUCCESS;
+    for (cl_mem &l_buff : m_netUpdates_buff)
+    {
+        if (l_buff == nullptr)
+        {
+            cl_int l_err = CL_SUCCESS;
+            l_buff = clCreateBuffer(context, CL_MEM_READ_WRITE, m_size, NULL, &l_err);
+            err |= l_err;
+        }
+    }
+
+    // edge and cell kernels of each sweep
+    cl_mem *l_momenta[2] = {&m_hu_buff, &m_hv_buff};
+    cl_kernel l_edges[2] = {knetUpdatesX, knetUpdatesY};
+    cl_kernel l_cells[2] = {kupdateCellsX, kupdateCellsY};
+    // the edge kernels derive the ghost cells from the boundary states of their sweep
+    int l_boundaries[2][2] = {{m_state_boundary_left, m_state_boundary_right},
+                              {m_state_boundary_bottom, m_state_boundary_top}};
+    for (unsigned short l_sw = 0; l_sw < 2; l_sw++)
+    {
+        err |= clSetKernelArg(l_edges[l_sw], 0, sizeof(cl_mem), &m_h_buff);
+        err |= clSetKernelArg(l_edges[l_sw], 1, sizeof(cl_mem), l_momenta[l_sw]);
+        err |= clSetKernelArg(l_edges[l_sw], 2, sizeof(cl_mem), &m_b_buff);
+        err |= clSetKernelArg(l_edges[l_sw], 3, sizeof(size_t), &m_nCells_x);
+        err |= clSetKernelArg(l_edges[l_sw], 4, sizeof(size_t), &m_nCells_y);
+        err |= clSetKernelArg(l_edges[l_sw], 9, sizeof(int), l_boundaries[l_sw]);
+        err |= clSetKernelArg(l_edges[l_sw], 10, sizeof(int), l_boundaries[l_sw] + 1);
+
+        // the scaling (argument 8) is bound by the time steps
+        err |= clSetKernelArg(l_cells[l_sw], 0, sizeof(cl_mem), &m_h_buff);
+        err |= clSetKernelArg(l_cells[l_sw], 1, sizeof(cl_mem), l_momenta[l_sw]);
+        err |= clSetKernelArg(l_cells[l_sw], 6, sizeof(size_t), &m_nCells_x);
+        err |= clSetKernelArg(l_cells[l_sw], 7, sizeof(size_t), &m_nCells_y);
+
+        for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+        {
+            err |= clSetKernelArg(l_edges[l_sw], 5 + l_nu, sizeof(cl_mem), &m_netUpdates_buff[l_nu]);
+            err |= clSetKernelArg(l_cells[l_sw], 2 + l_nu, sizeof(cl_mem), &m_netUpdates_buff[l_nu]);
+        }
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::bindLocalMemory()
+{
+    size_t l_localCellsX = sizeof(float) * (m_localSize[0][0] + 2) * m_localSize[0][1];
+    size_t l_localEdgesX = 4 * sizeof(float) * (m_localSize[0][0] + 1) * m_localSize[0][1];
+    size_t l_localCellsY = sizeof(float) * m_localSize[1][0] * (m_localSize[1][1] + 2);
+    size_t l_localEdgesY = 4 * sizeof(float) * m_localSize[1][0] * (m_localSize[1][1] + 1);
+
+    for (cl_kernel *l_kernels : m_tiledKernels)
+    {
+        err |= clSetKernelArg(l_kernels[0], 8, l_localCellsX, NULL);
+        err |= clSetKernelArg(l_kernels[0], 9, l_localCellsX, NULL);
+        err |= clSetKernelArg(l_kernels[0], 10, l_localCellsX, NULL);
+        err |= clSetKernelArg(l_kernels[0], 11, l_localEdgesX, NULL);
+
+        err |= clSetKernelArg(l_kernels[1], 8, l_localCellsY, NULL);
+        err |= clSetKernelArg(l_kernels[1], 9, l_localCellsY, NULL);
+        err |= clSetKernelArg(l_kernels[1], 10, l_localCellsY, NULL);
+        err |= clSetKernelArg(l_kernels[1], 11, l_localEdgesY, NULL);
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::createTiledKernels()
+{
+    char const *l_names[2] = {KERNEL_X_TILED_FUNC, KERNEL_Y_TILED_FUNC};
+    for (cl_kernel *l_kernels : m_tiledKernels)
+    {
+        for (unsigned short l_ke = 0; l_ke < 2; l_ke++)
+        {
+            if (l_kernels[l_ke] == nullptr)
+            {
+                cl_int l_err = CL_SUCCESS;
+                l_kernels[l_ke] = clCreateKernel(program, l_names[l_ke], &l_err);
+                if (l_err != CL_SUCCESS)
+                {
+                    std::cerr << "Error: Could not create the kernel " << l_names[l_ke] << " (" << l_err << ")." << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+        }
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::bindTiledKernels()
+{
+    // the x-sweep writes the heights to the next buffer, the y-sweep back, the momenta alternate between the steps
+    createTiledKernels();
+    err = CL_SUCCESS;
+    cl_mem *l_next[3] = {&m_hNext_buff, &m_huNext_buff, &m_hvNext_buff};
+    t_real *l_host[3] = {m_h, m_hu, m_hv};
+    for (unsigned short l_qt = 0; l_qt < 3; l_qt++)
+    {
+        if (*l_next[l_qt] == nullptr)
+        {
+            cl_int l_err = CL_SUCCESS;
+            *l_next[l_qt] = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, m_size, l_host[l_qt], &l_err);
+            err |= l_err;
+        }
+    }
+
+    for (unsigned short l_st = 0; l_st < 2; l_st++)
+    {
+        cl_mem *l_huIn = (l_st == 0) ? &m_hu_buff : &m_huNext_buff;
+        cl_mem *l_huOut = (l_st == 0) ? &m_huNext_buff : &m_hu_buff;
+        cl_mem *l_hvIn = (l_st == 0) ? &m_hv_buff : &m_hvNext_buff;
+        cl_mem *l_hvOut = (l_st == 0) ? &m_hvNext_buff : &m_hv_buff;
+
+        cl_kernel *l_kernels = m_tiledKernels[l_st];
+
+        // x-sweep, the scaling (argument 5) is bound by the time steps, the local memory (arguments 8 - 11) by bindLocalMemory
+        err |= clSetKernelArg(l_kernels[0], 0, sizeof(cl_mem), &m_h_buff);
+        err |= clSetKernelArg(l_kernels[0], 1, sizeof(cl_mem), l_huIn);
+        err |= clSetKernelArg(l_kernels[0], 6, sizeof(cl_mem), &m_hNext_buff);
+        err |= clSetKernelArg(l_kernels[0], 7, sizeof(cl_mem), l_huOut);
+        err |= clSetKernelArg(l_kernels[0], 12, sizeof(int), &m_state_boundary_left);
+        err |= clSetKernelArg(l_kernels[0], 13, sizeof(int), &m_state_boundary_right);
+
+        // y-sweep
+        err |= clSetKernelArg(l_kernels[1], 0, sizeof(cl_mem), &m_hNext_buff);
+        err |= clSetKernelArg(l_kernels[1], 1, sizeof(cl_mem), l_hvIn);
+        err |= clSetKernelArg(l_kernels[1], 6, sizeof(cl_mem), &m_h_buff);
+        err |= clSetKernelArg(l_kernels[1], 7, sizeof(cl_mem), l_hvOut);
+        err |= clSetKernelArg(l_kernels[1], 12, sizeof(int), &m_state_boundary_bottom);
+        err |= clSetKernelArg(l_kernels[1], 13, sizeof(int), &m_state_boundary_top);
+
+        for (cl_kernel l_kernel : {l_kernels[0], l_kernels[1]})
+        {
+            err |= clSetKernelArg(l_kernel, 2, sizeof(cl_mem), &m_b_buff);
+            err |= clSetKernelArg(l_kernel, 3, sizeof(size_t), &m_nCells_x);
+            err |= clSetKernelArg(l_kernel, 4, sizeof(size_t), &m_nCells_y);
+        }
+    }
+    bindLocalMemory();
+    m_step = 0;
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::restoreCells(t_real const *i_h,
+                                                                  t_real const *i_hu,
+                                                                  t_real const *i_hv)
+{
+    // the buffers of the tiled sweeps only exist if the tiled kernels were bound
+    err = CL_SUCCESS;
+    cl_mem l_buffs[6] = {m_h_buff, m_hu_buff, m_hv_buff, m_hNext_buff, m_huNext_buff, m_hvNext_buff};
+    t_real const *l_host[6] = {i_h, i_hu, i_hv, i_h, i_hu, i_hv};
+    for (unsigned short l_bu = 0; l_bu < 6; l_bu++)
+    {
+        if (l_buffs[l_bu] != nullptr)
+        {
+            err |= clEnqueueWriteBuffer(queue, l_buffs[l_bu], CL_FALSE, 0, m_size, l_host[l_bu], 0, NULL, NULL);
+        }
+    }
+    err |= clFinish(queue);
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not restore the cells on the device (" << err << ")." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    m_step = 0;
+}
+
+std::string tsunami_lab::patches::WavePropagation2d_kernel::getTuningPath() const
+{
+    std::filesystem::path l_directory = getCacheDirectory();
+    if (l_directory.empty())
+    {
+        return std::string();
+    }
+    std::string l_device = getDeviceString(device, CL_DEVICE_NAME) + "\n" + getDeviceString(device, CL_DRIVER_VERSION);
+    return (l_directory / ("tuning_" + hashString(l_device) + ".txt")).string();
+}
+
+/**
+ * Sums the execution times of the kernels of several time steps.
+ *
+ * @param i_events events of the kernels, i_nKernels per time step, released afterwards.
+ * @param i_nKernels number of kernels of a time step.
+ * @param o_seconds will be set to the execution time of each kernel in seconds.
+ **/
+static void sumKernelTimes(std::vector<cl_event> &i_events,
+                           unsigned short i_nKernels,
+                           double *o_seconds)
+{
+    std::fill(o_seconds, o_seconds + i_nKernels, 0.0);
+    for (size_t l_ev = 0; l_ev < i_events.size(); l_ev++)
+    {
+        cl_ulong l_start = 0;
+        cl_ulong l_end = 0;
+        clGetEventProfilingInfo(i_events[l_ev], CL_PROFILING_COMMAND_START, sizeof(l_start), &l_start, NULL);
+        clGetEventProfilingInfo(i_events[l_ev], CL_PROFILING_COMMAND_END, sizeof(l_end), &l_end, NULL);
+        o_seconds[l_ev % i_nKernels] += (l_end - l_start) * 1E-9;
+        clReleaseEvent(i_events[l_ev]);
+    }
+    i_events.clear();
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::tune(t_real i_scaling,
+                                                          t_idx i_nSteps)
+{
+    cl_command_queue l_queue = clCreateCommandQueue(context, device, CL_QUEUE_PROFILING_ENABLE, &err);
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not create a profiling queue for the tuning (" << err << ")." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // each candidate starts from the current cells, which are restored afterwards
+    // they are read before the binding resets the parity of the tiled sweeps
+    std::vector<t_real> l_snapshot[3];
+    cl_mem l_current[3] = {m_h_buff, m_step == 0 ? m_hu_buff : m_huNext_buff, m_step == 0 ? m_hv_buff : m_hvNext_buff};
+    for (unsigned short l_qt = 0; l_qt < 3; l_qt++)
+    {
+        l_snapshot[l_qt].resize(m_size / sizeof(t_real));
+        err |= clEnqueueReadBuffer(queue, l_current[l_qt], CL_TRUE, 0, m_size, l_snapshot[l_qt].data(), 0, NULL, NULL);
+    }
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not read the cells before the tuning (" << err << ")." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // both kinds of kernels are benchmarked, the local memory of the tiled ones is bound for the default tile first
+    if (!m_tiled)
+    {
+        setLocalSizeTiled(0, localWorker[0], localWorker[1]);
+        setLocalSizeTiled(1, localWorker[0], localWorker[1]);
+    }
+    bindUntiledKernels();
+    bindTiledKernels();
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not bind the arguments of the kernels for the tuning." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    // the kernels bound for the tuning do not have a scaling yet
+    m_scaling = std::numeric_limits<t_real>::quiet_NaN();
+    bindScaling(i_scaling);
+
+    // powers of two, {0, 0} leaves the work-group size of the untiled kernels to the runtime
+    std::vector<std::pair<size_t, size_t>> l_candidates = {{0, 0}};
+    for (size_t l_y = 1; l_y <= 64; l_y *= 2)
+    {
+        for (size_t l_x = 1; l_x <= 256; l_x *= 2)
+        {
+            l_candidates.push_back({l_x, l_y});
+        }
+    }
+
+    cl_kernel l_untiled[4] = {knetUpdatesX, kupdateCellsX, knetUpdatesY, kupdateCellsY};
+    char const *l_names[6] = {KERNEL_X_EDGES_FUNC, KERNEL_X_CELLS_FUNC, KERNEL_Y_EDGES_FUNC, KERNEL_Y_CELLS_FUNC,
+                              KERNEL_X_TILED_FUNC, KERNEL_Y_TILED_FUNC};
+    double l_nCellUpdates = double(m_nCells_x) * m_nCells_y * i_nSteps;
+    double l_bestSeconds[6];
+    std::pair<size_t, size_t> l_best[6];
+    std::fill(l_bestSeconds, l_bestSeconds + 6, std::numeric_limits<double>::infinity());
+    std::vector<cl_event> l_events;
+
+    std::cout << "Tuning the work-group sizes with " << i_nSteps << " time steps per candidate" << std::endl;
+    for (unsigned short l_mo = 0; l_mo < 2; l_mo++)
+    {
+        m_tiled = l_mo == 1;
+        unsigned short l_nKernels = m_tiled ? 2 : 4;
+        unsigned short l_offset = m_tiled ? 4 : 0;
+
+        for (std::pair<size_t, size_t> const &l_candidate : l_candidates)
+        {
+            // a candidate has to fit all kernels of the time step
+            bool l_fits = true;
+            for (unsigned short l_ke = 0; l_ke < l_nKernels; l_ke++)
+            {
+                cl_kernel l_kernel = m_tiled ? m_tiledKernels[0][l_ke] : l_untiled[l_ke];
+                bool l_runtime = !m_tiled && l_candidate.first == 0;
+                l_fits = l_fits && (l_runtime || fitsWorkGroup(l_kernel, l_candidate.first, l_candidate.second, m_tiled));
+            }
+            if (!l_fits)
+            {
+                continue;
+            }
+            for (unsigned short l_ke = 0; l_ke < l_nKernels; l_ke++)
+            {
+                if (m_tiled)
+                {
+                    setLocalSizeTiled(l_ke, l_candidate.first, l_candidate.second);
+                }
+                else
+                {
+                    setLocalSizeUntiled(l_ke, l_candidate.first, l_candidate.second);
+                }
+            }
+            if (m_tiled)
+            {
+                bindLocalMemory();
+            }
+            restoreCells(l_snapshot[0].data(), l_snapshot[1].data(), l_snapshot[2].data());
+
+            // the first step warms up the caches of the device and is not measured
+            enqueueTimeStep(l_queue);
+            l_events.resize(l_nKernels * i_nSteps);
+            for (t_idx l_st = 0; l_st < i_nSteps; l_st++)
+            {
+                enqueueTimeStep(l_queue, l_events.data() + l_nKernels * l_st);
+            }
+            clFinish(l_queue);
+
+            double l_seconds[4];
+            sumKernelTimes(l_events, l_nKernels, l_seconds);
+            for (unsigned short l_ke = 0; l_ke < l_nKernels; l_ke++)
+            {
+                std::cout << "  " << l_names[l_offset + l_ke] << " ";
+                if (l_candidate.first == 0)
+                {
+                    std::cout << "runtime";
+                }
+                else
+                {
+                    std::cout << l_candidate.first << " x " << l_candidate.second;
+                }
+                std::cout << ": " << l_nCellUpdates / l_seconds[l_ke] << " cell updates per second" << std::endl;
+
+                if (l_seconds[l_ke] < l_bestSeconds[l_offset + l_ke])
+                {
+                    l_bestSeconds[l_offset + l_ke] = l_seconds[l_ke];
+                    l_best[l_offset + l_ke] = l_candidate;
+                }
+            }
+        }
+    }
+    clReleaseCommandQueue(l_queue);
+
+    if (l_bestSeconds[0] == std::numeric_limits<double>::infinity() ||
+        l_bestSeconds[4] == std::numeric_limits<double>::infinity())
+    {
+        std::cerr << "Error: No work-group size fits the kernels of the device." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // fastest size of each kernel, the untiled and the tiled time step compete with their fastest sizes
+    for (unsigned short l_ke = 0; l_ke < 4; l_ke++)
+    {
+        setLocalSizeUntiled(l_ke, l_best[l_ke].first, l_best[l_ke].second);
+    }
+    setLocalSizeTiled(0, l_best[4].first, l_best[4].second);
+    setLocalSizeTiled(1, l_best[5].first, l_best[5].second);
+    bindLocalMemory();
+    double l_untiledSeconds = l_bestSeconds[0] + l_bestSeconds[1] + l_bestSeconds[2] + l_bestSeconds[3];
+    double l_tiledSeconds = l_bestSeconds[4] + l_bestSeconds[5];
+    m_tiled = l_tiledSeconds < l_untiledSeconds;
+    std::cout << "Selected the " << (m_tiled ? "tiled" : "untiled") << " kernels: "
+              << l_nCellUpdates / std::min(l_untiledSeconds, l_tiledSeconds) << " cell updates per second" << std::endl;
+
+    restoreCells(l_snapshot[0].data(), l_snapshot[1].data(), l_snapshot[2].data());
+    m_scaling = std::numeric_limits<t_real>::quiet_NaN();
+
+    // stored for later runs on the device
+    std::string l_path = getTuningPath();
+    if (l_path.empty())
+    {
+        return;
+    }
+    std::error_code l_error;
+    std::filesystem::create_directories(std::filesystem::path(l_path).parent_path(), l_error);
+    std::ofstream l_out(l_path);
+    l_out << "device: " << getDeviceString(device, CL_DEVICE_NAME) << "\n"
+          << "driver: " << getDeviceString(device, CL_DRIVER_VERSION) << "\n"
+          << "mode: " << (m_tiled ? "tiled" : "untiled") << "\n";
+    for (unsigned short l_ke = 0; l_ke < 6; l_ke++)
+    {
+        l_out << l_names[l_ke] << " " << l_best[l_ke].first << " " << l_best[l_ke].second << "\n";
+    }
+    l_out.close();
+    if (l_out)
+    {
+        std::cout << "Work-group sizes stored in " << l_path << std::endl;
+    }
+    else
+    {
+        std::cout << "Could not store the work-group sizes in " << l_path << std::endl;
+    }
+}
+
+bool tsunami_lab::patches::WavePropagation2d_kernel::loadTuning()
+{
+    std::string l_path = getTuningPath();
+    std::ifstream l_in(l_path);
+    if (l_path.empty() || !l_in)
+    {
+        return false;
+    }
+
+    // sizes of another device or driver are retuned
+    std::string l_device;
+    std::string l_driver;
+    std::string l_mode;
+    std::getline(l_in, l_device);
+    std::getline(l_in, l_driver);
+    std::getline(l_in, l_mode);
+    if (l_device != "device: " + getDeviceString(device, CL_DEVICE_NAME) ||
+        l_driver != "driver: " + getDeviceString(device, CL_DRIVER_VERSION) ||
+        (l_mode != "mode: tiled" && l_mode != "mode: untiled"))
+    {
+        std::cout << "Tuned work-group sizes " << l_path << " are outdated, ignoring them" << std::endl;
+        return false;
+    }
+
+    // the stored sizes are checked against the limits of the kernels on the device before they are applied
+    createTiledKernels();
+    cl_kernel l_kernels[6] = {knetUpdatesX, kupdateCellsX, knetUpdatesY, kupdateCellsY, m_tiledKernels[0][0], m_tiledKernels[0][1]};
+    char const *l_names[6] = {KERNEL_X_EDGES_FUNC, KERNEL_X_CELLS_FUNC, KERNEL_Y_EDGES_FUNC, KERNEL_Y_CELLS_FUNC,
+                              KERNEL_X_TILED_FUNC, KERNEL_Y_TILED_FUNC};
+    size_t l_sizes[6][2];
+    for (unsigned short l_ke = 0; l_ke < 6; l_ke++)
+    {
+        std::string l_name;
+        l_in >> l_name >> l_sizes[l_ke][0] >> l_sizes[l_ke][1];
+        bool l_runtime = l_ke < 4 && l_sizes[l_ke][0] == 0 && l_sizes[l_ke][1] == 0;
+        if (!l_in || l_name != l_names[l_ke] ||
+            !(l_runtime || fitsWorkGroup(l_kernels[l_ke], l_sizes[l_ke][0], l_sizes[l_ke][1], l_ke >= 4)))
+        {
+            std::cout << "Tuned work-group sizes " << l_path << " are invalid, ignoring them" << std::endl;
+            return false;
+        }
+    }
+
+    for (unsigned short l_ke = 0; l_ke < 4; l_ke++)
+    {
+        setLocalSizeUntiled(l_ke, l_sizes[l_ke][0], l_sizes[l_ke][1]);
+    }
+    setLocalSizeTiled(0, l_sizes[4][0], l_sizes[4][1]);
+    setLocalSizeTiled(1, l_sizes[5][0], l_sizes[5][1]);
+    m_tiled = l_mode == "mode: tiled";
+    std::cout << "Tuned work-group sizes: " << l_path << std::endl;
+    return true;
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::timeStep(double i_scaling)
+{
+    bindScaling(i_scaling);
+    enqueueTimeStep(queue);
+}
+
+void tsunami_lab::patches::WavePropagation2d_kernel::timeSteps(t_idx i_nSteps,
+                                                               double i_scaling)
+{
+    bindScaling(i_scaling);
+    for (t_idx l_st = 0; l_st < i_nSteps; l_st++)
+    {
+        enqueueTimeStep(queue);
+    }
+
+    // submit the steps to the device, the host continues until getData
+    clFlush(queue);
 }
 
 void tsunami_lab::patches::WavePropagation2d_kernel::setData()
 {
-    // set initial data
-    m_h_buff = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), m_h, &err);
-    m_hu_buff = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), m_hu, &err);
-    m_hv_buff = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), m_hv, &err);
-    m_b_buff = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), m_b, &err);
-    m_hTemp_buff = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), NULL, &err);
-    m_huvTemp_buff = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), NULL, &err);
+    // set initial data, the uploads from the pinned memory are finished before the first time step
+    cl_mem *l_buffs[4] = {&m_h_buff, &m_hu_buff, &m_hv_buff, &m_b_buff};
+    t_real *l_host[4] = {m_h, m_hu, m_hv, m_b};
+    for (unsigned short l_qt = 0; l_qt < 4; l_qt++)
+    {
+        cl_int l_err = CL_SUCCESS;
+        *l_buffs[l_qt] = clCreateBuffer(context, l_qt < 3 ? CL_MEM_READ_WRITE : CL_MEM_READ_ONLY, m_size, NULL, &l_err);
+        if (l_err == CL_SUCCESS)
+        {
+            l_err = clEnqueueWriteBuffer(queue, *l_buffs[l_qt], CL_FALSE, 0, m_size, l_host[l_qt], 0, NULL, NULL);
+        }
+        if (l_err != CL_SUCCESS)
+        {
+            std::cerr << "Error: Could not copy the cells to the device (" << l_err << ")." << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // bind the buffers and sizes once, the time steps only launch the kernels
+    if (m_tiled)
+    {
+        bindTiledKernels();
+    }
+    else
+    {
+        bindUntiledKernels();
+    }
+
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not bind the arguments of the kernels." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    m_scaling = std::numeric_limits<t_real>::quiet_NaN();
+    clFinish(queue);
 }
 
 void tsunami_lab::patches::WavePropagation2d_kernel::getData()
 {
+    // the reads are enqueued behind the pending time steps, a single synchronization waits for both
+    clEnqueueReadBuffer(queue, m_h_buff, CL_FALSE, 0, m_size, m_h, 0, NULL, NULL);
+    // after an odd number of tiled steps the momenta are in the next buffers
+    clEnqueueReadBuffer(queue, m_step == 0 ? m_hv_buff : m_hvNext_buff, CL_FALSE, 0, m_size, m_hv, 0, NULL, NULL);
+    clEnqueueReadBuffer(queue, m_step == 0 ? m_hu_buff : m_huNext_buff, CL_FALSE, 0, m_size, m_hu, 0, NULL, NULL);
     clFinish(queue);
-    clEnqueueReadBuffer(queue, m_h_buff, CL_TRUE, 0, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), m_h, 0, NULL, NULL);
-    clEnqueueReadBuffer(queue, m_hv_buff, CL_TRUE, 0, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), m_hv, 0, NULL, NULL);
-    clEnqueueReadBuffer(queue, m_hu_buff, CL_TRUE, 0, sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2), m_hu, 0, NULL, NULL);
-    clFinish(queue);
+}
+
+bool tsunami_lab::patches::WavePropagation2d_kernel::getCoarseData(t_idx i_div,
+                                                                   t_real *o_h,
+                                                                   t_real *o_hu,
+                                                                   t_real *o_hv)
+{
+    getCoarseDataAsync(i_div, o_h, o_hu, o_hv).wait();
+    return true;
+}
+
+/**
+ * Readback of an averaged output, completed by the callback of its read event.
+ **/
+struct CoarseTransfer
+{
+    //! pinned memory the compact buffer is read to
+    tsunami_lab::t_real const *m_pinned;
+    //! number of blocks of a field
+    size_t m_nCoarse;
+    //! output arrays of height and momenta
+    tsunami_lab::t_real *m_out[3];
+    //! set once the output arrays are filled
+    std::promise<void> m_done;
+};
+
+/**
+ * Copies the read fields from the pinned memory to the output arrays, called by the runtime once the read finished.
+ *
+ * @param i_status execution status of the read.
+ * @param i_transfer transfer of the read.
+ **/
+static void CL_CALLBACK completeCoarseTransfer(cl_event,
+                                               cl_int i_status,
+                                               void *i_transfer)
+{
+    CoarseTransfer *l_transfer = static_cast<CoarseTransfer *>(i_transfer);
+    if (i_status != CL_COMPLETE)
+    {
+        std::cerr << "Error: The readback of the averaged cells failed (" << i_status << ")." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    for (unsigned short l_qt = 0; l_qt < 3; l_qt++)
+    {
+        std::copy(l_transfer->m_pinned + l_qt * l_transfer->m_nCoarse,
+                  l_transfer->m_pinned + (l_qt + 1) * l_transfer->m_nCoarse,
+                  l_transfer->m_out[l_qt]);
+    }
+    l_transfer->m_done.set_value();
+    delete l_transfer;
+}
+
+std::shared_future<void> tsunami_lab::patches::WavePropagation2d_kernel::getCoarseDataAsync(t_idx i_div,
+                                                                                           t_real *o_h,
+                                                                                           t_real *o_hu,
+                                                                                           t_real *o_hv)
+{
+    size_t l_coarseSize[2] = {m_nCells_x / i_div, m_nCells_y / i_div};
+    size_t l_nCoarse = l_coarseSize[0] * l_coarseSize[1];
+    CoarseTransfer *l_transfer = new CoarseTransfer{nullptr, l_nCoarse, {o_h, o_hu, o_hv}, std::promise<void>()};
+    std::shared_future<void> l_done = l_transfer->m_done.get_future().share();
+    if (l_nCoarse == 0)
+    {
+        l_transfer->m_done.set_value();
+        delete l_transfer;
+        return l_done;
+    }
+
+    // the compact buffers of the previous output are reused
+    if (m_coarseTransfer.valid())
+    {
+        m_coarseTransfer.wait();
+    }
+
+    // the compact buffer holds the three fields one after another
+    err = CL_SUCCESS;
+    if (i_div != m_coarseDiv)
+    {
+        if (m_coarse_buff != nullptr)
+        {
+            clReleaseMemObject(m_coarse_buff);
+            unmapHostBuffer(m_coarseHost_buff, m_coarseHost);
+        }
+        cl_int l_err = CL_SUCCESS;
+        m_coarse_buff = clCreateBuffer(context, CL_MEM_WRITE_ONLY, 3 * sizeof(float) * l_nCoarse, NULL, &l_err);
+        err |= l_err;
+        m_coarseHost = mapHostBuffer(3 * sizeof(float) * l_nCoarse, m_coarseHost_buff);
+        m_coarseDiv = i_div;
+    }
+    l_transfer->m_pinned = m_coarseHost;
+
+    // after an odd number of tiled steps the momenta are in the next buffers
+    cl_ulong l_div = i_div;
+    err |= clSetKernelArg(kcoarsen, 0, sizeof(cl_mem), &m_h_buff);
+    err |= clSetKernelArg(kcoarsen, 1, sizeof(cl_mem), m_step == 0 ? &m_hu_buff : &m_huNext_buff);
+    err |= clSetKernelArg(kcoarsen, 2, sizeof(cl_mem), m_step == 0 ? &m_hv_buff : &m_hvNext_buff);
+    err |= clSetKernelArg(kcoarsen, 3, sizeof(size_t), &m_nCells_x);
+    err |= clSetKernelArg(kcoarsen, 4, sizeof(size_t), &m_nCells_y);
+    err |= clSetKernelArg(kcoarsen, 5, sizeof(cl_ulong), &l_div);
+    err |= clSetKernelArg(kcoarsen, 6, sizeof(cl_mem), &m_coarse_buff);
+
+    // the kernel runs behind the pending time steps, the later steps only wait for the kernel and not for the readback
+    cl_event l_coarsened = nullptr;
+    cl_event l_read = nullptr;
+    err |= clEnqueueNDRangeKernel(queue, kcoarsen, 2, NULL, l_coarseSize, NULL, 0, NULL, &l_coarsened);
+    err |= clFlush(queue);
+
+    // only the compact buffer crosses the bus, the read to pinned memory is completed by the callback
+    if (err == CL_SUCCESS)
+    {
+        err |= clEnqueueReadBuffer(m_transferQueue, m_coarse_buff, CL_FALSE, 0, 3 * sizeof(float) * l_nCoarse, m_coarseHost, 1, &l_coarsened, &l_read);
+        err |= clSetEventCallback(l_read, CL_COMPLETE, completeCoarseTransfer, l_transfer);
+        err |= clFlush(m_transferQueue);
+    }
+    for (cl_event l_event : {l_coarsened, l_read})
+    {
+        if (l_event != nullptr)
+        {
+            clReleaseEvent(l_event);
+        }
+    }
+
+    if (err != CL_SUCCESS)
+    {
+        std::cerr << "Error: Could not read the averaged cells from the device (" << err << ")." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    m_coarseTransfer = l_done;
+    return l_done;
 }
 
 void tsunami_lab::patches::WavePropagation2d_kernel::setGhostOutflow(){};
\ No newline at end of file
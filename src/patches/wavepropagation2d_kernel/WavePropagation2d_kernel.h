@@ -10,6 +10,8 @@
 
 #define CL_TARGET_OPENCL_VERSION 300
 #define CL_USE_DEPRECATED_OPENCL_1_2_APIS
+#include <future>
+#include <limits>
 #include <string>
 #include <vector>
 #include "../../plugins/OpenCL/common/inc/CL/cl.h"
@@ -28,7 +30,7 @@ namespace tsunami_lab
 class tsunami_lab::patches::WavePropagation2d_kernel : public WavePropagation
 {
 private:
-    //! current step which indicates the active values in the arrays below
+    //! current step which indicates the active momentum buffers of the tiled time step
     unsigned short m_step = 0;
 
     //! number of cells in x-direction discretizing the computational domain
@@ -49,38 +51,88 @@ private:
     //! state of bottom boundary, 0 = open, 1 = closed
     int m_state_boundary_bottom = 0;
 
-    //! water heights for the current and next time step for all cells
+    //! water heights of all cells, mapped from m_host_buff[0]
     t_real *m_h = nullptr;
-    //! momenta for the current and next time step for all cells in x-direction
+    //! momenta of all cells in x-direction, mapped from m_host_buff[1]
     t_real *m_hu = nullptr;
-    //! momenta for the current and next time step for all cells in y-direction
+    //! momenta of all cells in y-direction, mapped from m_host_buff[2]
     t_real *m_hv = nullptr;
 
-    //! bathymetry for all cells
+    //! bathymetry of all cells, mapped from m_host_buff[3]
     t_real *m_b = nullptr;
 
     cl_device_id device;
     cl_context context;
     cl_program program;
-    cl_kernel ksetGhostOutflowLR;
-    cl_kernel ksetGhostOutflowTB;
-    cl_kernel kcopy;
+    //! edge kernels of the x- and y-sweep, which write the net-updates of each edge
     cl_kernel knetUpdatesX;
     cl_kernel knetUpdatesY;
+    //! cell kernels of the x- and y-sweep, which gather the net-updates of the adjacent edges
+    cl_kernel kupdateCellsX;
+    cl_kernel kupdateCellsY;
+    //! kernel which strips the ghost cells and averages the interior for the output
+    cl_kernel kcoarsen;
+    //! in-order queue, the kernels of consecutive time steps are chained without synchronization
     cl_command_queue queue;
+    //! queue of the readback of the output, which runs concurrently to the time steps in queue
+    cl_command_queue m_transferQueue;
     cl_int i, err;
 
-    cl_mem m_b_buff;
-    cl_mem m_h_buff;
-    cl_mem m_hu_buff;
-    cl_mem m_hv_buff;
-    cl_mem m_hTemp_buff;
-    cl_mem m_huvTemp_buff;
+    //! pinned host memory of height, momenta and bathymetry, mapped for the lifetime of the patch
+    cl_mem m_host_buff[4] = {nullptr, nullptr, nullptr, nullptr};
+
+    cl_mem m_b_buff = nullptr;
+    cl_mem m_h_buff = nullptr;
+    cl_mem m_hu_buff = nullptr;
+    cl_mem m_hv_buff = nullptr;
+    //! net-updates of the edges of a sweep: left/down height, left/down momentum, right/up height, right/up momentum
+    cl_mem m_netUpdates_buff[4] = {nullptr, nullptr, nullptr, nullptr};
+
+    //! buffers written by the tiled sweeps: heights of the x-sweep, momenta of every other time step
+    cl_mem m_hNext_buff = nullptr;
+    cl_mem m_huNext_buff = nullptr;
+    cl_mem m_hvNext_buff = nullptr;
+
+    //! compact buffer of the averaged heights and momenta, only this buffer is read back by getCoarseData
+    cl_mem m_coarse_buff = nullptr;
+
+    //! pinned host memory the compact buffer is read to and its mapping
+    cl_mem m_coarseHost_buff = nullptr;
+    t_real *m_coarseHost = nullptr;
+
+    //! number of cells of a block in each direction the compact buffers were created for, 0 if none
+    t_idx m_coarseDiv = 0;
+
+    //! readback of the last averaged output, the compact buffers are reused once it is ready
+    std::shared_future<void> m_coarseTransfer;
+
+    //! kernels of the tiled time step for even and odd steps: x-sweep, y-sweep
+    cl_kernel m_tiledKernels[2][2] = {};
+
+    //! true if the time steps use the tiled kernels
+    bool m_tiled = false;
+
+    //! work-group sizes of the tiled x- and y-sweep
+    size_t m_localSize[2][2] = {};
+
+    //! global sizes of the tiled x- and y-sweep: the interior cells rounded up to whole work-groups
+    size_t m_globalSizeTiled[2][2] = {};
+
+    //! work-group sizes of the untiled kernels (x-edges, x-cells, y-edges, y-cells), 0 x 0 leaves the choice to the runtime
+    size_t m_localSizeUntiled[4][2] = {};
+
+    //! global sizes of the untiled kernels: all cells including the ghost cells rounded up to whole work-groups
+    size_t m_globalSizeUntiled[4][2] = {};
+
+    //! scaling currently bound to the cell kernels, NaN if none is bound
+    t_real m_scaling = std::numeric_limits<t_real>::quiet_NaN();
 
     size_t global_size[2] = {};
+    //! default work-group size of the tiled kernels
     size_t *localWorker;
 
-    t_idx m_size = sizeof(float) * (m_nCells_x + 2) * (m_nCells_y + 2);
+    //! size of a field including the ghost cells in bytes
+    t_idx m_size = 0;
 
     /**
      * @brief Get the 2d Coordinates of the 1d array (x-y grid is being made flat into one line)
@@ -96,6 +148,117 @@ private:
         return i_x + i_y * getStride();
     };
 
+    /**
+     * Creates a buffer in pinned host memory and maps it.
+     *
+     * @param i_size size of the buffer in bytes.
+     * @param o_buff will be set to the buffer, which has to be unmapped by unmapHostBuffer.
+     * @return mapped memory of the buffer.
+     **/
+    t_real *mapHostBuffer(size_t i_size,
+                          cl_mem &o_buff);
+
+    /**
+     * Unmaps and releases a buffer created by mapHostBuffer.
+     *
+     * @param io_buff buffer, set to nullptr.
+     * @param i_mapped mapped memory of the buffer.
+     **/
+    void unmapHostBuffer(cl_mem &io_buff,
+                         t_real *i_mapped);
+
+    /**
+     * Binds the scaling to the cell kernels if it differs from the bound one.
+     *
+     * @param i_scaling scaling of the time step (dt / dx).
+     **/
+    void bindScaling(t_real i_scaling);
+
+    /**
+     * Enqueues the kernels of one time step without waiting for them.
+     *
+     * @param i_queue queue of the kernels.
+     * @param o_events if not nullptr, will be set to the events of the kernels in the order of the work-group sizes.
+     **/
+    void enqueueTimeStep(cl_command_queue i_queue,
+                         cl_event *o_events = nullptr);
+
+    /**
+     * Checks if a work-group size fits a kernel and, for the tiled sweeps, the local memory of the device.
+     *
+     * @param i_kernel kernel.
+     * @param i_localSize_x number of work-items of a work-group in x-direction.
+     * @param i_localSize_y number of work-items of a work-group in y-direction.
+     * @param i_tiled true if the kernel is a tiled sweep, which stages its tile in local memory.
+     * @return true if the kernel can be launched with the work-group size.
+     **/
+    bool fitsWorkGroup(cl_kernel i_kernel,
+                       size_t i_localSize_x,
+                       size_t i_localSize_y,
+                       bool i_tiled) const;
+
+    /**
+     * Sets the work-group size of an untiled kernel and rounds its global size up to whole work-groups.
+     *
+     * @param i_kernel id of the kernel: x-edges, x-cells, y-edges, y-cells.
+     * @param i_localSize_x number of work-items of a work-group in x-direction, 0 leaves the choice to the runtime.
+     * @param i_localSize_y number of work-items of a work-group in y-direction, 0 leaves the choice to the runtime.
+     **/
+    void setLocalSizeUntiled(unsigned short i_kernel,
+                             size_t i_localSize_x,
+                             size_t i_localSize_y);
+
+    /**
+     * Sets the work-group size of a tiled sweep and rounds its global size up to whole work-groups.
+     *
+     * @param i_sweep 0 for the x-sweep, 1 for the y-sweep.
+     * @param i_localSize_x number of cells of a work-group in x-direction.
+     * @param i_localSize_y number of cells of a work-group in y-direction.
+     **/
+    void setLocalSizeTiled(unsigned short i_sweep,
+                           size_t i_localSize_x,
+                           size_t i_localSize_y);
+
+    /**
+     * Binds the local memory of the tiled sweeps, which depends on their work-group sizes.
+     **/
+    void bindLocalMemory();
+
+    /**
+     * Creates the net-update buffers if they do not exist and binds the arguments of the untiled kernels.
+     **/
+    void bindUntiledKernels();
+
+    /**
+     * Creates the tiled kernels of even and odd steps if they do not exist.
+     **/
+    void createTiledKernels();
+
+    /**
+     * Creates the buffers written by the tiled sweeps and the tiled kernels of even and odd steps if they do not exist,
+     * and binds their arguments.
+     **/
+    void bindTiledKernels();
+
+    /**
+     * Writes cells to the buffers of the untiled and, if bound, the tiled kernels and waits for the copies.
+     * The next time step starts with the even tiled sweeps.
+     *
+     * @param i_h water heights, including the ghost cells.
+     * @param i_hu momenta in x-direction.
+     * @param i_hv momenta in y-direction.
+     **/
+    void restoreCells(t_real const *i_h,
+                      t_real const *i_hu,
+                      t_real const *i_hv);
+
+    /**
+     * Gets the file of the tuned work-group sizes of the device.
+     *
+     * @return path of the file, empty if there is no cache directory.
+     **/
+    std::string getTuningPath() const;
+
 public:
     /**
      *
@@ -121,17 +284,73 @@ public:
     ~WavePropagation2d_kernel();
 
     /**
-     * Performs a time step.
+     * Enqueues a time step, the host does not wait for the device.
      *
      * @param i_scaling scaling of the time step (dt / dx).
      **/
-    void timeStep(t_real i_scaling);
+    void timeStep(double i_scaling);
+
+    /**
+     * Enqueues several time steps with the same scaling and submits them to the device without waiting.
+     *
+     * @param i_nSteps number of time steps.
+     * @param i_scaling scaling of the time steps (dt / dx).
+     **/
+    void timeSteps(t_idx i_nSteps,
+                   double i_scaling);
 
     /**
      * Sets the values of the ghost cells according to outflow boundary conditions.
      **/
     void setGhostOutflow();
 
+    /**
+     * Selects the tiled kernels, which stage a tile of cells and its halo in local memory.
+     * Has to be called before setData.
+     *
+     * @param i_localSize_x number of cells of a work-group in x-direction, 0 selects the untiled kernels.
+     * @param i_localSize_y number of cells of a work-group in y-direction, 0 selects the untiled kernels.
+     **/
+    void setTiling(t_idx i_localSize_x,
+                   t_idx i_localSize_y);
+
+    /**
+     * Benchmarks the work-group sizes of the untiled kernels and the tile sizes of the tiled sweeps on the device.
+     * Selects the fastest size of each kernel and the faster of the untiled and the tiled time step, and stores them in
+     * a file of the device, which loadTuning reads in later runs. Prints the cell updates per second of each candidate.
+     * Has to be called after setData. Every candidate starts from the cells at the call, which are restored afterwards.
+     *
+     * @param i_scaling scaling of the benchmarked time steps (dt / dx).
+     * @param i_nSteps number of time steps per candidate.
+     **/
+    void tune(t_real i_scaling,
+              t_idx i_nSteps);
+
+    /**
+     * Selects the work-group sizes stored by tune for this device.
+     * Sizes which exceed the work-group or local memory limits of the kernels on the device are ignored.
+     * Has to be called before setData.
+     *
+     * @return true if tuned sizes exist, false if the tiling is unchanged.
+     **/
+    bool loadTuning();
+
+    /**
+     * Gets the default work-group size of the tiled kernels, derived from the device's maximum work-group size.
+     *
+     * @param o_localSize_x will be set to the number of cells of a work-group in x-direction.
+     * @param o_localSize_y will be set to the number of cells of a work-group in y-direction.
+     **/
+    void getDefaultTiling(t_idx &o_localSize_x,
+                          t_idx &o_localSize_y) const
+    {
+        o_localSize_x = localWorker[0];
+        o_localSize_y = localWorker[1];
+    }
+
+    /**
+     * Copies the cells to the device and binds the buffers and sizes to the kernels.
+     **/
     void setData();
 
     /**
@@ -144,6 +363,16 @@ public:
         return m_nCells_x + 2;
     }
 
+    /**
+     * The kernels do not reduce the wave speeds.
+     *
+     * @return 0, the maximum wave speed is unknown.
+     **/
+    double getMaxWaveSpeed()
+    {
+        return 0;
+    }
+
     /**
      * Gets cells' water heights.
      *
@@ -193,7 +422,7 @@ public:
      **/
     void setHeight(t_idx i_ix,
                    t_idx i_iy,
-                   t_real i_h)
+                   double i_h)
     {
         m_h[getCoordinates(i_ix + 1, i_iy + 1)] = i_h;
     }
@@ -207,7 +436,7 @@ public:
      **/
     void setMomentumX(t_idx i_ix,
                       t_idx i_iy,
-                      t_real i_hu)
+                      double i_hu)
     {
         m_hu[getCoordinates(i_ix + 1, i_iy + 1)] = i_hu;
     }
@@ -221,7 +450,7 @@ public:
      **/
     void setMomentumY(t_idx i_ix,
                       t_idx i_iy,
-                      t_real i_hv)
+                      double i_hv)
     {
         m_hv[getCoordinates(i_ix + 1, i_iy + 1)] = i_hv;
     }
@@ -235,12 +464,47 @@ public:
      */
     void setBathymetry(t_idx i_ix,
                        t_idx i_iy,
-                       t_real i_b)
+                       double i_b)
     {
         m_b[getCoordinates(i_ix + 1, i_iy + 1)] = i_b;
     }
 
+    /**
+     * Waits for the enqueued time steps and copies height and momenta from the device.
+     **/
     void getData();
+
+    /**
+     * Averages the interior over blocks of cells on the device and copies only the compact result.
+     * Waits for the enqueued time steps, the cells returned by the getters are not updated.
+     * See getCoarseDataAsync.
+     *
+     * @param i_div number of cells of a block in x- and y-direction.
+     * @param o_h will be set to the averaged heights, block (ix, iy) at ix + iy * (#cells in x-direction / i_div).
+     * @param o_hu will be set to the averaged momenta in x-direction.
+     * @param o_hv will be set to the averaged momenta in y-direction.
+     * @return true.
+     **/
+    bool getCoarseData(t_idx i_div,
+                       t_real *o_h,
+                       t_real *o_hu,
+                       t_real *o_hv);
+
+    /**
+     * Enqueues the averaging behind the pending time steps and its readback on the transfer queue without waiting.
+     * Later time steps may be enqueued right away, they run while the compact result is transferred.
+     * Waits for the readback of the previous call, whose buffers are reused.
+     *
+     * @param i_div number of cells of a block in x- and y-direction.
+     * @param o_h will be set to the averaged heights once the future is ready, has to stay valid until then.
+     * @param o_hu will be set to the averaged momenta in x-direction.
+     * @param o_hv will be set to the averaged momenta in y-direction.
+     * @return future which is ready once the output arrays are set.
+     **/
+    std::shared_future<void> getCoarseDataAsync(t_idx i_div,
+                                                t_real *o_h,
+                                                t_real *o_hu,
+                                                t_real *o_hv);
 };
 
 #endif
\ No newline at end of file
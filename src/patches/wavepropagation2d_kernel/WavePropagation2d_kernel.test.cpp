@@ -7,10 +7,57 @@
  **/
 
 #include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
 #include "WavePropagation2d_kernel.h"
+#include "../wavepropagation2d/WavePropagation2d.h"
 #include "../../constants.h"
 
-TEST_CASE("Test the 2d wave propagation fwave-solver x-direction. KERNEL", "[WaveProp2dFWavedXKernel]")
+/**
+ * Points the cache of the kernel binaries and tuned work-group sizes to an empty temporary directory for the
+ * duration of a test case, such that the tests neither read nor write the cache of the user.
+ **/
+class CacheDirectory
+{
+protected:
+    //! temporary cache directory
+    std::filesystem::path m_cache = std::filesystem::temp_directory_path() / "tsunami_lab_kernel_test";
+
+private:
+    //! cache directory of the environment before the test case, empty if unset
+    std::string m_previous;
+
+public:
+    CacheDirectory()
+    {
+        if (char const *l_previous = std::getenv("TSUNAMI_LAB_CACHE"))
+        {
+            m_previous = l_previous;
+        }
+        std::filesystem::remove_all(m_cache);
+        setenv("TSUNAMI_LAB_CACHE", m_cache.c_str(), 1);
+    }
+
+    ~CacheDirectory()
+    {
+        std::filesystem::remove_all(m_cache);
+        if (m_previous.empty())
+        {
+            unsetenv("TSUNAMI_LAB_CACHE");
+        }
+        else
+        {
+            setenv("TSUNAMI_LAB_CACHE", m_previous.c_str(), 1);
+        }
+    }
+};
+
+TEST_CASE_METHOD(CacheDirectory, "Test the 2d wave propagation fwave-solver x-direction. KERNEL", "[WaveProp2dFWavedXKernel]")
 {
     /*
      * Test case:
@@ -123,7 +170,7 @@ TEST_CASE("Test the 2d wave propagation fwave-solver x-direction. KERNEL", "[Wav
     }
 }
 
-TEST_CASE("Test the 2d wave propagation fwave-solver y-direction. KERNEL", "[WaveProp2dFWavedYKernel]")
+TEST_CASE_METHOD(CacheDirectory, "Test the 2d wave propagation fwave-solver y-direction. KERNEL", "[WaveProp2dFWavedYKernel]")
 {
     /*
      * Test case:
@@ -236,7 +283,7 @@ TEST_CASE("Test the 2d wave propagation fwave-solver y-direction. KERNEL", "[Wav
     }
 }
 
-TEST_CASE("Test the 2d wave propagation roe-solver x-direction. KERNEL", "[WaveProp2dRoedXKernel]")
+TEST_CASE_METHOD(CacheDirectory, "Test the 2d wave propagation roe-solver x-direction. KERNEL", "[WaveProp2dRoedXKernel]")
 {
     /*
      * Test case:
@@ -349,7 +396,7 @@ TEST_CASE("Test the 2d wave propagation roe-solver x-direction. KERNEL", "[WaveP
     }
 }
 
-TEST_CASE("Test the 2d wave propagation roe-solver y-direction. KERNEL", "[WaveProp2dRoeYKERNEL]")
+TEST_CASE_METHOD(CacheDirectory, "Test the 2d wave propagation roe-solver y-direction. KERNEL", "[WaveProp2dRoeYKERNEL]")
 {
     /*
      * Test case:
@@ -460,4 +507,424 @@ TEST_CASE("Test the 2d wave propagation roe-solver y-direction. KERNEL", "[WaveP
             REQUIRE(m_waveProp.getBathymetry()[l_cx + l_cy * stride] == Approx(0));
         }
     }
-}
\ No newline at end of file
+}
+TEST_CASE_METHOD(CacheDirectory, "Test several enqueued time steps of the 2d wave propagation. KERNEL", "[WaveProp2dTimeStepsKernel]")
+{
+    /*
+     * Test case:
+     *
+     *   Dam-break in x-direction on 40 x 20 cells, closed left boundary.
+     *   One patch performs ten single time steps, the other enqueues them with one call.
+     *   The steps are only synchronized by getData, the sweeps use no atomics and the results have to match bitwise.
+     */
+    tsunami_lab::patches::WavePropagation2d_kernel l_single(40, 20, 1, 0, 0, 0);
+    tsunami_lab::patches::WavePropagation2d_kernel l_chained(40, 20, 1, 0, 0, 0);
+
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < 20; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 0; l_cx < 40; l_cx++)
+        {
+            tsunami_lab::t_real l_h = l_cx < 20 ? 10 : 8;
+            for (tsunami_lab::patches::WavePropagation2d_kernel *l_waveProp : {&l_single, &l_chained})
+            {
+                l_waveProp->setHeight(l_cx, l_cy, l_h);
+                l_waveProp->setMomentumX(l_cx, l_cy, 0);
+                l_waveProp->setMomentumY(l_cx, l_cy, 0);
+                l_waveProp->setBathymetry(l_cx, l_cy, 0);
+            }
+        }
+    }
+    l_single.setData();
+    l_chained.setData();
+
+    for (int l_st = 0; l_st < 10; l_st++)
+    {
+        l_single.timeStep(0.05);
+    }
+    l_chained.timeSteps(10, 0.05);
+
+    l_single.getData();
+    l_chained.getData();
+
+    tsunami_lab::t_idx l_stride = l_single.getStride();
+    for (tsunami_lab::t_idx l_cy = 1; l_cy < 21; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 1; l_cx < 41; l_cx++)
+        {
+            REQUIRE(l_chained.getHeight()[l_cx + l_cy * l_stride] == l_single.getHeight()[l_cx + l_cy * l_stride]);
+            REQUIRE(l_chained.getMomentumX()[l_cx + l_cy * l_stride] == l_single.getMomentumX()[l_cx + l_cy * l_stride]);
+            REQUIRE(l_chained.getMomentumY()[l_cx + l_cy * l_stride] == l_single.getMomentumY()[l_cx + l_cy * l_stride]);
+        }
+    }
+
+    // the wave has left the dam
+    REQUIRE(l_chained.getHeight()[20 + 10 * l_stride] < 10);
+    REQUIRE(l_chained.getHeight()[21 + 10 * l_stride] > 8);
+}
+
+TEST_CASE_METHOD(CacheDirectory, "Test the tiled 2d wave propagation against the untiled one. KERNEL", "[WaveProp2dTiledKernel]")
+{
+    /*
+     * Test case:
+     *
+     *   Circular hump on a slope with a dry shore on 37 x 23 cells, closed left and bottom boundaries.
+     *   The work-groups of 8 x 4 cells do not divide the grid. After an odd number of steps the momenta
+     *   of the tiled patch are in the second buffers, the results have to match the untiled kernels bitwise.
+     */
+    tsunami_lab::patches::WavePropagation2d_kernel l_untiled(37, 23, 1, 0, 0, 1);
+    tsunami_lab::patches::WavePropagation2d_kernel l_tiled(37, 23, 1, 0, 0, 1);
+    l_tiled.setTiling(8, 4);
+
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < 23; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 0; l_cx < 37; l_cx++)
+        {
+            tsunami_lab::t_real l_b = -10 + 0.3f * l_cx;
+            tsunami_lab::t_real l_dx = tsunami_lab::t_real(l_cx) - 8;
+            tsunami_lab::t_real l_dy = tsunami_lab::t_real(l_cy) - 11;
+            tsunami_lab::t_real l_h = std::max(tsunami_lab::t_real(0), (l_dx * l_dx + l_dy * l_dy < 20 ? 4 : 0) - l_b);
+            for (tsunami_lab::patches::WavePropagation2d_kernel *l_waveProp : {&l_untiled, &l_tiled})
+            {
+                l_waveProp->setHeight(l_cx, l_cy, l_h);
+                l_waveProp->setMomentumX(l_cx, l_cy, 0.1f * l_cy);
+                l_waveProp->setMomentumY(l_cx, l_cy, -0.05f * l_cx);
+                l_waveProp->setBathymetry(l_cx, l_cy, l_b);
+            }
+        }
+    }
+    l_untiled.setData();
+    l_tiled.setData();
+
+    l_untiled.timeSteps(7, 0.05);
+    l_tiled.timeSteps(7, 0.05);
+    l_untiled.getData();
+    l_tiled.getData();
+
+    tsunami_lab::t_idx l_stride = l_tiled.getStride();
+    for (tsunami_lab::t_idx l_cy = 1; l_cy < 24; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 1; l_cx < 38; l_cx++)
+        {
+            REQUIRE(l_tiled.getHeight()[l_cx + l_cy * l_stride] == l_untiled.getHeight()[l_cx + l_cy * l_stride]);
+            REQUIRE(l_tiled.getMomentumX()[l_cx + l_cy * l_stride] == l_untiled.getMomentumX()[l_cx + l_cy * l_stride]);
+            REQUIRE(l_tiled.getMomentumY()[l_cx + l_cy * l_stride] == l_untiled.getMomentumY()[l_cx + l_cy * l_stride]);
+        }
+    }
+}
+
+TEST_CASE_METHOD(CacheDirectory, "Test the downsampling of the 2d wave propagation on the device. KERNEL", "[WaveProp2dCoarseKernel]")
+{
+    /*
+     * Test case:
+     *
+     *   Dam break on 37 x 23 cells with tiled kernels, averaged over blocks of 4 x 4 cells after an odd number of steps.
+     *   The compact output has 9 x 5 blocks, the remaining cells are dropped like in the output on the host.
+     *   The blocks have to match the averages of the cells read back in full. An asynchronous readback
+     *   followed by further time steps has to return the same blocks.
+     */
+    tsunami_lab::patches::WavePropagation2d_kernel l_waveProp(37, 23, 0, 0, 0, 0);
+    l_waveProp.setTiling(8, 4);
+
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < 23; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 0; l_cx < 37; l_cx++)
+        {
+            l_waveProp.setHeight(l_cx, l_cy, l_cx < 15 ? 10 : 8);
+            l_waveProp.setMomentumX(l_cx, l_cy, 0);
+            l_waveProp.setMomentumY(l_cx, l_cy, 0.1f * l_cy);
+            l_waveProp.setBathymetry(l_cx, l_cy, -0.01f * l_cx);
+        }
+    }
+    l_waveProp.setData();
+    l_waveProp.timeSteps(5, 0.05);
+
+    std::vector<tsunami_lab::t_real> l_coarse[3];
+    for (std::vector<tsunami_lab::t_real> &l_quantity : l_coarse)
+    {
+        l_quantity.assign(9 * 5, -1);
+    }
+    REQUIRE(l_waveProp.getCoarseData(4, l_coarse[0].data(), l_coarse[1].data(), l_coarse[2].data()));
+    l_waveProp.getData();
+
+    tsunami_lab::t_real const *l_fine[3] = {l_waveProp.getHeight(),
+                                             l_waveProp.getMomentumX(),
+                                             l_waveProp.getMomentumY()};
+    tsunami_lab::t_idx l_stride = l_waveProp.getStride();
+    for (tsunami_lab::t_idx l_by = 0; l_by < 5; l_by++)
+    {
+        for (tsunami_lab::t_idx l_bx = 0; l_bx < 9; l_bx++)
+        {
+            for (unsigned short l_qt = 0; l_qt < 3; l_qt++)
+            {
+                tsunami_lab::t_real l_sum = 0;
+                for (tsunami_lab::t_idx l_cy = l_by * 4; l_cy < (l_by + 1) * 4; l_cy++)
+                {
+                    for (tsunami_lab::t_idx l_cx = l_bx * 4; l_cx < (l_bx + 1) * 4; l_cx++)
+                    {
+                        l_sum += l_fine[l_qt][(l_cx + 1) + (l_cy + 1) * l_stride];
+                    }
+                }
+                REQUIRE(l_coarse[l_qt][l_bx + l_by * 9] == Approx(l_sum / 16));
+            }
+        }
+    }
+
+    // the block at the dam averages both sides
+    REQUIRE(l_coarse[0][3 + 2 * 9] < 10);
+    REQUIRE(l_coarse[0][3 + 2 * 9] > 8);
+
+    // the time steps enqueued during the readback do not change the requested output
+    std::vector<tsunami_lab::t_real> l_async[3];
+    for (std::vector<tsunami_lab::t_real> &l_quantity : l_async)
+    {
+        l_quantity.assign(9 * 5, -1);
+    }
+    std::shared_future<void> l_readback = l_waveProp.getCoarseDataAsync(4, l_async[0].data(), l_async[1].data(), l_async[2].data());
+    l_waveProp.timeSteps(3, 0.05);
+    l_readback.wait();
+    for (unsigned short l_qt = 0; l_qt < 3; l_qt++)
+    {
+        REQUIRE(l_async[l_qt] == l_coarse[l_qt]);
+    }
+}
+
+TEST_CASE_METHOD(CacheDirectory, "Test the tuned 2d wave propagation against the untuned one. KERNEL", "[WaveProp2dTuneKernel]")
+{
+    /*
+     * Test case:
+     *
+     *   Same hump as above on 37 x 23 cells. After 3 untiled or tiled time steps, i.e. with the tiled momenta in the
+     *   second buffers, the tuning benchmarks the work-group sizes with 4 time steps per candidate and restores the cells.
+     *   The following time steps have to match the untuned kernels bitwise.
+     *   The selection is stored in the temporary cache directory, a second patch on the device has to load it.
+     *   Stored sizes beyond the limits of the device have to be ignored.
+     */
+    tsunami_lab::patches::WavePropagation2d_kernel l_untuned(37, 23, 1, 0, 0, 1);
+    tsunami_lab::patches::WavePropagation2d_kernel l_tunedUntiled(37, 23, 1, 0, 0, 1);
+    tsunami_lab::patches::WavePropagation2d_kernel l_tunedTiled(37, 23, 1, 0, 0, 1);
+    REQUIRE(!l_tunedUntiled.loadTuning());
+    l_tunedTiled.setTiling(8, 4);
+
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < 23; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 0; l_cx < 37; l_cx++)
+        {
+            tsunami_lab::t_real l_b = -10 + 0.3f * l_cx;
+            tsunami_lab::t_real l_dx = tsunami_lab::t_real(l_cx) - 8;
+            tsunami_lab::t_real l_dy = tsunami_lab::t_real(l_cy) - 11;
+            tsunami_lab::t_real l_h = std::max(tsunami_lab::t_real(0), (l_dx * l_dx + l_dy * l_dy < 20 ? 4 : 0) - l_b);
+            for (tsunami_lab::patches::WavePropagation2d_kernel *l_waveProp : {&l_untuned, &l_tunedUntiled, &l_tunedTiled})
+            {
+                l_waveProp->setHeight(l_cx, l_cy, l_h);
+                l_waveProp->setMomentumX(l_cx, l_cy, 0.1f * l_cy);
+                l_waveProp->setMomentumY(l_cx, l_cy, -0.05f * l_cx);
+                l_waveProp->setBathymetry(l_cx, l_cy, l_b);
+            }
+        }
+    }
+    for (tsunami_lab::patches::WavePropagation2d_kernel *l_waveProp : {&l_untuned, &l_tunedUntiled, &l_tunedTiled})
+    {
+        l_waveProp->setData();
+        l_waveProp->timeSteps(3, 0.05);
+    }
+    l_tunedUntiled.tune(0.05, 4);
+    l_tunedTiled.tune(0.05, 4);
+    for (tsunami_lab::patches::WavePropagation2d_kernel *l_waveProp : {&l_untuned, &l_tunedUntiled, &l_tunedTiled})
+    {
+        l_waveProp->timeSteps(7, 0.05);
+        l_waveProp->getData();
+    }
+
+    tsunami_lab::t_idx l_stride = l_untuned.getStride();
+    for (tsunami_lab::patches::WavePropagation2d_kernel *l_tuned : {&l_tunedUntiled, &l_tunedTiled})
+    {
+        for (tsunami_lab::t_idx l_cy = 1; l_cy < 24; l_cy++)
+        {
+            for (tsunami_lab::t_idx l_cx = 1; l_cx < 38; l_cx++)
+            {
+                REQUIRE(l_tuned->getHeight()[l_cx + l_cy * l_stride] == l_untuned.getHeight()[l_cx + l_cy * l_stride]);
+                REQUIRE(l_tuned->getMomentumX()[l_cx + l_cy * l_stride] == l_untuned.getMomentumX()[l_cx + l_cy * l_stride]);
+                REQUIRE(l_tuned->getMomentumY()[l_cx + l_cy * l_stride] == l_untuned.getMomentumY()[l_cx + l_cy * l_stride]);
+            }
+        }
+    }
+
+    tsunami_lab::patches::WavePropagation2d_kernel l_loaded(37, 23, 1, 0, 0, 1);
+    REQUIRE(l_loaded.loadTuning());
+
+    // a tile of 4096 x 4096 work-items exceeds the maximum work-group size of every device
+    for (std::filesystem::directory_entry const &l_entry : std::filesystem::directory_iterator(m_cache))
+    {
+        if (l_entry.path().filename().string().rfind("tuning_", 0) == 0)
+        {
+            std::ifstream l_in(l_entry.path());
+            std::string l_file((std::istreambuf_iterator<char>(l_in)), std::istreambuf_iterator<char>());
+            l_file.replace(l_file.find("sweepXTiledKernel"), std::string::npos, "sweepXTiledKernel 4096 4096\nsweepYTiledKernel 8 4\n");
+            l_in.close();
+            std::ofstream(l_entry.path()) << l_file;
+        }
+    }
+    tsunami_lab::patches::WavePropagation2d_kernel l_invalid(37, 23, 1, 0, 0, 1);
+    REQUIRE(!l_invalid.loadTuning());
+}
+
+TEST_CASE_METHOD(CacheDirectory, "Test the 2d wave propagation on the device against the one on the host. KERNEL", "[WaveProp2dHostKernel]")
+{
+    /*
+     * Test case:
+     *
+     *   Off-center hump on a slope in y-direction with momenta in both directions on 31 x 19 cells,
+     *   open left and bottom boundaries and closed right and top boundaries.
+     *
+     *   The patches store the rows in opposite order: row 0 of the device patch is the bottom row, its ghost cells
+     *   follow the bottom boundary, while row 0 of the host patch is the top row. Row iy of the device patch is row
+     *   18 - iy of the host patch, and the momenta in y-direction have opposite signs.
+     *   After 30 time steps, both have to agree within the accuracy of float.
+     */
+    tsunami_lab::patches::WavePropagation2d_kernel l_device(31, 19, 0, 1, 1, 0);
+    tsunami_lab::patches::WavePropagation2d<> l_host(31, 19, 0, 1, 1, 0);
+
+    // cell (ix, iy) counts the rows from the bottom
+    for (tsunami_lab::t_idx l_iy = 0; l_iy < 19; l_iy++)
+    {
+        for (tsunami_lab::t_idx l_ix = 0; l_ix < 31; l_ix++)
+        {
+            tsunami_lab::t_real l_b = -10 + 0.2f * l_iy;
+            tsunami_lab::t_real l_dx = tsunami_lab::t_real(l_ix) - 9;
+            tsunami_lab::t_real l_dy = tsunami_lab::t_real(l_iy) - 5;
+            tsunami_lab::t_real l_h = (l_dx * l_dx + l_dy * l_dy < 16 ? 5 : 0) - l_b;
+            tsunami_lab::t_real l_hu = 0.1f * l_ix;
+            tsunami_lab::t_real l_hv = 0.2f * l_iy;
+
+            l_device.setHeight(l_ix, l_iy, l_h);
+            l_device.setMomentumX(l_ix, l_iy, l_hu);
+            l_device.setMomentumY(l_ix, l_iy, l_hv);
+            l_device.setBathymetry(l_ix, l_iy, l_b);
+
+            l_host.setHeight(l_ix, 18 - l_iy, l_h);
+            l_host.setMomentumX(l_ix, 18 - l_iy, l_hu);
+            l_host.setMomentumY(l_ix, 18 - l_iy, -l_hv);
+            l_host.setBathymetry(l_ix, 18 - l_iy, l_b);
+        }
+    }
+    l_device.setData();
+
+    l_device.timeSteps(30, 0.02);
+    for (int l_st = 0; l_st < 30; l_st++)
+    {
+        l_host.timeStep(0.02);
+    }
+    l_device.getData();
+
+    tsunami_lab::t_idx l_stride = l_device.getStride();
+    REQUIRE(l_host.getStride() == l_stride);
+    for (tsunami_lab::t_idx l_iy = 0; l_iy < 19; l_iy++)
+    {
+        for (tsunami_lab::t_idx l_ix = 0; l_ix < 31; l_ix++)
+        {
+            tsunami_lab::t_idx l_idDevice = (l_ix + 1) + (l_iy + 1) * l_stride;
+            tsunami_lab::t_idx l_idHost = (l_ix + 1) + (18 - l_iy + 1) * l_stride;
+
+            REQUIRE(l_device.getHeight()[l_idDevice] == Approx(l_host.getHeight()[l_idHost]).margin(1E-3));
+            REQUIRE(l_device.getMomentumX()[l_idDevice] == Approx(l_host.getMomentumX()[l_idHost]).margin(1E-3));
+            REQUIRE(l_device.getMomentumY()[l_idDevice] == Approx(-l_host.getMomentumY()[l_idHost]).margin(1E-3));
+            REQUIRE(l_device.getBathymetry()[l_idDevice] == l_host.getBathymetry()[l_idHost]);
+        }
+    }
+
+    // the hump has spread, and the field is not symmetric in y-direction, i.e. the rows cannot be swapped unnoticed
+    REQUIRE(l_device.getHeight()[10 + 6 * l_stride] < 15);
+    REQUIRE(l_device.getHeight()[10 + 6 * l_stride] != Approx(l_device.getHeight()[10 + 14 * l_stride]).margin(1E-1));
+}
+
+TEST_CASE_METHOD(CacheDirectory, "Test the fallback of the 2d wave propagation to the kernel source. KERNEL", "[WaveProp2dCacheKernel]")
+{
+    /*
+     * Test case:
+     *
+     *   The first patch builds the program from source and caches the binary in the temporary cache directory.
+     *   The cached file is then replaced by a corrupt binary with a matching key, a stale binary whose key names
+     *   another driver, and a file which was truncated within the key. Every following patch has to build the program
+     *   from source again, replace the file by a valid one and compute the same dam break as the first patch.
+     */
+    auto runDamBreak = [](tsunami_lab::patches::WavePropagation2d_kernel &io_waveProp)
+    {
+        for (tsunami_lab::t_idx l_cy = 0; l_cy < 11; l_cy++)
+        {
+            for (tsunami_lab::t_idx l_cx = 0; l_cx < 17; l_cx++)
+            {
+                io_waveProp.setHeight(l_cx, l_cy, l_cx < 8 ? 10 : 8);
+                io_waveProp.setMomentumX(l_cx, l_cy, 0);
+                io_waveProp.setMomentumY(l_cx, l_cy, 0.1f * l_cy);
+                io_waveProp.setBathymetry(l_cx, l_cy, -0.1f * l_cy);
+            }
+        }
+        io_waveProp.setData();
+        io_waveProp.timeSteps(5, 0.05);
+        io_waveProp.getData();
+    };
+
+    tsunami_lab::patches::WavePropagation2d_kernel l_reference(17, 11, 0, 1, 0, 1);
+    runDamBreak(l_reference);
+
+    // the binary is stored behind its key, which ends after the line of the source's hash
+    std::filesystem::path l_path;
+    for (std::filesystem::directory_entry const &l_entry : std::filesystem::directory_iterator(m_cache))
+    {
+        if (l_entry.path().filename().string().rfind("kernel_", 0) == 0)
+        {
+            l_path = l_entry.path();
+        }
+    }
+    REQUIRE(!l_path.empty());
+
+    auto readFile = [](std::filesystem::path const &i_path)
+    {
+        std::ifstream l_in(i_path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(l_in)), std::istreambuf_iterator<char>());
+    };
+    std::string l_valid = readFile(l_path);
+    std::size_t l_keySize = l_valid.find("source: ");
+    REQUIRE(l_keySize != std::string::npos);
+    l_keySize = l_valid.find('\n', l_keySize) + 1;
+    REQUIRE(l_valid.size() > l_keySize);
+    std::string l_key = l_valid.substr(0, l_keySize);
+
+    std::string l_stale = l_valid;
+    l_stale.replace(l_stale.find("driver: "), 8, "driver: outdated ");
+    std::string l_broken[3] = {l_key + "not a program binary",
+                               l_stale,
+                               l_valid.substr(0, l_keySize / 2)};
+
+    for (std::string const &l_file : l_broken)
+    {
+        std::ofstream(l_path, std::ios::binary | std::ios::trunc) << l_file;
+
+        tsunami_lab::patches::WavePropagation2d_kernel l_waveProp(17, 11, 0, 1, 0, 1);
+        runDamBreak(l_waveProp);
+
+        // the program was built from source and cached again
+        std::string l_cached = readFile(l_path);
+        REQUIRE(l_cached != l_file);
+        REQUIRE(l_cached.compare(0, l_keySize, l_key) == 0);
+        REQUIRE(l_cached.size() > l_keySize);
+
+        tsunami_lab::t_idx l_stride = l_reference.getStride();
+        for (tsunami_lab::t_idx l_cy = 1; l_cy < 12; l_cy++)
+        {
+            for (tsunami_lab::t_idx l_cx = 1; l_cx < 18; l_cx++)
+            {
+                REQUIRE(l_waveProp.getHeight()[l_cx + l_cy * l_stride] == l_reference.getHeight()[l_cx + l_cy * l_stride]);
+                REQUIRE(l_waveProp.getMomentumX()[l_cx + l_cy * l_stride] == l_reference.getMomentumX()[l_cx + l_cy * l_stride]);
+                REQUIRE(l_waveProp.getMomentumY()[l_cx + l_cy * l_stride] == l_reference.getMomentumY()[l_cx + l_cy * l_stride]);
+            }
+        }
+    }
+
+    // a valid binary is loaded and left untouched
+    std::filesystem::file_time_type l_written = std::filesystem::last_write_time(l_path);
+    std::string l_cached = readFile(l_path);
+    tsunami_lab::patches::WavePropagation2d_kernel l_loaded(17, 11, 0, 1, 0, 1);
+    REQUIRE(readFile(l_path) == l_cached);
+    REQUIRE(std::filesystem::last_write_time(l_path) == l_written);
+}
@@ -155,220 +155,352 @@ void netUpdates(float i_hL, float i_hR, float i_huL, float i_huR, float i_bL,
 }
 
 
-// https://stackoverflow.com/a/70822133/19465205
-void __attribute__((always_inline))
-atomic_add_f(volatile global float *addr, const float val) {
-  union {
-    uint u32;
-    float f32;
-  } next, expected, current;
-  current.f32 = *addr;
-  do {
-    next.f32 = (expected.f32 = current.f32) + val; // ...*val for atomic_mul_f()
-    current.u32 =
-        atomic_cmpxchg((volatile global uint *)addr, expected.u32, next.u32);
-  } while (current.u32 != expected.u32);
-}
-
 inline int getCoordinates(ulong x, ulong y, ulong m_nCells_x,
                           ulong m_nCells_y) {
   return y * (m_nCells_x + 2) + x;
 }
 
+// Loads a cell of a sweep. The ghost cells (id 0 and #cells + 1 in the direction of the sweep) are not stored but
+// derived from the adjacent cell: open boundaries (0) copy it, closed boundaries (1) are dry walls with bathymetry 25.
+// i_step is the distance of neighboring cells in the direction of the sweep, i.e. 1 or the stride.
+void loadCell(__global const float *i_h, __global const float *i_huv,
+              __global const float *i_b, ulong i_coord, ulong i_id,
+              ulong i_nCells, ulong i_step, int i_boundaryLow,
+              int i_boundaryHigh, float *o_h, float *o_huv, float *o_b) {
+  int l_boundary = 0;
+  if (i_id == 0) {
+    l_boundary = i_boundaryLow;
+    i_coord += i_step;
+  } else if (i_id == i_nCells + 1) {
+    l_boundary = i_boundaryHigh;
+    i_coord -= i_step;
+  }
+
+  if (l_boundary == 1) {
+    *o_h = 0;
+    *o_huv = 0;
+    *o_b = 25;
+  } else {
+    *o_h = i_h[i_coord];
+    *o_huv = i_huv[i_coord];
+    *o_b = i_b[i_coord];
+  }
+}
 
-__kernel void
-setGhostOutflowLeftRight(__global float *m_h, __global float *m_hu,
-                __global float *m_b, ulong m_nCells_x, ulong m_nCells_y,
-                int m_state_boundary_left, int m_state_boundary_right) {
+// Net-updates of the edges in x-direction, edge (x, y) lies between the cells (x, y) and (x + 1, y).
+// Each work-item writes its own edge, the cells gather the updates in a second kernel without atomics.
+__kernel void netUpdatesXKernel(__global const float *i_h,
+                                __global const float *i_hu,
+                                __global const float *i_b, ulong m_nCells_x,
+                                ulong m_nCells_y, __global float *o_netUpdateLh,
+                                __global float *o_netUpdateLhu,
+                                __global float *o_netUpdateRh,
+                                __global float *o_netUpdateRhu,
+                                int m_state_boundary_left,
+                                int m_state_boundary_right) {
 
-  int x = get_global_id(0);
-  int y = get_global_id(1);
+  ulong x = get_global_id(0);
+  ulong y = get_global_id(1);
 
-  if (x >= m_nCells_x + 2 || y >= m_nCells_y + 2)
+  if (x >= m_nCells_x + 1 || y < 1 || y >= m_nCells_y + 1)
     return;
 
-  int l_coord, l_coord_l, l_coord_r;
-
-  // set left boundary
-  if (x == 0) {
-    switch (m_state_boundary_left) {
-    // open
-    case 0:
-      l_coord_l = getCoordinates(0, y, m_nCells_x, m_nCells_y);
-      l_coord_r = getCoordinates(1, y, m_nCells_x, m_nCells_y);
-      m_h[l_coord_l] = m_h[l_coord_r];
-      m_hu[l_coord_l] = m_hu[l_coord_r];
-      m_b[l_coord_l] = m_b[l_coord_r];
-      break;
-    // closed
-    case 1:
-      l_coord = getCoordinates(0, y, m_nCells_x, m_nCells_y);
-      m_h[l_coord] = 0;
-      m_hu[l_coord] = 0;
-      m_b[l_coord] = 25;
-      break;
-
-    default:
-      break;
-    }
-  }
+  ulong l_coord_L = getCoordinates(x, y, m_nCells_x, m_nCells_y);
 
-  // set right boundary
-  if (x == m_nCells_x + 1) {
-    switch (m_state_boundary_right) {
-    // open
-    case 0:
-      l_coord_l = getCoordinates(m_nCells_x, y, m_nCells_x, m_nCells_y);
-      l_coord_r = getCoordinates(m_nCells_x + 1, y, m_nCells_x, m_nCells_y);
-      m_h[l_coord_r] = m_h[l_coord_l];
-      m_hu[l_coord_r] = m_hu[l_coord_l];
-      m_b[l_coord_r] = m_b[l_coord_l];
-      break;
-    // closed
-    case 1:
-      l_coord = getCoordinates(m_nCells_x + 1, y, m_nCells_x, m_nCells_y);
-      m_h[l_coord] = 0;
-      m_hu[l_coord] = 0;
-      m_b[l_coord] = 25;
-      break;
-
-    default:
-      break;
-    }
+  float l_h[2], l_hu[2], l_b[2];
+  for (ulong l_ce = 0; l_ce < 2; l_ce++) {
+    loadCell(i_h, i_hu, i_b, l_coord_L + l_ce, x + l_ce, m_nCells_x, 1,
+             m_state_boundary_left, m_state_boundary_right, &l_h[l_ce],
+             &l_hu[l_ce], &l_b[l_ce]);
   }
+
+  float l_netUpdatesL[2];
+  float l_netUpdatesR[2];
+
+  netUpdates(l_h[0], l_h[1], l_hu[0], l_hu[1], l_b[0], l_b[1], l_netUpdatesL,
+             l_netUpdatesR);
+
+  o_netUpdateLh[l_coord_L] = l_netUpdatesL[0];
+  o_netUpdateLhu[l_coord_L] = l_netUpdatesL[1];
+  o_netUpdateRh[l_coord_L] = l_netUpdatesR[0];
+  o_netUpdateRhu[l_coord_L] = l_netUpdatesR[1];
 }
 
-__kernel void
-setGhostOutflowTopBottom(__global float *m_h, __global float *m_hv,
-                __global float *m_b, ulong m_nCells_x, ulong m_nCells_y,
-                int m_state_boundary_top, int m_state_boundary_bottom) {
+// Each cell gathers the right net-updates of the edge on its left and the left net-updates of the edge on its right.
+__kernel void updateXCellsKernel(__global float *io_h, __global float *io_hu,
+                                 __global const float *i_netUpdateLh,
+                                 __global const float *i_netUpdateLhu,
+                                 __global const float *i_netUpdateRh,
+                                 __global const float *i_netUpdateRhu,
+                                 ulong m_nCells_x, ulong m_nCells_y,
+                                 float i_scaling) {
 
-  int x = get_global_id(0);
-  int y = get_global_id(1);
+  ulong x = get_global_id(0);
+  ulong y = get_global_id(1);
 
-  if (x >= m_nCells_x + 2 || y >= m_nCells_y + 2)
+  if (x < 1 || x >= m_nCells_x + 1 || y < 1 || y >= m_nCells_y + 1)
     return;
 
-  int l_coord, l_coord_l, l_coord_r;
-
-  // set bottom boundary
-  if (y == 0) {
-    switch (m_state_boundary_bottom) {
-    // open
-    case 0:
-      l_coord_l = getCoordinates(x, 0, m_nCells_x, m_nCells_y);
-      l_coord_r = getCoordinates(x, 1, m_nCells_x, m_nCells_y);
-      m_h[l_coord_l] = m_h[l_coord_r];
-      m_hv[l_coord_l] = m_hv[l_coord_r];
-      m_b[l_coord_l] = m_b[l_coord_r];
-      break;
-    // closed
-    case 1:
-      l_coord = getCoordinates(x, 0, m_nCells_x, m_nCells_y);
-      m_h[l_coord] = 0;
-      m_hv[l_coord] = 0;
-      m_b[l_coord] = 25;
-      break;
-
-    default:
-      break;
-    }
-  }
+  ulong l_coord = getCoordinates(x, y, m_nCells_x, m_nCells_y);
 
-  // set top boundary
-  if (y == m_nCells_y + 1) {
-    switch (m_state_boundary_top) {
-    // open
-    case 0:
-      l_coord_l = getCoordinates(x, m_nCells_y, m_nCells_x, m_nCells_y);
-      l_coord_r = getCoordinates(x, m_nCells_y + 1, m_nCells_x, m_nCells_y);
-      m_h[l_coord_r] = m_h[l_coord_l];
-      m_hv[l_coord_r] = m_hv[l_coord_l];
-      m_b[l_coord_r] = m_b[l_coord_l];
-      break;
-    // closed
-    case 1:
-      l_coord = getCoordinates(x, m_nCells_y + 1, m_nCells_x, m_nCells_y);
-      m_h[l_coord] = 0;
-      m_hv[l_coord] = 0;
-      m_b[l_coord] = 25;
-      break;
-
-    default:
-      break;
-    }
-  }
+  io_h[l_coord] = io_h[l_coord] - i_scaling * i_netUpdateRh[l_coord - 1] -
+                  i_scaling * i_netUpdateLh[l_coord];
+  io_hu[l_coord] = io_hu[l_coord] - i_scaling * i_netUpdateRhu[l_coord - 1] -
+                   i_scaling * i_netUpdateLhu[l_coord];
 }
 
-__kernel void updateXAxisKernel(__global float *i_hTemp,
-                                __global float *i_huvTemp, __global float *i_b,
-                                ulong m_nCells_x, ulong m_nCells_y,
-                                float i_scaling, __global float *o_h,
-                                __global float *o_hu) {
+// Net-updates of the edges in y-direction, edge (x, y) lies between the cells (x, y) and (x, y + 1).
+__kernel void netUpdatesYKernel(__global const float *i_h,
+                                __global const float *i_hv,
+                                __global const float *i_b, ulong m_nCells_x,
+                                ulong m_nCells_y, __global float *o_netUpdateLh,
+                                __global float *o_netUpdateLhv,
+                                __global float *o_netUpdateRh,
+                                __global float *o_netUpdateRhv,
+                                int m_state_boundary_bottom,
+                                int m_state_boundary_top) {
 
   ulong x = get_global_id(0);
   ulong y = get_global_id(1);
 
-  if (x >= m_nCells_x + 1 || y >= m_nCells_y + 2)
+  if (x < 1 || x >= m_nCells_x + 1 || y >= m_nCells_y + 1)
     return;
 
+  ulong l_stride = m_nCells_x + 2;
   ulong l_coord_L = getCoordinates(x, y, m_nCells_x, m_nCells_y);
-  ulong l_coord_R = getCoordinates(x + 1, y, m_nCells_x, m_nCells_y);
 
-  //   Define net updates array
+  float l_h[2], l_hv[2], l_b[2];
+  for (ulong l_ce = 0; l_ce < 2; l_ce++) {
+    loadCell(i_h, i_hv, i_b, l_coord_L + l_ce * l_stride, y + l_ce,
+             m_nCells_y, l_stride, m_state_boundary_bottom,
+             m_state_boundary_top, &l_h[l_ce], &l_hv[l_ce], &l_b[l_ce]);
+  }
+
   float l_netUpdatesL[2];
   float l_netUpdatesR[2];
 
-  netUpdates(i_hTemp[l_coord_L], i_hTemp[l_coord_R], i_huvTemp[l_coord_L],
-             i_huvTemp[l_coord_R], i_b[l_coord_L], i_b[l_coord_R],
-             l_netUpdatesL, l_netUpdatesR);
+  netUpdates(l_h[0], l_h[1], l_hv[0], l_hv[1], l_b[0], l_b[1], l_netUpdatesL,
+             l_netUpdatesR);
 
-  atomic_add_f(&o_h[l_coord_L], -i_scaling * l_netUpdatesL[0]);
-  atomic_add_f(&o_hu[l_coord_L], -i_scaling * l_netUpdatesL[1]);
-  atomic_add_f(&o_h[l_coord_R], -i_scaling * l_netUpdatesR[0]);
-  atomic_add_f(&o_hu[l_coord_R], -i_scaling * l_netUpdatesR[1]);
+  o_netUpdateLh[l_coord_L] = l_netUpdatesL[0];
+  o_netUpdateLhv[l_coord_L] = l_netUpdatesL[1];
+  o_netUpdateRh[l_coord_L] = l_netUpdatesR[0];
+  o_netUpdateRhv[l_coord_L] = l_netUpdatesR[1];
 }
-__kernel void updateYAxisKernel(__global float *i_hTemp,
-                                __global float *i_huvTemp, __global float *i_b,
-                                ulong m_nCells_x, ulong m_nCells_y,
-                                float i_scaling, __global float *o_h,
-                                __global float *o_hv) {
+
+// Each cell gathers the up net-updates of the edge below and the down net-updates of the edge above.
+__kernel void updateYCellsKernel(__global float *io_h, __global float *io_hv,
+                                 __global const float *i_netUpdateLh,
+                                 __global const float *i_netUpdateLhv,
+                                 __global const float *i_netUpdateRh,
+                                 __global const float *i_netUpdateRhv,
+                                 ulong m_nCells_x, ulong m_nCells_y,
+                                 float i_scaling) {
 
   ulong x = get_global_id(0);
   ulong y = get_global_id(1);
 
-  if (y >= m_nCells_y + 1 || x >= m_nCells_x + 2)
+  if (x < 1 || x >= m_nCells_x + 1 || y < 1 || y >= m_nCells_y + 1)
     return;
 
-  ulong l_coord_L = getCoordinates(x, y, m_nCells_x, m_nCells_y);
-  ulong l_coord_R = getCoordinates(x, y + 1, m_nCells_x, m_nCells_y);
+  ulong l_coord = getCoordinates(x, y, m_nCells_x, m_nCells_y);
+  ulong l_coord_down = getCoordinates(x, y - 1, m_nCells_x, m_nCells_y);
 
-  //   Define net updates array
-  float l_netUpdatesL[2];
-  float l_netUpdatesR[2];
+  io_h[l_coord] = io_h[l_coord] - i_scaling * i_netUpdateRh[l_coord_down] -
+                  i_scaling * i_netUpdateLh[l_coord];
+  io_hv[l_coord] = io_hv[l_coord] -
+                   i_scaling * i_netUpdateRhv[l_coord_down] -
+                   i_scaling * i_netUpdateLhv[l_coord];
+}
 
-  netUpdates(i_hTemp[l_coord_L], i_hTemp[l_coord_R], i_huvTemp[l_coord_L],
-             i_huvTemp[l_coord_R], i_b[l_coord_L], i_b[l_coord_R],
-             l_netUpdatesL, l_netUpdatesR);
+// Tiled x-sweep: a work-group stages its tile of cells together with the left and right halo in local memory,
+// computes each edge of the tile once and writes the updated cells once. The cells are written to other buffers
+// than they are read from, since the halos of the neighboring work-groups still need the old values.
+// The local buffers hold (#local_x + 2) * #local_y cells and 4 * (#local_x + 1) * #local_y net-updates.
+__kernel void sweepXTiledKernel(__global const float *i_h,
+                                __global const float *i_hu,
+                                __global const float *i_b, ulong m_nCells_x,
+                                ulong m_nCells_y, float i_scaling,
+                                __global float *o_h, __global float *o_hu,
+                                __local float *l_h, __local float *l_hu,
+                                __local float *l_b, __local float *l_netUpdates,
+                                int m_state_boundary_left,
+                                int m_state_boundary_right) {
+
+  ulong x = get_global_id(0) + 1;
+  ulong y = get_global_id(1) + 1;
+  ulong l_lx = get_local_id(0);
+  ulong l_ly = get_local_id(1);
+  ulong l_nx = get_local_size(0);
+  ulong l_ny = get_local_size(1);
+
+  // the global range is rounded up to whole work-groups, the surplus work-items only take part in the barriers
+  bool l_active = x < m_nCells_x + 1 && y < m_nCells_y + 1;
+  ulong l_tileStride = l_nx + 2;
+  ulong l_edgeStride = l_nx + 1;
+  ulong l_nEdges = l_edgeStride * l_ny;
+
+  // stage the cell and the halo, the last cell of a row also loads its right neighbor
+  if (l_active) {
+    ulong l_coord = getCoordinates(x, y, m_nCells_x, m_nCells_y);
+    ulong l_id = l_ly * l_tileStride + l_lx + 1;
+    float l_cell[3];
+
+    for (long l_ce = -1; l_ce < 2; l_ce++) {
+      if ((l_ce == -1 && l_lx != 0) ||
+          (l_ce == 1 && l_lx != l_nx - 1 && x != m_nCells_x))
+        continue;
+
+      loadCell(i_h, i_hu, i_b, l_coord + l_ce, x + l_ce, m_nCells_x, 1,
+               m_state_boundary_left, m_state_boundary_right, &l_cell[0],
+               &l_cell[1], &l_cell[2]);
+      l_h[l_id + l_ce] = l_cell[0];
+      l_hu[l_id + l_ce] = l_cell[1];
+      l_b[l_id + l_ce] = l_cell[2];
+    }
+  }
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // each work-item computes the edge on its left, the last cell of a row also the edge on its right
+  if (l_active) {
+    ulong l_nEdgesCell = (l_lx == l_nx - 1 || x == m_nCells_x) ? 2 : 1;
+    for (ulong l_ed = 0; l_ed < l_nEdgesCell; l_ed++) {
+      ulong l_idL = l_ly * l_tileStride + l_lx + l_ed;
+      ulong l_edge = l_ly * l_edgeStride + l_lx + l_ed;
+
+      float l_netUpdatesL[2];
+      float l_netUpdatesR[2];
+      netUpdates(l_h[l_idL], l_h[l_idL + 1], l_hu[l_idL], l_hu[l_idL + 1],
+                 l_b[l_idL], l_b[l_idL + 1], l_netUpdatesL, l_netUpdatesR);
+
+      l_netUpdates[l_edge] = l_netUpdatesL[0];
+      l_netUpdates[l_nEdges + l_edge] = l_netUpdatesL[1];
+      l_netUpdates[2 * l_nEdges + l_edge] = l_netUpdatesR[0];
+      l_netUpdates[3 * l_nEdges + l_edge] = l_netUpdatesR[1];
+    }
+  }
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // gather the right net-updates of the left edge and the left net-updates of the right edge
+  if (l_active) {
+    ulong l_coord = getCoordinates(x, y, m_nCells_x, m_nCells_y);
+    ulong l_id = l_ly * l_tileStride + l_lx + 1;
+    ulong l_edge = l_ly * l_edgeStride + l_lx;
+
+    o_h[l_coord] = l_h[l_id] - i_scaling * l_netUpdates[2 * l_nEdges + l_edge] -
+                   i_scaling * l_netUpdates[l_edge + 1];
+    o_hu[l_coord] = l_hu[l_id] -
+                    i_scaling * l_netUpdates[3 * l_nEdges + l_edge] -
+                    i_scaling * l_netUpdates[l_nEdges + l_edge + 1];
+  }
+}
 
-  atomic_add_f(&o_h[l_coord_L], -i_scaling * l_netUpdatesL[0]);
-  atomic_add_f(&o_hv[l_coord_L], -i_scaling * l_netUpdatesL[1]);
-  atomic_add_f(&o_h[l_coord_R], -i_scaling * l_netUpdatesR[0]);
-  atomic_add_f(&o_hv[l_coord_R], -i_scaling * l_netUpdatesR[1]);
+// Tiled y-sweep with the halo rows below and above the tile.
+// The local buffers hold #local_x * (#local_y + 2) cells and 4 * #local_x * (#local_y + 1) net-updates.
+__kernel void sweepYTiledKernel(__global const float *i_h,
+                                __global const float *i_hv,
+                                __global const float *i_b, ulong m_nCells_x,
+                                ulong m_nCells_y, float i_scaling,
+                                __global float *o_h, __global float *o_hv,
+                                __local float *l_h, __local float *l_hv,
+                                __local float *l_b, __local float *l_netUpdates,
+                                int m_state_boundary_bottom,
+                                int m_state_boundary_top) {
+
+  ulong x = get_global_id(0) + 1;
+  ulong y = get_global_id(1) + 1;
+  ulong l_lx = get_local_id(0);
+  ulong l_ly = get_local_id(1);
+  ulong l_nx = get_local_size(0);
+  ulong l_ny = get_local_size(1);
+
+  bool l_active = x < m_nCells_x + 1 && y < m_nCells_y + 1;
+  ulong l_nEdges = l_nx * (l_ny + 1);
+  ulong l_stride = m_nCells_x + 2;
+
+  // stage the cell and the halo, the last cell of a column also loads its upper neighbor
+  if (l_active) {
+    ulong l_coord = getCoordinates(x, y, m_nCells_x, m_nCells_y);
+    ulong l_id = (l_ly + 1) * l_nx + l_lx;
+    float l_cell[3];
+
+    for (long l_ce = -1; l_ce < 2; l_ce++) {
+      if ((l_ce == -1 && l_ly != 0) ||
+          (l_ce == 1 && l_ly != l_ny - 1 && y != m_nCells_y))
+        continue;
+
+      loadCell(i_h, i_hv, i_b, l_coord + l_ce * (long)l_stride, y + l_ce,
+               m_nCells_y, l_stride, m_state_boundary_bottom,
+               m_state_boundary_top, &l_cell[0], &l_cell[1], &l_cell[2]);
+      l_h[l_id + l_ce * (long)l_nx] = l_cell[0];
+      l_hv[l_id + l_ce * (long)l_nx] = l_cell[1];
+      l_b[l_id + l_ce * (long)l_nx] = l_cell[2];
+    }
+  }
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // each work-item computes the edge below, the last cell of a column also the edge above
+  if (l_active) {
+    ulong l_nEdgesCell = (l_ly == l_ny - 1 || y == m_nCells_y) ? 2 : 1;
+    for (ulong l_ed = 0; l_ed < l_nEdgesCell; l_ed++) {
+      ulong l_idDown = (l_ly + l_ed) * l_nx + l_lx;
+      ulong l_edge = (l_ly + l_ed) * l_nx + l_lx;
+
+      float l_netUpdatesL[2];
+      float l_netUpdatesR[2];
+      netUpdates(l_h[l_idDown], l_h[l_idDown + l_nx], l_hv[l_idDown],
+                 l_hv[l_idDown + l_nx], l_b[l_idDown], l_b[l_idDown + l_nx],
+                 l_netUpdatesL, l_netUpdatesR);
+
+      l_netUpdates[l_edge] = l_netUpdatesL[0];
+      l_netUpdates[l_nEdges + l_edge] = l_netUpdatesL[1];
+      l_netUpdates[2 * l_nEdges + l_edge] = l_netUpdatesR[0];
+      l_netUpdates[3 * l_nEdges + l_edge] = l_netUpdatesR[1];
+    }
+  }
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  // gather the up net-updates of the edge below and the down net-updates of the edge above
+  if (l_active) {
+    ulong l_coord = getCoordinates(x, y, m_nCells_x, m_nCells_y);
+    ulong l_id = (l_ly + 1) * l_nx + l_lx;
+    ulong l_edge = l_ly * l_nx + l_lx;
+
+    o_h[l_coord] = l_h[l_id] - i_scaling * l_netUpdates[2 * l_nEdges + l_edge] -
+                   i_scaling * l_netUpdates[l_edge + l_nx];
+    o_hv[l_coord] = l_hv[l_id] -
+                    i_scaling * l_netUpdates[3 * l_nEdges + l_edge] -
+                    i_scaling * l_netUpdates[l_nEdges + l_edge + l_nx];
+  }
 }
 
-__kernel void copy(__global float *i_h, __global float *i_huv, ulong m_nCells_x,
-                   ulong m_nCells_y, __global float *o_hTemp,
-                   __global float *o_huvTemp) {
+// Writes the interior of height and momenta, averaged over blocks of i_div x i_div cells, to a compact buffer which
+// holds the three fields one after another, coarse cell (x, y) of a field at x + y * (m_nCells_x / i_div).
+// The cells of a block are summed row by row like the host's downsampling of the output.
+__kernel void coarsenKernel(__global const float *i_h,
+                            __global const float *i_hu,
+                            __global const float *i_hv, ulong m_nCells_x,
+                            ulong m_nCells_y, ulong i_div,
+                            __global float *o_coarse) {
 
   ulong x = get_global_id(0);
   ulong y = get_global_id(1);
+  ulong l_nx = m_nCells_x / i_div;
+  ulong l_ny = m_nCells_y / i_div;
 
-  if (x >= m_nCells_x + 2 || y >= m_nCells_y + 2)
+  if (x >= l_nx || y >= l_ny)
     return;
 
-  ulong l_coord = getCoordinates(x, y, m_nCells_x, m_nCells_y);
-
-  o_hTemp[l_coord] = i_h[l_coord];
-  o_huvTemp[l_coord] = i_huv[l_coord];
-}
\ No newline at end of file
+  __global const float *l_fields[3] = {i_h, i_hu, i_hv};
+  for (ulong l_qt = 0; l_qt < 3; l_qt++) {
+    float l_sum = 0;
+    for (ulong l_cy = y * i_div; l_cy < (y + 1) * i_div; l_cy++) {
+      for (ulong l_cx = x * i_div; l_cx < (x + 1) * i_div; l_cx++) {
+        l_sum += l_fields[l_qt][getCoordinates(l_cx + 1, l_cy + 1, m_nCells_x,
+                                               m_nCells_y)];
+      }
+    }
+    o_coarse[l_qt * l_nx * l_ny + x + y * l_nx] =
+        l_sum / (float)(i_div * i_div);
+  }
+}
@@ -0,0 +1,326 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Two-dimensional wave propagation patch for several scenarios on the same bathymetry.
+ **/
+#include "WavePropagation2dLanes.h"
+#include "../../solvers/f-wave/F_wave.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+tsunami_lab::patches::WavePropagation2dLanes::WavePropagation2dLanes(t_idx i_nCells_x,
+                                                                     t_idx i_nCells_y,
+                                                                     t_idx i_nLanes,
+                                                                     int i_state_boundary_left,
+                                                                     int i_state_boundary_right,
+                                                                     int i_state_boundary_top,
+                                                                     int i_state_boundary_bottom,
+                                                                     t_real const *i_b)
+{
+    m_nCells_x = i_nCells_x;
+    m_nCells_y = i_nCells_y;
+    m_nLanes = i_nLanes;
+    m_state_boundary_left = i_state_boundary_left;
+    m_state_boundary_right = i_state_boundary_right;
+    m_state_boundary_top = i_state_boundary_top;
+    m_state_boundary_bottom = i_state_boundary_bottom;
+    m_b = i_b;
+
+    if (m_nLanes == 0)
+    {
+        std::cerr << "a patch with lanes needs at least one lane" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    for (unsigned short l_st = 0; l_st < 2; l_st++)
+    {
+        m_h[l_st] = allocateFirstTouch(m_nCells_y + 2, m_nCells_x + 2);
+        m_hu[l_st] = allocateFirstTouch(m_nCells_y + 2, m_nCells_x + 2);
+        m_hv[l_st] = allocateFirstTouch(m_nCells_y + 2, m_nCells_x + 2);
+    }
+
+    // edge buffers, shared by the x- and y-sweep
+    for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+    {
+        m_netUpdates[l_nu] = allocateFirstTouch(m_nCells_y + 1, m_nCells_x + 1);
+    }
+
+    m_maxWaveSpeed.assign(m_nLanes, 0);
+}
+
+tsunami_lab::t_real *tsunami_lab::patches::WavePropagation2dLanes::allocateFirstTouch(t_idx i_nRows,
+                                                                                     t_idx i_rowSize) const
+{
+    t_idx l_rowSize = i_rowSize * m_nLanes;
+    t_real *l_field = new t_real[i_nRows * l_rowSize];
+
+    // same static schedule as the row loops of the sweeps
+#pragma omp parallel for schedule(static)
+    for (t_idx l_row = 0; l_row < i_nRows; l_row++)
+    {
+        std::fill(l_field + l_row * l_rowSize, l_field + (l_row + 1) * l_rowSize, t_real(0));
+    }
+
+    return l_field;
+}
+
+tsunami_lab::patches::WavePropagation2dLanes::~WavePropagation2dLanes()
+{
+    for (unsigned short l_st = 0; l_st < 2; l_st++)
+    {
+        delete[] m_h[l_st];
+        delete[] m_hu[l_st];
+        delete[] m_hv[l_st];
+    }
+    for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+    {
+        delete[] m_netUpdates[l_nu];
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2dLanes::timeStep(t_real const *i_scaling)
+{
+    t_idx l_nLanes = m_nLanes;
+
+    // maximum wave speed of each lane in both sweeps
+    t_real *l_speedMax = m_maxWaveSpeed.data();
+    std::fill(m_maxWaveSpeed.begin(), m_maxWaveSpeed.end(), t_real(0));
+
+    //
+    // X-AXIS
+    //
+    setGhostOutflow();
+
+    // pointers to old and new data, the momenta in y-direction are not changed by the x-sweep
+    t_real *l_hOld = m_h[m_step_h];
+    t_real *l_huOld = m_hu[m_step_hu];
+
+    m_step_h = (m_step_h + 1) % 2;
+    m_step_hu = (m_step_hu + 1) % 2;
+    t_real *l_hNew = m_h[m_step_h];
+    t_real *l_huNew = m_hu[m_step_hu];
+
+    // edges in x-direction: row y - 1 holds the edges between the cells x and x + 1 of row y
+    t_idx l_nEdges_x = m_nCells_x + 1;
+
+#pragma omp parallel
+    {
+        // phase one: net-updates of all edges
+#pragma omp for schedule(static) reduction(max : l_speedMax[:l_nLanes])
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
+        {
+            t_idx l_coord = getCoordinates(0, l_y);
+            t_idx l_edge = (l_y - 1) * l_nEdges_x;
+
+            solvers::FWave<t_real>::netUpdatesLanes(l_nEdges_x,
+                                                    l_nLanes,
+                                                    l_hOld + l_coord * l_nLanes,
+                                                    l_hOld + (l_coord + 1) * l_nLanes,
+                                                    l_huOld + l_coord * l_nLanes,
+                                                    l_huOld + (l_coord + 1) * l_nLanes,
+                                                    m_b + l_coord,
+                                                    m_b + l_coord + 1,
+                                                    m_netUpdates[0] + l_edge * l_nLanes,
+                                                    m_netUpdates[1] + l_edge * l_nLanes,
+                                                    m_netUpdates[2] + l_edge * l_nLanes,
+                                                    m_netUpdates[3] + l_edge * l_nLanes,
+                                                    l_speedMax);
+        }
+
+        // phase two: each cell gathers the right net-updates of edge x - 1 and the left net-updates of edge x
+#pragma omp for schedule(static)
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
+        {
+            t_idx l_coord = getCoordinates(0, l_y);
+            t_real const *l_netUpdates[4];
+            for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+            {
+                l_netUpdates[l_nu] = m_netUpdates[l_nu] + (l_y - 1) * l_nEdges_x * l_nLanes;
+            }
+
+            for (t_idx l_x = 1; l_x < m_nCells_x + 1; l_x++)
+            {
+                t_idx l_id = (l_coord + l_x) * l_nLanes;
+                t_idx l_edgeL = (l_x - 1) * l_nLanes;
+                t_idx l_edgeR = l_x * l_nLanes;
+
+#pragma omp simd
+                for (t_idx l_la = 0; l_la < l_nLanes; l_la++)
+                {
+                    l_hNew[l_id + l_la] = l_hOld[l_id + l_la] - i_scaling[l_la] * l_netUpdates[2][l_edgeL + l_la] - i_scaling[l_la] * l_netUpdates[0][l_edgeR + l_la];
+                    l_huNew[l_id + l_la] = l_huOld[l_id + l_la] - i_scaling[l_la] * l_netUpdates[3][l_edgeL + l_la] - i_scaling[l_la] * l_netUpdates[1][l_edgeR + l_la];
+                }
+            }
+        }
+    }
+
+    //
+    // Y-AXIS
+    //
+    setGhostOutflow();
+
+    // pointers to old and new data, the momenta in x-direction are not changed by the y-sweep
+    l_hOld = m_h[m_step_h];
+    t_real *l_hvOld = m_hv[m_step_hv];
+
+    m_step_h = (m_step_h + 1) % 2;
+    m_step_hv = (m_step_hv + 1) % 2;
+    l_hNew = m_h[m_step_h];
+    t_real *l_hvNew = m_hv[m_step_hv];
+
+    // edges in y-direction: row y holds the edges between the cells of row y and y + 1, without the ghost columns
+    t_idx l_nEdges_y = m_nCells_x;
+
+#pragma omp parallel
+    {
+        // phase one: net-updates of all edges
+#pragma omp for schedule(static) reduction(max : l_speedMax[:l_nLanes])
+        for (t_idx l_y = 0; l_y < m_nCells_y + 1; l_y++)
+        {
+            t_idx l_coord_down = getCoordinates(1, l_y);
+            t_idx l_coord_up = getCoordinates(1, l_y + 1);
+            t_idx l_edge = l_y * l_nEdges_y;
+
+            solvers::FWave<t_real>::netUpdatesLanes(l_nEdges_y,
+                                                    l_nLanes,
+                                                    l_hOld + l_coord_down * l_nLanes,
+                                                    l_hOld + l_coord_up * l_nLanes,
+                                                    l_hvOld + l_coord_down * l_nLanes,
+                                                    l_hvOld + l_coord_up * l_nLanes,
+                                                    m_b + l_coord_down,
+                                                    m_b + l_coord_up,
+                                                    m_netUpdates[0] + l_edge * l_nLanes,
+                                                    m_netUpdates[1] + l_edge * l_nLanes,
+                                                    m_netUpdates[2] + l_edge * l_nLanes,
+                                                    m_netUpdates[3] + l_edge * l_nLanes,
+                                                    l_speedMax);
+        }
+
+        // phase two: each cell gathers the up net-updates of the edge below and the down net-updates of the edge above
+#pragma omp for schedule(static)
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
+        {
+            t_idx l_coord = getCoordinates(1, l_y);
+            t_real const *l_netUpdatesUp[2] = {m_netUpdates[2] + (l_y - 1) * l_nEdges_y * l_nLanes,
+                                               m_netUpdates[3] + (l_y - 1) * l_nEdges_y * l_nLanes};
+            t_real const *l_netUpdatesDown[2] = {m_netUpdates[0] + l_y * l_nEdges_y * l_nLanes,
+                                                 m_netUpdates[1] + l_y * l_nEdges_y * l_nLanes};
+
+            for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+            {
+                t_idx l_id = (l_coord + l_x) * l_nLanes;
+                t_idx l_edge = l_x * l_nLanes;
+
+#pragma omp simd
+                for (t_idx l_la = 0; l_la < l_nLanes; l_la++)
+                {
+                    l_hNew[l_id + l_la] = l_hOld[l_id + l_la] - i_scaling[l_la] * l_netUpdatesUp[0][l_edge + l_la] - i_scaling[l_la] * l_netUpdatesDown[0][l_edge + l_la];
+                    l_hvNew[l_id + l_la] = l_hvOld[l_id + l_la] - i_scaling[l_la] * l_netUpdatesUp[1][l_edge + l_la] - i_scaling[l_la] * l_netUpdatesDown[1][l_edge + l_la];
+                }
+            }
+        }
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2dLanes::setGhostOutflow()
+{
+    t_real *l_q[3] = {m_h[m_step_h], m_hu[m_step_hu], m_hv[m_step_hv]};
+    int l_state[4] = {m_state_boundary_left, m_state_boundary_right, m_state_boundary_top, m_state_boundary_bottom};
+    char const *l_side[4] = {"left", "right", "top", "bottom"};
+
+    for (unsigned short l_sd = 0; l_sd < 4; l_sd++)
+    {
+        if (l_state[l_sd] != 0 && l_state[l_sd] != 1)
+        {
+            std::cerr << "undefined state for " << l_side[l_sd] << " boundary" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // the columns include the corners, which are then overwritten by the rows
+    for (t_idx l_y = 0; l_y < m_nCells_y + 2; l_y++)
+    {
+        t_idx l_ghost[2] = {getCoordinates(0, l_y), getCoordinates(m_nCells_x + 1, l_y)};
+        t_idx l_inner[2] = {getCoordinates(1, l_y), getCoordinates(m_nCells_x, l_y)};
+        for (unsigned short l_sd = 0; l_sd < 2; l_sd++)
+        {
+            for (t_real *l_field : l_q)
+            {
+                if (l_state[l_sd] == 0)
+                {
+                    std::copy(l_field + l_inner[l_sd] * m_nLanes, l_field + (l_inner[l_sd] + 1) * m_nLanes, l_field + l_ghost[l_sd] * m_nLanes);
+                }
+                else
+                {
+                    std::fill(l_field + l_ghost[l_sd] * m_nLanes, l_field + (l_ghost[l_sd] + 1) * m_nLanes, t_real(0));
+                }
+            }
+        }
+    }
+
+    // the rows are contiguous in all lanes
+    t_idx l_ghost[2] = {getCoordinates(0, 0), getCoordinates(0, m_nCells_y + 1)};
+    t_idx l_inner[2] = {getCoordinates(0, 1), getCoordinates(0, m_nCells_y)};
+    t_idx l_rowSize = getStride() * m_nLanes;
+    for (unsigned short l_sd = 0; l_sd < 2; l_sd++)
+    {
+        for (t_real *l_field : l_q)
+        {
+            if (l_state[2 + l_sd] == 0)
+            {
+                std::copy(l_field + l_inner[l_sd] * m_nLanes, l_field + l_inner[l_sd] * m_nLanes + l_rowSize, l_field + l_ghost[l_sd] * m_nLanes);
+            }
+            else
+            {
+                std::fill(l_field + l_ghost[l_sd] * m_nLanes, l_field + l_ghost[l_sd] * m_nLanes + l_rowSize, t_real(0));
+            }
+        }
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2dLanes::setCells(t_idx i_lane,
+                                                            t_idx i_ix0,
+                                                            t_idx i_iy0,
+                                                            t_idx i_nx,
+                                                            t_idx i_ny,
+                                                            t_idx i_stride,
+                                                            t_real const *i_h,
+                                                            t_real const *i_hu,
+                                                            t_real const *i_hv)
+{
+#pragma omp parallel for schedule(static)
+    for (t_idx l_iy = 0; l_iy < i_ny; l_iy++)
+    {
+        t_idx l_coord = getCoordinates(i_ix0 + 1, i_iy0 + l_iy + 1);
+        t_idx l_id = l_iy * i_stride;
+        for (t_idx l_ix = 0; l_ix < i_nx; l_ix++)
+        {
+            t_idx l_ce = (l_coord + l_ix) * m_nLanes + i_lane;
+            m_h[m_step_h][l_ce] = i_h[l_id + l_ix];
+            m_hu[m_step_hu][l_ce] = i_hu[l_id + l_ix];
+            m_hv[m_step_hv][l_ce] = i_hv[l_id + l_ix];
+        }
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2dLanes::getLane(t_idx i_lane,
+                                                           t_real *o_h,
+                                                           t_real *o_hu,
+                                                           t_real *o_hv) const
+{
+#pragma omp parallel for schedule(static)
+    for (t_idx l_y = 0; l_y < m_nCells_y + 2; l_y++)
+    {
+        for (t_idx l_x = 0; l_x < m_nCells_x + 2; l_x++)
+        {
+            t_idx l_coord = getCoordinates(l_x, l_y);
+            o_h[l_coord] = m_h[m_step_h][l_coord * m_nLanes + i_lane];
+            o_hu[l_coord] = m_hu[m_step_hu][l_coord * m_nLanes + i_lane];
+            o_hv[l_coord] = m_hv[m_step_hv][l_coord * m_nLanes + i_lane];
+        }
+    }
+}
@@ -0,0 +1,213 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Two-dimensional wave propagation patch for several scenarios on the same bathymetry.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D_LANES
+#define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D_LANES
+
+#include <vector>
+
+#include "../../constants.h"
+
+namespace tsunami_lab
+{
+    namespace patches
+    {
+        class WavePropagation2dLanes;
+    }
+} // namespace tsunami_lab
+
+/**
+ * Two-dimensional wave propagation patch which advances several scenarios (lanes) on the same grid and bathymetry.
+ *
+ * The lane index is innermost: quantity q of cell (x, y) in lane l is stored at (x + y * stride) * #lanes + l.
+ * The edges at the same location in all lanes are computed by one vectorized loop, without gathers and with a
+ * single bathymetry value per edge. Each lane has its own time step and matches a WavePropagation2d<> with the
+ * untiled, split time step bitwise.
+ **/
+class tsunami_lab::patches::WavePropagation2dLanes
+{
+private:
+    //! current steps which indicate the active buffers of the height and the momenta below
+    unsigned short m_step_h = 0;
+    unsigned short m_step_hu = 0;
+    unsigned short m_step_hv = 0;
+
+    //! number of cells in x-direction discretizing the computational domain
+    t_idx m_nCells_x = 0;
+
+    //! number of cells in y-direction discretizing the computational domain
+    t_idx m_nCells_y = 0;
+
+    //! number of lanes
+    t_idx m_nLanes = 0;
+
+    //! state of left boundary, 0 = open, 1 = closed
+    int m_state_boundary_left = 0;
+
+    //! state of right boundary, 0 = open, 1 = closed
+    int m_state_boundary_right = 0;
+
+    //! state of top boundary, 0 = open, 1 = closed
+    int m_state_boundary_top = 0;
+
+    //! state of bottom boundary, 0 = open, 1 = closed
+    int m_state_boundary_bottom = 0;
+
+    //! water heights for the current and next time step for all cells and lanes
+    t_real *m_h[2] = {nullptr, nullptr};
+
+    //! momenta for the current and next time step for all cells and lanes in x-direction
+    t_real *m_hu[2] = {nullptr, nullptr};
+
+    //! momenta for the current and next time step for all cells and lanes in y-direction
+    t_real *m_hv[2] = {nullptr, nullptr};
+
+    //! common bathymetry including the ghost cells, not owned by the patch
+    t_real const *m_b = nullptr;
+
+    //! net-updates of the edges of a sweep for all lanes: left/down height, left/down momentum, right/up height, right/up momentum
+    t_real *m_netUpdates[4] = {nullptr, nullptr, nullptr, nullptr};
+
+    //! maximum absolute wave speed of each lane in the last time step
+    std::vector<t_real> m_maxWaveSpeed;
+
+    /**
+     * Gets the id of a cell in the arrays without the lanes.
+     *
+     * @param i_x id of the cell in x-direction, including the ghost cells.
+     * @param i_y id of the cell in y-direction, including the ghost cells.
+     * @return id of the cell.
+     **/
+    t_idx getCoordinates(t_idx i_x, t_idx i_y) const
+    {
+        return i_x + i_y * getStride();
+    }
+
+    /**
+     * Allocates a field with one value per lane and cell of i_nRows rows, each row is initialized
+     * with zeros by the thread which computes it.
+     *
+     * @param i_nRows number of rows.
+     * @param i_rowSize number of cells in a row.
+     * @return pointer to the field.
+     **/
+    t_real *allocateFirstTouch(t_idx i_nRows,
+                               t_idx i_rowSize) const;
+
+    /**
+     * Sets the values of the ghost cells of all lanes according to the boundary conditions.
+     * The bathymetry of the ghost cells is set by the owner of the bathymetry.
+     **/
+    void setGhostOutflow();
+
+public:
+    /**
+     * Constructs the patch.
+     *
+     * @param i_nCells_x number of cells in x-direction.
+     * @param i_nCells_y number of cells in y-direction.
+     * @param i_nLanes number of lanes.
+     * @param i_state_boundary_left state of the left boundary (0 = open, 1 = closed).
+     * @param i_state_boundary_right state of the right boundary.
+     * @param i_state_boundary_top state of the top boundary.
+     * @param i_state_boundary_bottom state of the bottom boundary.
+     * @param i_b common bathymetry including the ghost cells with stride i_nCells_x + 2, e.g. of a WavePropagation2d<> after fixBathymetry(); has to outlive the patch.
+     **/
+    WavePropagation2dLanes(t_idx i_nCells_x,
+                           t_idx i_nCells_y,
+                           t_idx i_nLanes,
+                           int i_state_boundary_left,
+                           int i_state_boundary_right,
+                           int i_state_boundary_top,
+                           int i_state_boundary_bottom,
+                           t_real const *i_b);
+
+    /**
+     * Destructor which frees all allocated memory except the common bathymetry.
+     **/
+    ~WavePropagation2dLanes();
+
+    WavePropagation2dLanes(WavePropagation2dLanes const &) = delete;
+    WavePropagation2dLanes &operator=(WavePropagation2dLanes const &) = delete;
+
+    /**
+     * Performs a time step in all lanes.
+     *
+     * @param i_scaling scaling of the time step (dt / dx) of each lane, 0 keeps the lane unchanged.
+     **/
+    void timeStep(t_real const *i_scaling);
+
+    /**
+     * Gets the number of lanes.
+     *
+     * @return number of lanes.
+     **/
+    t_idx getNumLanes() const
+    {
+        return m_nLanes;
+    }
+
+    /**
+     * Gets the stride in y-direction of the cells, i.e. of the bathymetry and the fields copied by getLane.
+     *
+     * @return stride in y-direction.
+     **/
+    t_idx getStride() const
+    {
+        return m_nCells_x + 2;
+    }
+
+    /**
+     * Gets the maximum absolute wave speed of a lane in the last time step.
+     *
+     * @param i_lane id of the lane.
+     * @return maximum wave speed.
+     **/
+    t_real getMaxWaveSpeed(t_idx i_lane) const
+    {
+        return m_maxWaveSpeed[i_lane];
+    }
+
+    /**
+     * Sets height and momenta of a block of cells in one lane, copying the rows in parallel.
+     *
+     * @param i_lane id of the lane.
+     * @param i_ix0 id of the block's first cell in x-direction.
+     * @param i_iy0 id of the block's first cell in y-direction.
+     * @param i_nx number of cells of the block in x-direction.
+     * @param i_ny number of cells of the block in y-direction.
+     * @param i_stride stride of the rows in the given arrays.
+     * @param i_h water heights.
+     * @param i_hu momenta in x-direction.
+     * @param i_hv momenta in y-direction.
+     **/
+    void setCells(t_idx i_lane,
+                  t_idx i_ix0,
+                  t_idx i_iy0,
+                  t_idx i_nx,
+                  t_idx i_ny,
+                  t_idx i_stride,
+                  t_real const *i_h,
+                  t_real const *i_hu,
+                  t_real const *i_hv);
+
+    /**
+     * Copies the height and the momenta of one lane, including the ghost cells.
+     * The copies have the layout of a WavePropagation2d<>, i.e. stride getStride().
+     *
+     * @param i_lane id of the lane.
+     * @param o_h will be set to the water heights, (#cells_x + 2) * (#cells_y + 2) values.
+     * @param o_hu will be set to the momenta in x-direction.
+     * @param o_hv will be set to the momenta in y-direction.
+     **/
+    void getLane(t_idx i_lane,
+                 t_real *o_h,
+                 t_real *o_hu,
+                 t_real *o_hv) const;
+};
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Unit tests for the two-dimensional wave propagation patch with lanes.
+ **/
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <vector>
+#include "WavePropagation2dLanes.h"
+#include "../wavepropagation2d/WavePropagation2d.h"
+#include "../../constants.h"
+
+TEST_CASE("Test the 2d wave propagation with lanes against single patches.", "[WaveProp2dLanes]")
+{
+    /*
+     * Test case:
+     *
+     *   Three dam breaks at different positions on 40 x 30 cells, the shore on the right is dry and the
+     *   bottom boundary is closed. The lanes take different time steps, the last lane pauses for some steps.
+     *   Each lane has to match a single patch with the untiled, split time step bitwise.
+     */
+    tsunami_lab::t_idx l_nx = 40;
+    tsunami_lab::t_idx l_ny = 30;
+    tsunami_lab::t_idx l_nLanes = 3;
+
+    tsunami_lab::patches::WavePropagation2d<> l_owner(l_nx, l_ny, 0, 0, 0, 1);
+    std::vector<tsunami_lab::patches::WavePropagation2d<> *> l_singles;
+    for (tsunami_lab::t_idx l_la = 0; l_la < l_nLanes; l_la++)
+    {
+        l_singles.push_back(new tsunami_lab::patches::WavePropagation2d<>(l_nx, l_ny, 0, 0, 0, 1));
+    }
+
+    std::vector<tsunami_lab::t_real> l_h(l_nLanes * l_nx * l_ny);
+    std::vector<tsunami_lab::t_real> l_hu(l_nLanes * l_nx * l_ny, 0);
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < l_ny; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 0; l_cx < l_nx; l_cx++)
+        {
+            tsunami_lab::t_real l_b = -10 + tsunami_lab::t_real(l_cx) * 0.4f;
+            l_owner.setBathymetry(l_cx, l_cy, l_b);
+
+            for (tsunami_lab::t_idx l_la = 0; l_la < l_nLanes; l_la++)
+            {
+                tsunami_lab::t_real l_dx = tsunami_lab::t_real(l_cx) - 5 - 8 * l_la;
+                tsunami_lab::t_real l_dy = tsunami_lab::t_real(l_cy) - 15;
+                tsunami_lab::t_real l_height = std::max(tsunami_lab::t_real(0), (l_dx * l_dx + l_dy * l_dy < 16 ? 5 : 0) - l_b);
+                l_h[l_la * l_nx * l_ny + l_cx + l_cy * l_nx] = l_height;
+
+                l_singles[l_la]->setHeight(l_cx, l_cy, l_height);
+                l_singles[l_la]->setMomentumX(l_cx, l_cy, 0);
+                l_singles[l_la]->setMomentumY(l_cx, l_cy, 0);
+                l_singles[l_la]->setBathymetry(l_cx, l_cy, l_b);
+            }
+        }
+    }
+    l_owner.fixBathymetry();
+
+    tsunami_lab::patches::WavePropagation2dLanes l_lanes(l_nx, l_ny, l_nLanes, 0, 0, 0, 1, l_owner.getBathymetry());
+    REQUIRE(l_lanes.getNumLanes() == l_nLanes);
+    REQUIRE(l_lanes.getStride() == l_owner.getStride());
+    for (tsunami_lab::t_idx l_la = 0; l_la < l_nLanes; l_la++)
+    {
+        tsunami_lab::t_idx l_id = l_la * l_nx * l_ny;
+        l_lanes.setCells(l_la, 0, 0, l_nx, l_ny, l_nx, l_h.data() + l_id, l_hu.data() + l_id, l_hu.data() + l_id);
+    }
+
+    for (int l_st = 0; l_st < 50; l_st++)
+    {
+        tsunami_lab::t_real l_scaling[3] = {0.05f, 0.04f, (l_st % 5 == 0) ? 0.03f : 0};
+        l_lanes.timeStep(l_scaling);
+
+        for (tsunami_lab::t_idx l_la = 0; l_la < l_nLanes; l_la++)
+        {
+            if (l_scaling[l_la] > 0)
+            {
+                l_singles[l_la]->timeStep(l_scaling[l_la]);
+                REQUIRE(l_lanes.getMaxWaveSpeed(l_la) == l_singles[l_la]->getMaxWaveSpeed());
+            }
+        }
+    }
+
+    std::vector<tsunami_lab::t_real> l_lane[3];
+    for (std::vector<tsunami_lab::t_real> &l_quantity : l_lane)
+    {
+        l_quantity.resize((l_nx + 2) * (l_ny + 2));
+    }
+    tsunami_lab::t_idx l_stride = l_lanes.getStride();
+    for (tsunami_lab::t_idx l_la = 0; l_la < l_nLanes; l_la++)
+    {
+        l_lanes.getLane(l_la, l_lane[0].data(), l_lane[1].data(), l_lane[2].data());
+        tsunami_lab::t_real const *l_single[3] = {l_singles[l_la]->getHeight(),
+                                                   l_singles[l_la]->getMomentumX(),
+                                                   l_singles[l_la]->getMomentumY()};
+
+        for (tsunami_lab::t_idx l_cy = 1; l_cy < l_ny + 1; l_cy++)
+        {
+            for (tsunami_lab::t_idx l_cx = 1; l_cx < l_nx + 1; l_cx++)
+            {
+                for (unsigned short l_qt = 0; l_qt < 3; l_qt++)
+                {
+                    REQUIRE(l_lane[l_qt][l_cx + l_cy * l_stride] == l_single[l_qt][l_cx + l_cy * l_stride]);
+                }
+            }
+        }
+    }
+
+    // the dry shore is not flooded
+    REQUIRE(l_lane[0][l_nx + l_ny / 2 * l_stride] == 0);
+
+    for (tsunami_lab::patches::WavePropagation2d<> *l_single : l_singles)
+    {
+        delete l_single;
+    }
+}
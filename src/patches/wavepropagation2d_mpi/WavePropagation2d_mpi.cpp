@@ -0,0 +1,520 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Two-dimensional wave propagation patch, distributed with MPI.
+ **/
+#include "WavePropagation2d_mpi.h"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include "../../solvers/f-wave/F_wave.h"
+
+// the fields are exchanged as MPI_FLOAT
+static_assert(std::is_same<tsunami_lab::t_real, float>::value, "t_real has to be float");
+
+tsunami_lab::patches::WavePropagation2d_mpi::WavePropagation2d_mpi(t_idx i_nCells_x,
+                                                                   t_idx i_nCells_y,
+                                                                   int state_boundary_left,
+                                                                   int state_boundary_right,
+                                                                   int state_boundary_top,
+                                                                   int state_boundary_bottom,
+                                                                   MPI_Comm i_comm)
+{
+    m_state_boundary_left = state_boundary_left;
+    m_state_boundary_right = state_boundary_right;
+    m_state_boundary_top = state_boundary_top;
+    m_state_boundary_bottom = state_boundary_bottom;
+
+    // 2d Cartesian decomposition without periodicity, the top neighbor has the smaller y-coordinate
+    int l_nRanks = 0;
+    MPI_Comm_size(i_comm, &l_nRanks);
+    MPI_Dims_create(l_nRanks, 2, m_dims);
+    int l_periods[2] = {0, 0};
+    MPI_Cart_create(i_comm, 2, m_dims, l_periods, 0, &m_comm);
+
+    int l_rank = 0;
+    MPI_Comm_rank(m_comm, &l_rank);
+    MPI_Cart_coords(m_comm, l_rank, 2, m_coords);
+    MPI_Cart_shift(m_comm, 0, 1, &m_rank_left, &m_rank_right);
+    MPI_Cart_shift(m_comm, 1, 1, &m_rank_top, &m_rank_bottom);
+
+    // block distribution, the first ranks get one more cell if the cells do not divide evenly
+    t_idx l_nCells[2] = {i_nCells_x, i_nCells_y};
+    t_idx l_nLocal[2] = {0, 0};
+    t_idx l_offset[2] = {0, 0};
+    for (unsigned short l_di = 0; l_di < 2; l_di++)
+    {
+        t_idx l_base = l_nCells[l_di] / m_dims[l_di];
+        t_idx l_rest = l_nCells[l_di] % m_dims[l_di];
+        t_idx l_coord = m_coords[l_di];
+        l_nLocal[l_di] = l_base + (l_coord < l_rest ? 1 : 0);
+        l_offset[l_di] = l_coord * l_base + std::min(l_coord, l_rest);
+    }
+    m_nCells_x = l_nLocal[0];
+    m_nCells_y = l_nLocal[1];
+    m_offset_x = l_offset[0];
+    m_offset_y = l_offset[1];
+
+    if (m_nCells_x == 0 || m_nCells_y == 0)
+    {
+        std::cerr << "too many ranks for " << i_nCells_x << " x " << i_nCells_y << " cells" << std::endl;
+        MPI_Abort(i_comm, EXIT_FAILURE);
+    }
+
+    // allocate memory including a single ghost cell on each side and initializing with 0
+    for (unsigned short l_st = 0; l_st < 2; l_st++)
+    {
+        m_h[l_st] = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
+        m_hu[l_st] = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
+        m_hv[l_st] = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
+    }
+    m_b = new t_real[(m_nCells_x + 2) * (m_nCells_y + 2)]{0};
+
+    // inner cells of a column: one value per row, rows are a stride apart
+    MPI_Type_vector(m_nCells_y, 1, getStride(), MPI_FLOAT, &m_column);
+    MPI_Type_commit(&m_column);
+}
+
+tsunami_lab::patches::WavePropagation2d_mpi::~WavePropagation2d_mpi()
+{
+    for (unsigned short l_st = 0; l_st < 2; l_st++)
+    {
+        delete[] m_h[l_st];
+        delete[] m_hu[l_st];
+        delete[] m_hv[l_st];
+    }
+    delete[] m_b;
+    MPI_Type_free(&m_column);
+    MPI_Comm_free(&m_comm);
+}
+
+void tsunami_lab::patches::WavePropagation2d_mpi::startExchangeColumns(t_real *io_field,
+                                                                       MPI_Request o_requests[4])
+{
+    // first inner column to the left, last inner column to the right
+    MPI_Irecv(io_field + getCoordinates(m_nCells_x + 1, 1), 1, m_column, m_rank_right, 0, m_comm, &o_requests[0]);
+    MPI_Irecv(io_field + getCoordinates(0, 1), 1, m_column, m_rank_left, 1, m_comm, &o_requests[1]);
+    MPI_Isend(io_field + getCoordinates(1, 1), 1, m_column, m_rank_left, 0, m_comm, &o_requests[2]);
+    MPI_Isend(io_field + getCoordinates(m_nCells_x, 1), 1, m_column, m_rank_right, 1, m_comm, &o_requests[3]);
+}
+
+void tsunami_lab::patches::WavePropagation2d_mpi::startExchangeRows(t_real *io_field,
+                                                                    MPI_Request o_requests[4])
+{
+    // first inner row to the top, last inner row to the bottom, the ghost columns are not needed
+    int l_count = m_nCells_x;
+    MPI_Irecv(io_field + getCoordinates(1, m_nCells_y + 1), l_count, MPI_FLOAT, m_rank_bottom, 2, m_comm, &o_requests[0]);
+    MPI_Irecv(io_field + getCoordinates(1, 0), l_count, MPI_FLOAT, m_rank_top, 3, m_comm, &o_requests[1]);
+    MPI_Isend(io_field + getCoordinates(1, 1), l_count, MPI_FLOAT, m_rank_top, 2, m_comm, &o_requests[2]);
+    MPI_Isend(io_field + getCoordinates(1, m_nCells_y), l_count, MPI_FLOAT, m_rank_bottom, 3, m_comm, &o_requests[3]);
+}
+
+void tsunami_lab::patches::WavePropagation2d_mpi::addCommunicationTime(std::chrono::high_resolution_clock::time_point i_posted,
+                                                                       std::chrono::high_resolution_clock::time_point i_arrived,
+                                                                       std::chrono::high_resolution_clock::time_point i_interiorDone)
+{
+    m_durationCommunicationStep += i_arrived - i_posted;
+    m_durationHiddenStep += std::min(i_arrived, i_interiorDone) - i_posted;
+}
+
+void tsunami_lab::patches::WavePropagation2d_mpi::setBoundaryColumns()
+{
+    t_real *l_h = m_h[m_step_h];
+    t_real *l_hu = m_hu[m_step_hu];
+    t_real *l_hv = m_hv[m_step_hv];
+
+    // ghost column, inner column, state and neighbor of both sides
+    t_idx l_ghost[2] = {0, m_nCells_x + 1};
+    t_idx l_inner[2] = {1, m_nCells_x};
+    int l_state[2] = {m_state_boundary_left, m_state_boundary_right};
+    int l_neighbor[2] = {m_rank_left, m_rank_right};
+
+    for (unsigned short l_si = 0; l_si < 2; l_si++)
+    {
+        if (l_neighbor[l_si] != MPI_PROC_NULL)
+        {
+            continue;
+        }
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
+        {
+            t_idx l_coord_ghost = getCoordinates(l_ghost[l_si], l_y);
+            t_idx l_coord_inner = getCoordinates(l_inner[l_si], l_y);
+            switch (l_state[l_si])
+            {
+            // open
+            case 0:
+                l_h[l_coord_ghost] = l_h[l_coord_inner];
+                l_hu[l_coord_ghost] = l_hu[l_coord_inner];
+                l_hv[l_coord_ghost] = l_hv[l_coord_inner];
+                m_b[l_coord_ghost] = m_b[l_coord_inner];
+                break;
+            // closed
+            case 1:
+                l_h[l_coord_ghost] = 0;
+                l_hu[l_coord_ghost] = 0;
+                l_hv[l_coord_ghost] = 0;
+                m_b[l_coord_ghost] = 25;
+                break;
+            default:
+                std::cerr << "undefined state for " << (l_si == 0 ? "left" : "right") << " boundary" << std::endl;
+                exit(EXIT_FAILURE);
+                break;
+            }
+        }
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2d_mpi::setBoundaryRows()
+{
+    t_real *l_h = m_h[m_step_h];
+    t_real *l_hu = m_hu[m_step_hu];
+    t_real *l_hv = m_hv[m_step_hv];
+
+    // ghost row, inner row, state and neighbor of both sides
+    t_idx l_ghost[2] = {0, m_nCells_y + 1};
+    t_idx l_inner[2] = {1, m_nCells_y};
+    int l_state[2] = {m_state_boundary_top, m_state_boundary_bottom};
+    int l_neighbor[2] = {m_rank_top, m_rank_bottom};
+
+    for (unsigned short l_si = 0; l_si < 2; l_si++)
+    {
+        if (l_neighbor[l_si] != MPI_PROC_NULL)
+        {
+            continue;
+        }
+        for (t_idx l_x = 1; l_x < m_nCells_x + 1; l_x++)
+        {
+            t_idx l_coord_ghost = getCoordinates(l_x, l_ghost[l_si]);
+            t_idx l_coord_inner = getCoordinates(l_x, l_inner[l_si]);
+            switch (l_state[l_si])
+            {
+            // open
+            case 0:
+                l_h[l_coord_ghost] = l_h[l_coord_inner];
+                l_hu[l_coord_ghost] = l_hu[l_coord_inner];
+                l_hv[l_coord_ghost] = l_hv[l_coord_inner];
+                m_b[l_coord_ghost] = m_b[l_coord_inner];
+                break;
+            // closed
+            case 1:
+                l_h[l_coord_ghost] = 0;
+                l_hu[l_coord_ghost] = 0;
+                l_hv[l_coord_ghost] = 0;
+                m_b[l_coord_ghost] = 25;
+                break;
+            default:
+                std::cerr << "undefined state for " << (l_si == 0 ? "top" : "bottom") << " boundary" << std::endl;
+                exit(EXIT_FAILURE);
+                break;
+            }
+        }
+    }
+}
+
+void tsunami_lab::patches::WavePropagation2d_mpi::setGhostOutflow()
+{
+    setBoundaryColumns();
+    setBoundaryRows();
+
+    // the columns are complete before the rows are sent, so that the corners are exchanged as well
+    MPI_Request l_requests[16];
+    t_real *l_fields[4] = {m_h[m_step_h], m_hu[m_step_hu], m_hv[m_step_hv], m_b};
+    for (unsigned short l_fi = 0; l_fi < 4; l_fi++)
+    {
+        startExchangeColumns(l_fields[l_fi], l_requests + 4 * l_fi);
+    }
+    MPI_Waitall(16, l_requests, MPI_STATUSES_IGNORE);
+    for (unsigned short l_fi = 0; l_fi < 4; l_fi++)
+    {
+        startExchangeRows(l_fields[l_fi], l_requests + 4 * l_fi);
+    }
+    MPI_Waitall(16, l_requests, MPI_STATUSES_IGNORE);
+    m_bathymetryChanged = false;
+}
+
+void tsunami_lab::patches::WavePropagation2d_mpi::timeStep(double i_scaling)
+{
+    typedef std::chrono::high_resolution_clock clock;
+
+    // the scaling is applied in the precision of the cells
+    t_real l_scaling = i_scaling;
+
+    // the bathymetry is static, its ghost cells are exchanged once after it was set
+    if (m_bathymetryChanged)
+    {
+        MPI_Request l_requests[4];
+        startExchangeColumns(m_b, l_requests);
+        MPI_Waitall(4, l_requests, MPI_STATUSES_IGNORE);
+        startExchangeRows(m_b, l_requests);
+        MPI_Waitall(4, l_requests, MPI_STATUSES_IGNORE);
+        m_bathymetryChanged = false;
+    }
+
+    m_durationCommunicationStep = std::chrono::nanoseconds::zero();
+    m_durationHiddenStep = std::chrono::nanoseconds::zero();
+
+    // requests of the halo exchange of a sweep, the first thread polls them while computing the interior
+    MPI_Request l_requests[8];
+    int l_arrived = 0;
+    clock::time_point l_posted, l_arrival, l_interiorDone;
+
+    //
+    // X-AXIS
+    //
+    setBoundaryColumns();
+    l_posted = clock::now();
+    startExchangeColumns(m_h[m_step_h], l_requests);
+    startExchangeColumns(m_hu[m_step_hu], l_requests + 4);
+    l_arrived = 0;
+
+    // pointers to old and new data, the momenta in y-direction are not changed by the x-sweep
+    t_real *l_hOld = m_h[m_step_h];
+    t_real *l_huOld = m_hu[m_step_hu];
+
+    m_step_h = (m_step_h + 1) % 2;
+    m_step_hu = (m_step_hu + 1) % 2;
+    t_real *l_hNew = m_h[m_step_h];
+    t_real *l_huNew = m_hu[m_step_hu];
+
+    // maximum wave speed of both sweeps
+    t_real l_speedMax = 0;
+
+#pragma omp parallel
+    {
+        // net-updates of the inner edges 1, ..., nx - 1 of a row: 0: left height, 1: left momentum, 2: right height, 3: right momentum
+        std::vector<t_real> l_netUpdates[4];
+        for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+        {
+            l_netUpdates[l_nu].resize(m_nCells_x);
+        }
+
+        // interior: the cells 2, ..., nx - 1 only depend on inner edges
+#pragma omp for schedule(static) reduction(max : l_speedMax)
+        for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
+        {
+            t_idx l_coord = getCoordinates(0, l_y);
+
+            l_speedMax = std::max(l_speedMax, solvers::FWave<>::netUpdatesBatch(m_nCells_x - 1,
+                                                                                l_hOld + l_coord + 1,
+                                                                                l_hOld + l_coord + 2,
+                                                                                l_huOld + l_coord + 1,
+                                                                                l_huOld + l_coord + 2,
+                                                                                m_b + l_coord + 1,
+                                                                                m_b + l_coord + 2,
+                                                                                l_netUpdates[0].data(),
+                                                                                l_netUpdates[1].data(),
+                                                                                l_netUpdates[2].data(),
+                                                                                l_netUpdates[3].data()));
+
+            // each cell gathers the right net-updates of edge x - 1 and the left net-updates of edge x, edge e is stored at e - 1
+#pragma omp simd
+            for (t_idx l_x = 2; l_x < m_nCells_x; l_x++)
+            {
+                l_hNew[l_coord + l_x] = l_hOld[l_coord + l_x] - l_scaling * l_netUpdates[2][l_x - 2] - l_scaling * l_netUpdates[0][l_x - 1];
+                l_huNew[l_coord + l_x] = l_huOld[l_coord + l_x] - l_scaling * l_netUpdates[3][l_x - 2] - l_scaling * l_netUpdates[1][l_x - 1];
+            }
+
+            // progress of the exchange, MPI is only called by the main thread
+            if (omp_get_thread_num() == 0 && !l_arrived)
+            {
+                MPI_Testall(8, l_requests, &l_arrived, MPI_STATUSES_IGNORE);
+                if (l_arrived)
+                {
+                    l_arrival = clock::now();
+                }
+            }
+        }
+    }
+    l_interiorDone = clock::now();
+    if (!l_arrived)
+    {
+        MPI_Waitall(8, l_requests, MPI_STATUSES_IGNORE);
+        l_arrival = clock::now();
+    }
+    addCommunicationTime(l_posted, l_arrival, l_interiorDone);
+
+    // boundary strip: the first and last cell of each row with the edges to the ghost cells
+#pragma omp parallel for schedule(static) reduction(max : l_speedMax)
+    for (t_idx l_y = 1; l_y < m_nCells_y + 1; l_y++)
+    {
+        t_real l_netUpdates[4][2];
+        t_idx l_cells[2] = {1, m_nCells_x};
+        for (unsigned short l_ci = 0; l_ci < 2; l_ci++)
+        {
+            // edges x - 1 and x of cell x
+            t_idx l_coord = getCoordinates(l_cells[l_ci] - 1, l_y);
+            l_speedMax = std::max(l_speedMax, solvers::FWave<>::netUpdatesBatch(2,
+                                                                                l_hOld + l_coord,
+                                                                                l_hOld + l_coord + 1,
+                                                                                l_huOld + l_coord,
+                                                                                l_huOld + l_coord + 1,
+                                                                                m_b + l_coord,
+                                                                                m_b + l_coord + 1,
+                                                                                l_netUpdates[0],
+                                                                                l_netUpdates[1],
+                                                                                l_netUpdates[2],
+                                                                                l_netUpdates[3]));
+            l_hNew[l_coord + 1] = l_hOld[l_coord + 1] - l_scaling * l_netUpdates[2][0] - l_scaling * l_netUpdates[0][1];
+            l_huNew[l_coord + 1] = l_huOld[l_coord + 1] - l_scaling * l_netUpdates[3][0] - l_scaling * l_netUpdates[1][1];
+        }
+    }
+
+    //
+    // Y-AXIS
+    //
+    setBoundaryRows();
+    l_posted = clock::now();
+    startExchangeRows(m_h[m_step_h], l_requests);
+    startExchangeRows(m_hv[m_step_hv], l_requests + 4);
+    l_arrived = 0;
+
+    // pointers to old and new data, the momenta in x-direction are not changed by the y-sweep
+    l_hOld = m_h[m_step_h];
+    t_real *l_hvOld = m_hv[m_step_hv];
+
+    m_step_h = (m_step_h + 1) % 2;
+    m_step_hv = (m_step_hv + 1) % 2;
+    l_hNew = m_h[m_step_h];
+    t_real *l_hvNew = m_hv[m_step_hv];
+
+#pragma omp parallel
+    {
+        // net-updates of the edges below and above a row: 0: down height, 1: down momentum, 2: up height, 3: up momentum
+        std::vector<t_real> l_netUpdatesBelow[4];
+        std::vector<t_real> l_netUpdatesAbove[4];
+        for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+        {
+            l_netUpdatesBelow[l_nu].resize(m_nCells_x);
+            l_netUpdatesAbove[l_nu].resize(m_nCells_x);
+        }
+
+        // row whose edges below are the edges above of the thread's previous row, the rows of a thread are contiguous
+        t_idx l_yNext = 0;
+
+        // interior: the rows 2, ..., ny - 1 only depend on inner edges
+#pragma omp for schedule(static) reduction(max : l_speedMax)
+        for (t_idx l_y = 2; l_y < m_nCells_y; l_y++)
+        {
+            if (l_y == l_yNext)
+            {
+                for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+                {
+                    l_netUpdatesBelow[l_nu].swap(l_netUpdatesAbove[l_nu]);
+                }
+            }
+            else
+            {
+                t_idx l_coord_down = getCoordinates(1, l_y - 1);
+                t_idx l_coord_up = getCoordinates(1, l_y);
+
+                l_speedMax = std::max(l_speedMax, solvers::FWave<>::netUpdatesBatch(m_nCells_x,
+                                                                                    l_hOld + l_coord_down,
+                                                                                    l_hOld + l_coord_up,
+                                                                                    l_hvOld + l_coord_down,
+                                                                                    l_hvOld + l_coord_up,
+                                                                                    m_b + l_coord_down,
+                                                                                    m_b + l_coord_up,
+                                                                                    l_netUpdatesBelow[0].data(),
+                                                                                    l_netUpdatesBelow[1].data(),
+                                                                                    l_netUpdatesBelow[2].data(),
+                                                                                    l_netUpdatesBelow[3].data()));
+            }
+            l_yNext = l_y + 1;
+
+            t_idx l_coord = getCoordinates(1, l_y);
+            t_idx l_coord_up = getCoordinates(1, l_y + 1);
+
+            l_speedMax = std::max(l_speedMax, solvers::FWave<>::netUpdatesBatch(m_nCells_x,
+                                                                                l_hOld + l_coord,
+                                                                                l_hOld + l_coord_up,
+                                                                                l_hvOld + l_coord,
+                                                                                l_hvOld + l_coord_up,
+                                                                                m_b + l_coord,
+                                                                                m_b + l_coord_up,
+                                                                                l_netUpdatesAbove[0].data(),
+                                                                                l_netUpdatesAbove[1].data(),
+                                                                                l_netUpdatesAbove[2].data(),
+                                                                                l_netUpdatesAbove[3].data()));
+
+            // each cell is the up cell of the edge below and the down cell of the edge above
+#pragma omp simd
+            for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+            {
+                l_hNew[l_coord + l_x] = l_hOld[l_coord + l_x] - l_scaling * l_netUpdatesBelow[2][l_x] - l_scaling * l_netUpdatesAbove[0][l_x];
+                l_hvNew[l_coord + l_x] = l_hvOld[l_coord + l_x] - l_scaling * l_netUpdatesBelow[3][l_x] - l_scaling * l_netUpdatesAbove[1][l_x];
+            }
+
+            // progress of the exchange, MPI is only called by the main thread
+            if (omp_get_thread_num() == 0 && !l_arrived)
+            {
+                MPI_Testall(8, l_requests, &l_arrived, MPI_STATUSES_IGNORE);
+                if (l_arrived)
+                {
+                    l_arrival = clock::now();
+                }
+            }
+        }
+    }
+    l_interiorDone = clock::now();
+    if (!l_arrived)
+    {
+        MPI_Waitall(8, l_requests, MPI_STATUSES_IGNORE);
+        l_arrival = clock::now();
+    }
+    addCommunicationTime(l_posted, l_arrival, l_interiorDone);
+
+    // boundary strip: the first and last row with the edges to the ghost rows, which coincide for a single row
+    t_idx l_rows[2] = {1, m_nCells_y};
+    unsigned short l_nRows = m_nCells_y > 1 ? 2 : 1;
+#pragma omp parallel for schedule(static) reduction(max : l_speedMax)
+    for (unsigned short l_ri = 0; l_ri < l_nRows; l_ri++)
+    {
+        std::vector<t_real> l_netUpdates[2][4];
+        for (unsigned short l_ei = 0; l_ei < 2; l_ei++)
+        {
+            // edges y - 1 and y of row y
+            t_idx l_coord_down = getCoordinates(1, l_rows[l_ri] - 1 + l_ei);
+            t_idx l_coord_up = getCoordinates(1, l_rows[l_ri] + l_ei);
+            for (unsigned short l_nu = 0; l_nu < 4; l_nu++)
+            {
+                l_netUpdates[l_ei][l_nu].resize(m_nCells_x);
+            }
+
+            l_speedMax = std::max(l_speedMax, solvers::FWave<>::netUpdatesBatch(m_nCells_x,
+                                                                                l_hOld + l_coord_down,
+                                                                                l_hOld + l_coord_up,
+                                                                                l_hvOld + l_coord_down,
+                                                                                l_hvOld + l_coord_up,
+                                                                                m_b + l_coord_down,
+                                                                                m_b + l_coord_up,
+                                                                                l_netUpdates[l_ei][0].data(),
+                                                                                l_netUpdates[l_ei][1].data(),
+                                                                                l_netUpdates[l_ei][2].data(),
+                                                                                l_netUpdates[l_ei][3].data()));
+        }
+
+        t_idx l_coord = getCoordinates(1, l_rows[l_ri]);
+        for (t_idx l_x = 0; l_x < m_nCells_x; l_x++)
+        {
+            l_hNew[l_coord + l_x] = l_hOld[l_coord + l_x] - l_scaling * l_netUpdates[0][2][l_x] - l_scaling * l_netUpdates[1][0][l_x];
+            l_hvNew[l_coord + l_x] = l_hvOld[l_coord + l_x] - l_scaling * l_netUpdates[0][3][l_x] - l_scaling * l_netUpdates[1][1][l_x];
+        }
+    }
+
+    m_durationCommunication += m_durationCommunicationStep;
+    m_durationHidden += m_durationHiddenStep;
+
+    // global reduction for the next time step
+    MPI_Allreduce(&l_speedMax, &m_maxWaveSpeed, 1, MPI_FLOAT, MPI_MAX, m_comm);
+}
+
+void tsunami_lab::patches::WavePropagation2d_mpi::setData(){};
+
+void tsunami_lab::patches::WavePropagation2d_mpi::getData(){};
@@ -0,0 +1,386 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Two-dimensional wave propagation patch, distributed with MPI.
+ **/
+#ifndef TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D_MPI
+#define TSUNAMI_LAB_PATCHES_WAVE_PROPAGATION_2D_MPI
+
+#include <mpi.h>
+#include <chrono>
+#include <string>
+
+#include "../WavePropagation.h"
+
+namespace tsunami_lab
+{
+    namespace patches
+    {
+        class WavePropagation2d_mpi;
+    }
+} // namespace tsunami_lab
+
+/**
+ * Two-dimensional wave propagation patch on the subdomain of a rank in a 2d Cartesian decomposition.
+ * Each rank stores its cells and one layer of ghost cells, which hold the cells of the neighboring ranks
+ * after the halo exchange before each sweep. Cell ids of the setters and getters are local to the rank.
+ **/
+class tsunami_lab::patches::WavePropagation2d_mpi : public WavePropagation
+{
+private:
+    //! current steps which indicate the active buffers of the height and the momenta below
+    unsigned short m_step_h = 0;
+    unsigned short m_step_hu = 0;
+    unsigned short m_step_hv = 0;
+
+    //! Cartesian communicator of the decomposition, dimension 0 is x, dimension 1 is y
+    MPI_Comm m_comm = MPI_COMM_NULL;
+
+    //! number of ranks in x- and y-direction
+    int m_dims[2] = {0, 0};
+
+    //! coordinates of the rank in the decomposition
+    int m_coords[2] = {0, 0};
+
+    //! neighboring ranks, MPI_PROC_NULL at the boundary of the domain
+    int m_rank_left = MPI_PROC_NULL;
+    int m_rank_right = MPI_PROC_NULL;
+    int m_rank_top = MPI_PROC_NULL;
+    int m_rank_bottom = MPI_PROC_NULL;
+
+    //! number of cells of the rank in x-direction
+    t_idx m_nCells_x = 0;
+
+    //! number of cells of the rank in y-direction
+    t_idx m_nCells_y = 0;
+
+    //! global id of the rank's first cell in x-direction
+    t_idx m_offset_x = 0;
+
+    //! global id of the rank's first cell in y-direction
+    t_idx m_offset_y = 0;
+
+    //! state of left boundary, 0 = open, 1 = closed
+    int m_state_boundary_left = 0;
+
+    //! state of right boundary, 0 = open, 1 = closed
+    int m_state_boundary_right = 0;
+
+    //! state of top boundary, 0 = open, 1 = closed
+    int m_state_boundary_top = 0;
+
+    //! state of bottom boundary, 0 = open, 1 = closed
+    int m_state_boundary_bottom = 0;
+
+    //! water heights for the current and next time step for all cells
+    t_real *m_h[2] = {nullptr, nullptr};
+
+    //! momenta for the current and next time step for all cells in x-direction
+    t_real *m_hu[2] = {nullptr, nullptr};
+
+    //! momenta for the current and next time step for all cells in y-direction
+    t_real *m_hv[2] = {nullptr, nullptr};
+
+    //! bathymetry for all cells
+    t_real *m_b = nullptr;
+
+    //! true if the bathymetry was set since the last exchange of its ghost cells
+    bool m_bathymetryChanged = true;
+
+    //! inner cells of a column, used to exchange the ghost columns
+    MPI_Datatype m_column = MPI_DATATYPE_NULL;
+
+    //! maximum wave speed of all ranks in the last time step
+    t_real m_maxWaveSpeed = 0;
+
+    //! time from posting the halo exchanges of a sweep to their arrival, summed over all time steps
+    std::chrono::nanoseconds m_durationCommunication = std::chrono::nanoseconds::zero();
+
+    //! part of the communication time which overlapped the computation of the interior, summed over all time steps
+    std::chrono::nanoseconds m_durationHidden = std::chrono::nanoseconds::zero();
+
+    //! communication and hidden communication time of the last time step
+    std::chrono::nanoseconds m_durationCommunicationStep = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds m_durationHiddenStep = std::chrono::nanoseconds::zero();
+
+    /**
+     * Gets the 2d Coordinates of the 1d array (x-y grid is being made flat into one line)
+     *
+     * @param i_x x-coordinate
+     * @param i_y y-coordinate
+     * @return t_idx index in 1d-array
+     */
+    t_idx getCoordinates(t_idx i_x, t_idx i_y)
+    {
+        return i_x + i_y * getStride();
+    };
+
+    /**
+     * Starts the non-blocking exchange of the ghost columns of a field with the left and right neighbors.
+     * The inner columns must not be written and the ghost columns not be read until the requests completed.
+     *
+     * @param io_field field whose ghost columns are received.
+     * @param o_requests will be set to the four requests of the exchange.
+     **/
+    void startExchangeColumns(t_real *io_field,
+                              MPI_Request o_requests[4]);
+
+    /**
+     * Starts the non-blocking exchange of the ghost rows of a field with the top and bottom neighbors.
+     * The inner rows must not be written and the ghost rows not be read until the requests completed.
+     *
+     * @param io_field field whose ghost rows are received.
+     * @param o_requests will be set to the four requests of the exchange.
+     **/
+    void startExchangeRows(t_real *io_field,
+                           MPI_Request o_requests[4]);
+
+    /**
+     * Adds the communication times of a sweep to the timers of the time step.
+     *
+     * @param i_posted time at which the exchanges were posted.
+     * @param i_arrived time at which the exchanges were found complete.
+     * @param i_interiorDone time at which the computation of the interior finished.
+     **/
+    void addCommunicationTime(std::chrono::high_resolution_clock::time_point i_posted,
+                              std::chrono::high_resolution_clock::time_point i_arrived,
+                              std::chrono::high_resolution_clock::time_point i_interiorDone);
+
+    /**
+     * Sets the ghost columns at the left and right boundary of the domain according to the boundary states.
+     **/
+    void setBoundaryColumns();
+
+    /**
+     * Sets the ghost rows at the top and bottom boundary of the domain according to the boundary states.
+     **/
+    void setBoundaryRows();
+
+public:
+    /**
+     * Constructs the distributed 2d wave propagation solver. Collective on the communicator.
+     *
+     * @param i_nCells_x number of cells of the whole domain in x-direction.
+     * @param i_nCells_y number of cells of the whole domain in y-direction.
+     * @param state_boundary_left type int, defines the state of the left boundary. Possible values: 0 = "open" and 1 = "closed".
+     * @param state_boundary_right type int, defines the state of the right boundary. Possible values: 0 = "open" and 1 = "closed".
+     * @param state_boundary_top type int, defines the state of the top boundary. Possible values: 0 = "open" and 1 = "closed".
+     * @param state_boundary_bottom type int, defines the state of the bottom boundary. Possible values: 0 = "open" and 1 = "closed".
+     * @param i_comm communicator of the ranks which share the domain.
+     **/
+    WavePropagation2d_mpi(t_idx i_nCells_x,
+                          t_idx i_nCells_y,
+                          int state_boundary_left,
+                          int state_boundary_right,
+                          int state_boundary_top,
+                          int state_boundary_bottom,
+                          MPI_Comm i_comm = MPI_COMM_WORLD);
+
+    /**
+     * Destructor which frees all allocated memory and the communicator.
+     **/
+    ~WavePropagation2d_mpi();
+
+    /**
+     * Performs a time step with dimensional splitting, and reduces the maximum wave speed over all ranks.
+     * In each sweep, the ghost cells are exchanged non-blocking while the edges which need no data of
+     * the neighbors are computed. The cells next to the ghost cells are finished after the exchange.
+     * Collective on the communicator.
+     *
+     * @param i_scaling scaling of the time step (dt / dx).
+     **/
+    void timeStep(double i_scaling);
+
+    /**
+     * Sets the values of all ghost cells: boundary conditions at the domain boundary, halo exchange otherwise.
+     * Collective on the communicator.
+     **/
+    void setGhostOutflow();
+
+    /**
+     * Gets the stride in y-direction. x-direction is stride-1.
+     *
+     * @return stride in y-direction.
+     **/
+    t_idx getStride()
+    {
+        return m_nCells_x + 2;
+    }
+
+    /**
+     * Gets the maximum absolute wave speed of the last time step over all ranks.
+     *
+     * @return maximum wave speed.
+     **/
+    double getMaxWaveSpeed()
+    {
+        return m_maxWaveSpeed;
+    }
+
+    /**
+     * Gets the time from posting the halo exchanges to their arrival, summed over both sweeps.
+     *
+     * @param i_lastStep true: time of the last time step, false: time summed over all time steps.
+     * @return communication time.
+     **/
+    std::chrono::nanoseconds getCommunicationTime(bool i_lastStep = false)
+    {
+        return i_lastStep ? m_durationCommunicationStep : m_durationCommunication;
+    }
+
+    /**
+     * Gets the part of the communication time which was hidden behind the computation of the interior.
+     *
+     * @param i_lastStep true: time of the last time step, false: time summed over all time steps.
+     * @return hidden communication time.
+     **/
+    std::chrono::nanoseconds getHiddenCommunicationTime(bool i_lastStep = false)
+    {
+        return i_lastStep ? m_durationHiddenStep : m_durationHidden;
+    }
+
+    /**
+     * Gets the number of cells of the rank in x-direction.
+     *
+     * @return number of cells.
+     **/
+    t_idx getNumberOfCellsX()
+    {
+        return m_nCells_x;
+    }
+
+    /**
+     * Gets the number of cells of the rank in y-direction.
+     *
+     * @return number of cells.
+     **/
+    t_idx getNumberOfCellsY()
+    {
+        return m_nCells_y;
+    }
+
+    /**
+     * Gets the global id of the rank's first cell in x-direction.
+     *
+     * @return global cell id.
+     **/
+    t_idx getOffsetX()
+    {
+        return m_offset_x;
+    }
+
+    /**
+     * Gets the global id of the rank's first cell in y-direction.
+     *
+     * @return global cell id.
+     **/
+    t_idx getOffsetY()
+    {
+        return m_offset_y;
+    }
+
+    /**
+     * Gets cells' water heights.
+     *
+     * @return water heights.
+     */
+    t_real const *getHeight()
+    {
+        return m_h[m_step_h];
+    }
+
+    /**
+     * Gets the cells' momenta in x-direction.
+     *
+     * @return momenta in x-direction.
+     **/
+    t_real const *getMomentumX()
+    {
+        return m_hu[m_step_hu];
+    }
+
+    /**
+     * Gets the cells' momenta in y-direction.
+     *
+     * @return momenta in y-direction.
+     **/
+    t_real const *getMomentumY()
+    {
+        return m_hv[m_step_hv];
+    }
+
+    /**
+     * Gets the cells' bathymetry.
+     *
+     * @return bathymetry.
+     **/
+    t_real const *getBathymetry()
+    {
+        return m_b;
+    }
+
+    /**
+     * Sets the height of the cell to the given value.
+     *
+     * @param i_ix local id of the cell in x-direction.
+     * @param i_iy local id of the cell in y-direction.
+     * @param i_h water height.
+     **/
+    void setHeight(t_idx i_ix,
+                   t_idx i_iy,
+                   double i_h)
+    {
+        m_h[m_step_h][getCoordinates(i_ix + 1, i_iy + 1)] = i_h;
+    }
+
+    /**
+     * Sets the momentum in x-direction to the given value.
+     *
+     * @param i_ix local id of the cell in x-direction.
+     * @param i_iy local id of the cell in y-direction.
+     * @param i_hu momentum in x-direction.
+     **/
+    void setMomentumX(t_idx i_ix,
+                      t_idx i_iy,
+                      double i_hu)
+    {
+        m_hu[m_step_hu][getCoordinates(i_ix + 1, i_iy + 1)] = i_hu;
+    }
+
+    /**
+     * Sets the momentum in y-direction to the given value.
+     *
+     * @param i_ix local id of the cell in x-direction.
+     * @param i_iy local id of the cell in y-direction.
+     * @param i_hv momentum in y-direction.
+     **/
+    void setMomentumY(t_idx i_ix,
+                      t_idx i_iy,
+                      double i_hv)
+    {
+        m_hv[m_step_hv][getCoordinates(i_ix + 1, i_iy + 1)] = i_hv;
+    }
+
+    /**
+     * Sets the bathymetry of the cell to the given value.
+     *
+     * @param i_ix local id of the cell in x-direction.
+     * @param i_iy local id of the cell in y-direction.
+     * @param i_b bathymetry.
+     **/
+    void setBathymetry(t_idx i_ix,
+                       t_idx i_iy,
+                       double i_b)
+    {
+        m_b[getCoordinates(i_ix + 1, i_iy + 1)] = i_b;
+        m_bathymetryChanged = true;
+    }
+
+    void setData();
+
+    void getData();
+};
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Unit tests for the distributed two-dimensional wave propagation patch, run with mpirun -np N.
+ **/
+
+#include <catch2/catch.hpp>
+#include <mpi.h>
+#include "WavePropagation2d_mpi.h"
+#include "../wavepropagation2d/WavePropagation2d.h"
+#include "../../constants.h"
+
+/**
+ * Runs a circular dam break with the serial and the distributed patch and compares the rank's subdomain bitwise.
+ *
+ * @param i_nx number of cells in x-direction.
+ * @param i_ny number of cells in y-direction.
+ **/
+static void compareWithSerial(tsunami_lab::t_idx i_nx,
+                              tsunami_lab::t_idx i_ny)
+{
+    tsunami_lab::t_idx l_nx = i_nx;
+    tsunami_lab::t_idx l_ny = i_ny;
+    tsunami_lab::patches::WavePropagation2d<> l_serial(l_nx, l_ny, 0, 1, 0, 1);
+    tsunami_lab::patches::WavePropagation2d_mpi l_distributed(l_nx, l_ny, 0, 1, 0, 1);
+
+    tsunami_lab::t_idx l_nx_local = l_distributed.getNumberOfCellsX();
+    tsunami_lab::t_idx l_ny_local = l_distributed.getNumberOfCellsY();
+    tsunami_lab::t_idx l_x0 = l_distributed.getOffsetX();
+    tsunami_lab::t_idx l_y0 = l_distributed.getOffsetY();
+
+    // the subdomains cover the domain exactly once
+    unsigned long l_nCells = l_nx_local * l_ny_local;
+    unsigned long l_nCellsGlobal = 0;
+    MPI_Allreduce(&l_nCells, &l_nCellsGlobal, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+    REQUIRE(l_nCellsGlobal == l_nx * l_ny);
+
+    for (tsunami_lab::t_idx l_cy = 0; l_cy < l_ny; l_cy++)
+    {
+        for (tsunami_lab::t_idx l_cx = 0; l_cx < l_nx; l_cx++)
+        {
+            tsunami_lab::t_real l_dx = tsunami_lab::t_real(l_cx) - tsunami_lab::t_real(l_nx) / 3;
+            tsunami_lab::t_real l_dy = tsunami_lab::t_real(l_cy) - tsunami_lab::t_real(l_ny) * 2 / 3;
+            tsunami_lab::t_real l_h = (l_dx * l_dx + l_dy * l_dy < tsunami_lab::t_real(l_nx * l_nx) / 36) ? 10 : 5;
+            tsunami_lab::t_real l_b = -20 + tsunami_lab::t_real(l_cx) * 0.1f;
+
+            l_serial.setHeight(l_cx, l_cy, l_h);
+            l_serial.setMomentumX(l_cx, l_cy, 0);
+            l_serial.setMomentumY(l_cx, l_cy, 0);
+            l_serial.setBathymetry(l_cx, l_cy, l_b);
+
+            if (l_cx >= l_x0 && l_cx < l_x0 + l_nx_local && l_cy >= l_y0 && l_cy < l_y0 + l_ny_local)
+            {
+                l_distributed.setHeight(l_cx - l_x0, l_cy - l_y0, l_h);
+                l_distributed.setMomentumX(l_cx - l_x0, l_cy - l_y0, 0);
+                l_distributed.setMomentumY(l_cx - l_x0, l_cy - l_y0, 0);
+                l_distributed.setBathymetry(l_cx - l_x0, l_cy - l_y0, l_b);
+            }
+        }
+    }
+
+    for (unsigned short l_st = 0; l_st < 50; l_st++)
+    {
+        l_serial.timeStep(0.05);
+        l_distributed.timeStep(0.05);
+    }
+
+    REQUIRE(l_distributed.getMaxWaveSpeed() == l_serial.getMaxWaveSpeed());
+
+    // the hidden part of the communication is part of the communication
+    REQUIRE(l_distributed.getHiddenCommunicationTime(true) <= l_distributed.getCommunicationTime(true));
+    REQUIRE(l_distributed.getHiddenCommunicationTime() <= l_distributed.getCommunicationTime());
+    REQUIRE(l_distributed.getCommunicationTime(true) <= l_distributed.getCommunicationTime());
+
+    tsunami_lab::t_idx l_stride = l_serial.getStride();
+    tsunami_lab::t_idx l_stride_local = l_distributed.getStride();
+    for (tsunami_lab::t_idx l_iy = 0; l_iy < l_ny_local; l_iy++)
+    {
+        for (tsunami_lab::t_idx l_ix = 0; l_ix < l_nx_local; l_ix++)
+        {
+            tsunami_lab::t_idx l_id = (l_x0 + l_ix + 1) + (l_y0 + l_iy + 1) * l_stride;
+            tsunami_lab::t_idx l_id_local = (l_ix + 1) + (l_iy + 1) * l_stride_local;
+
+            REQUIRE(l_distributed.getHeight()[l_id_local] == l_serial.getHeight()[l_id]);
+            REQUIRE(l_distributed.getMomentumX()[l_id_local] == l_serial.getMomentumX()[l_id]);
+            REQUIRE(l_distributed.getMomentumY()[l_id_local] == l_serial.getMomentumY()[l_id]);
+        }
+    }
+}
+
+TEST_CASE("Test the distributed 2d wave propagation against the serial patch.", "[WaveProp2dMpi]")
+{
+    /*
+     * Test case:
+     *
+     *   Circular dam break over a sloped bathymetry with open boundaries on the left and top
+     *   and closed boundaries on the right and bottom.
+     *
+     *   Every rank runs the serial patch on the whole domain and compares its subdomain bitwise.
+     *   The small domain leaves single cells, rows and columns to the ranks, so that the interior
+     *   is empty and the boundary strip covers all cells.
+     */
+    compareWithSerial(37, 29);
+    compareWithSerial(3, 2);
+}
@@ -0,0 +1,33 @@
+/**
+ * @author Maurice Herold (maurice.herold AT uni-jena.de)
+ * @author Mher Mnatsakanyan (mher.mnatsakanyan AT uni-jena.de)
+ *
+ * @section DESCRIPTION
+ * Simulation setup.
+ **/
+#include "Setup.h"
+
+void tsunami_lab::setups::Setup::fill(Region const &i_region,
+                                      t_real *o_h,
+                                      t_real *o_hu,
+                                      t_real *o_hv,
+                                      t_real *o_b,
+                                      t_idx i_stride) const
+{
+#pragma omp parallel for schedule(static)
+  for (t_idx l_iy = 0; l_iy < i_region.m_ny; l_iy++)
+  {
+    t_real l_y = (i_region.m_iy0 + l_iy) * i_region.m_dxy - i_region.m_y_offset;
+
+    for (t_idx l_ix = 0; l_ix < i_region.m_nx; l_ix++)
+    {
+      t_real l_x = (i_region.m_ix0 + l_ix) * i_region.m_dxy - i_region.m_x_offset;
+      t_idx l_id = l_ix + l_iy * i_stride;
+
+      o_h[l_id] = getHeight(l_x, l_y);
+      o_hu[l_id] = getMomentumX(l_x, l_y);
+      o_hv[l_id] = getMomentumY(l_x, l_y);
+      o_b[l_id] = getBathymetry(l_x, l_y);
+    }
+  }
+}
@@ -23,11 +23,58 @@ namespace tsunami_lab
 class tsunami_lab::setups::Setup
 {
 public:
+  /**
+   * Rectangular region of cells, whose cell (ix, iy) is queried at the point
+   * x = (m_ix0 + ix) * m_dxy - m_x_offset, y = (m_iy0 + iy) * m_dxy - m_y_offset.
+   **/
+  struct Region
+  {
+    //! id of the region's first cell in x-direction
+    t_idx m_ix0;
+
+    //! id of the region's first cell in y-direction
+    t_idx m_iy0;
+
+    //! number of cells in x-direction
+    t_idx m_nx;
+
+    //! number of cells in y-direction
+    t_idx m_ny;
+
+    //! cell width in x- and y-direction
+    t_real m_dxy;
+
+    //! offset of the coordinates in x-direction
+    t_real m_x_offset;
+
+    //! offset of the coordinates in y-direction
+    t_real m_y_offset;
+  };
+
   /**
    * Virtual destructor for base class.
    **/
   virtual ~Setup(){};
 
+  /**
+   * Fills the initial values of all cells of a region. The rows are filled in parallel.
+   * The default implementation queries the getters for each cell; setups override it to share work between
+   * the quantities and cells.
+   *
+   * @param i_region region of cells.
+   * @param o_h will be set to the water heights, cell (ix, iy) at ix + iy * i_stride.
+   * @param o_hu will be set to the momenta in x-direction.
+   * @param o_hv will be set to the momenta in y-direction.
+   * @param o_b will be set to the bathymetry.
+   * @param i_stride stride of the output arrays in y-direction.
+   **/
+  virtual void fill(Region const &i_region,
+                    t_real *o_h,
+                    t_real *o_hu,
+                    t_real *o_hv,
+                    t_real *o_b,
+                    t_idx i_stride) const;
+
   /**
    * Gets the water height at a given point.
    *
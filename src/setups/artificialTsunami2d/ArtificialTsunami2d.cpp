@@ -7,6 +7,8 @@
  **/
 #include "ArtificialTsunami2d.h"
 
+#include <vector>
+
 tsunami_lab::t_real tsunami_lab::setups::ArtificialTsunami2d::getHeight(t_real,
                                                                         t_real) const
 {
@@ -40,3 +42,42 @@ tsunami_lab::t_real tsunami_lab::setups::ArtificialTsunami2d::getDisplacement(t_
   }
   return 0;
 }
+
+void tsunami_lab::setups::ArtificialTsunami2d::fill(Region const &i_region,
+                                                    t_real *o_h,
+                                                    t_real *o_hu,
+                                                    t_real *o_hv,
+                                                    t_real *o_b,
+                                                    t_idx i_stride) const
+{
+  // f only depends on x and is shared by all rows
+  std::vector<t_real> l_f(i_region.m_nx);
+  std::vector<unsigned char> l_inX(i_region.m_nx);
+  for (t_idx l_ix = 0; l_ix < i_region.m_nx; l_ix++)
+  {
+    t_real l_x = (i_region.m_ix0 + l_ix) * i_region.m_dxy - i_region.m_x_offset;
+    l_f[l_ix] = f(l_x, 0);
+    l_inX[l_ix] = l_x >= -500 && l_x <= 500;
+  }
+
+#pragma omp parallel for schedule(static)
+  for (t_idx l_iy = 0; l_iy < i_region.m_ny; l_iy++)
+  {
+    t_real l_y = (i_region.m_iy0 + l_iy) * i_region.m_dxy - i_region.m_y_offset;
+    t_real l_g = g(0, l_y);
+    bool l_inY = l_y >= -500 && l_y <= 500;
+    t_idx l_row = l_iy * i_stride;
+
+    // same expressions as getHeight, getBathymetry and getDisplacement
+#pragma omp simd
+    for (t_idx l_ix = 0; l_ix < i_region.m_nx; l_ix++)
+    {
+      t_real l_displacement = (l_inY && l_inX[l_ix]) ? 5 * l_f[l_ix] * l_g : 0;
+
+      o_h[l_row + l_ix] = 100;
+      o_hu[l_row + l_ix] = 0;
+      o_hv[l_row + l_ix] = 0;
+      o_b[l_row + l_ix] = -100 + l_displacement;
+    }
+  }
+}
@@ -8,6 +8,7 @@
 #include <catch2/catch.hpp>
 #include "ArtificialTsunami2d.h"
 #include "./../../io/csv/Csv.h"
+#include <vector>
 
 TEST_CASE("Test the one-dimensional ArtificialTsunami2d setup.", "[ArtificialTsunami2d]")
 {
@@ -46,4 +47,33 @@ TEST_CASE("Test the one-dimensional ArtificialTsunami2d setup.", "[ArtificialTsu
     REQUIRE(l_tsunamievent.getMomentumX(100, 100) == 0);
     REQUIRE(l_tsunamievent.getMomentumY(100, 100) == 0);
     REQUIRE(l_tsunamievent.getBathymetry(100, 100) == Approx(-102.821369211004));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test the bulk fill of the ArtificialTsunami2d setup.", "[ArtificialTsunami2dFill]")
+{
+    tsunami_lab::setups::ArtificialTsunami2d l_tsunamievent;
+
+    // region reaching beyond the displacement in both directions
+    tsunami_lab::setups::Setup::Region l_region = {0, 0, 120, 110, 10, 600, 550};
+    std::vector<tsunami_lab::t_real> l_h(l_region.m_nx * l_region.m_ny);
+    std::vector<tsunami_lab::t_real> l_hu(l_region.m_nx * l_region.m_ny);
+    std::vector<tsunami_lab::t_real> l_hv(l_region.m_nx * l_region.m_ny);
+    std::vector<tsunami_lab::t_real> l_b(l_region.m_nx * l_region.m_ny);
+
+    l_tsunamievent.fill(l_region, l_h.data(), l_hu.data(), l_hv.data(), l_b.data(), l_region.m_nx);
+
+    for (tsunami_lab::t_idx l_iy = 0; l_iy < l_region.m_ny; l_iy++)
+    {
+        tsunami_lab::t_real l_y = (l_region.m_iy0 + l_iy) * l_region.m_dxy - l_region.m_y_offset;
+        for (tsunami_lab::t_idx l_ix = 0; l_ix < l_region.m_nx; l_ix++)
+        {
+            tsunami_lab::t_real l_x = (l_region.m_ix0 + l_ix) * l_region.m_dxy - l_region.m_x_offset;
+            tsunami_lab::t_idx l_id = l_ix + l_iy * l_region.m_nx;
+
+            REQUIRE(l_h[l_id] == l_tsunamievent.getHeight(l_x, l_y));
+            REQUIRE(l_hu[l_id] == l_tsunamievent.getMomentumX(l_x, l_y));
+            REQUIRE(l_hv[l_id] == l_tsunamievent.getMomentumY(l_x, l_y));
+            REQUIRE(l_b[l_id] == l_tsunamievent.getBathymetry(l_x, l_y));
+        }
+    }
+}
@@ -51,4 +51,37 @@ tsunami_lab::t_real tsunami_lab::setups::DamBreak2d::getBathymetry(t_real i_x,
   {
     return -10;
   }
-}
\ No newline at end of file
+}
+
+void tsunami_lab::setups::DamBreak2d::fill(Region const &i_region,
+                                           t_real *o_h,
+                                           t_real *o_hu,
+                                           t_real *o_hv,
+                                           t_real *o_b,
+                                           t_idx i_stride) const
+{
+#pragma omp parallel for schedule(static)
+  for (t_idx l_iy = 0; l_iy < i_region.m_ny; l_iy++)
+  {
+    t_real l_y = (i_region.m_iy0 + l_iy) * i_region.m_dxy - i_region.m_y_offset;
+    t_real l_dy = l_y - 50;
+    bool l_rowOnCylinder = l_y - 10 < 5 && l_y - 10 > -5;
+    t_idx l_row = l_iy * i_stride;
+
+#pragma omp simd
+    for (t_idx l_ix = 0; l_ix < i_region.m_nx; l_ix++)
+    {
+      t_real l_x = (i_region.m_ix0 + l_ix) * i_region.m_dxy - i_region.m_x_offset;
+      t_real l_dx = l_x - 50;
+
+      // same conditions as getBathymetry and getHeight
+      bool l_onCylinder = l_rowOnCylinder && l_x - 10 < 5 && l_x - 10 > -5;
+      t_real l_h = std::sqrt(l_dx * l_dx + l_dy * l_dy) < 10 ? 10 : 5;
+
+      o_b[l_row + l_ix] = l_onCylinder ? 10 : -10;
+      o_h[l_row + l_ix] = l_onCylinder ? 0 : l_h;
+      o_hu[l_row + l_ix] = 0;
+      o_hv[l_row + l_ix] = 0;
+    }
+  }
+}
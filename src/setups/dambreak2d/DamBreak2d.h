@@ -58,6 +58,24 @@ public:
    */
   t_real getBathymetry(t_real i_x,
                        t_real i_y) const;
+
+  /**
+   * Fills the initial values of all cells of a region, see Setup::fill.
+   * The bathymetry is derived once per cell and the loop over a row is vectorized.
+   *
+   * @param i_region region of cells.
+   * @param o_h will be set to the water heights.
+   * @param o_hu will be set to the momenta in x-direction.
+   * @param o_hv will be set to the momenta in y-direction.
+   * @param o_b will be set to the bathymetry.
+   * @param i_stride stride of the output arrays in y-direction.
+   **/
+  void fill(Region const &i_region,
+            t_real *o_h,
+            t_real *o_hu,
+            t_real *o_hv,
+            t_real *o_b,
+            t_idx i_stride) const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -8,6 +8,7 @@
 #include <catch2/catch.hpp>
 #include "DamBreak2d.h"
 #include <iostream>
+#include <vector>
 
 TEST_CASE("Test the two-dimensional dam break setup.", "[DamBreak2d]")
 {
@@ -33,4 +34,45 @@ TEST_CASE("Test the two-dimensional dam break setup.", "[DamBreak2d]")
 
   // on batometry-cylinder
   REQUIRE(l_damBreak.getBathymetry(10, 10) == 10);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test the bulk fill of the two-dimensional dam break setup.", "[DamBreak2dFill]")
+{
+  tsunami_lab::setups::DamBreak2d l_damBreak;
+
+  // region around the dam and the bathymetry cylinder, stored with a padded stride
+  tsunami_lab::setups::Setup::Region l_region = {3, 7, 90, 70, 1.5, 20, 30};
+  tsunami_lab::t_idx l_stride = 93;
+  std::vector<tsunami_lab::t_real> l_h(l_stride * l_region.m_ny);
+  std::vector<tsunami_lab::t_real> l_hu(l_stride * l_region.m_ny);
+  std::vector<tsunami_lab::t_real> l_hv(l_stride * l_region.m_ny);
+  std::vector<tsunami_lab::t_real> l_b(l_stride * l_region.m_ny);
+
+  // the overridden and the default fill match the getters bitwise
+  for (int l_pass = 0; l_pass < 2; l_pass++)
+  {
+    if (l_pass == 0)
+    {
+      l_damBreak.fill(l_region, l_h.data(), l_hu.data(), l_hv.data(), l_b.data(), l_stride);
+    }
+    else
+    {
+      l_damBreak.tsunami_lab::setups::Setup::fill(l_region, l_h.data(), l_hu.data(), l_hv.data(), l_b.data(), l_stride);
+    }
+
+    for (tsunami_lab::t_idx l_iy = 0; l_iy < l_region.m_ny; l_iy++)
+    {
+      tsunami_lab::t_real l_y = (l_region.m_iy0 + l_iy) * l_region.m_dxy - l_region.m_y_offset;
+      for (tsunami_lab::t_idx l_ix = 0; l_ix < l_region.m_nx; l_ix++)
+      {
+        tsunami_lab::t_real l_x = (l_region.m_ix0 + l_ix) * l_region.m_dxy - l_region.m_x_offset;
+        tsunami_lab::t_idx l_id = l_ix + l_iy * l_stride;
+
+        REQUIRE(l_h[l_id] == l_damBreak.getHeight(l_x, l_y));
+        REQUIRE(l_hu[l_id] == l_damBreak.getMomentumX(l_x, l_y));
+        REQUIRE(l_hv[l_id] == l_damBreak.getMomentumY(l_x, l_y));
+        REQUIRE(l_b[l_id] == l_damBreak.getBathymetry(l_x, l_y));
+      }
+    }
+  }
+}
@@ -7,13 +7,18 @@
  **/
 #include "TsunamiEvent2d.h"
 #include "../../io/netCDF/NetCDF.h"
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 tsunami_lab::setups::TsunamiEvent2d::~TsunamiEvent2d()
 {
-  delete[] m_bathymetry_values_x;
-  delete[] m_bathymetry_values_y;
-  delete[] m_bathymetry;
+  if (m_ownsBathymetry)
+  {
+    delete[] m_bathymetry_values_x;
+    delete[] m_bathymetry_values_y;
+    delete[] m_bathymetry;
+  }
   delete[] m_displacement_values_x;
   delete[] m_displacement_values_y;
   delete[] m_displacement;
@@ -59,11 +64,99 @@ tsunami_lab::setups::TsunamiEvent2d::TsunamiEvent2d(std::string bat_path,
   delete netCDF;
 }
 
+tsunami_lab::setups::TsunamiEvent2d::TsunamiEvent2d(TsunamiEvent2d const &i_shared,
+                                                    std::string dis_path)
+{
+  tsunami_lab::io::NetCdf *netCDF = nullptr;
+
+  netCDF = new tsunami_lab::io::NetCdf();
+
+  shareBathymetry(i_shared);
+
+  netCDF->read(&m_displacement_length_x,
+               &m_displacement_length_y,
+               &m_displacement_values_x,
+               &m_displacement_values_y,
+               &m_displacement,
+               dis_path);
+
+  delete netCDF;
+}
+
+tsunami_lab::setups::TsunamiEvent2d::TsunamiEvent2d(t_idx i_bathymetry_length_x,
+                                                    t_idx i_bathymetry_length_y,
+                                                    t_real const *i_bathymetry_values_x,
+                                                    t_real const *i_bathymetry_values_y,
+                                                    t_real const *i_bathymetry,
+                                                    t_idx i_displacement_length_x,
+                                                    t_idx i_displacement_length_y,
+                                                    t_real const *i_displacement_values_x,
+                                                    t_real const *i_displacement_values_y,
+                                                    t_real const *i_displacement)
+{
+  m_bathymetry_length_x = i_bathymetry_length_x;
+  m_bathymetry_length_y = i_bathymetry_length_y;
+  m_bathymetry_values_x = copyValues(i_bathymetry_values_x, i_bathymetry_length_x);
+  m_bathymetry_values_y = copyValues(i_bathymetry_values_y, i_bathymetry_length_y);
+  m_bathymetry = copyValues(i_bathymetry, i_bathymetry_length_x * i_bathymetry_length_y);
+
+  m_displacement_length_x = i_displacement_length_x;
+  m_displacement_length_y = i_displacement_length_y;
+  m_displacement_values_x = copyValues(i_displacement_values_x, i_displacement_length_x);
+  m_displacement_values_y = copyValues(i_displacement_values_y, i_displacement_length_y);
+  m_displacement = copyValues(i_displacement, i_displacement_length_x * i_displacement_length_y);
+
+  m_x_offset = m_bathymetry_values_x[0];
+  m_y_offset = m_bathymetry_values_y[0];
+}
+
+tsunami_lab::setups::TsunamiEvent2d::TsunamiEvent2d(TsunamiEvent2d const &i_shared,
+                                                    t_idx i_displacement_length_x,
+                                                    t_idx i_displacement_length_y,
+                                                    t_real const *i_displacement_values_x,
+                                                    t_real const *i_displacement_values_y,
+                                                    t_real const *i_displacement)
+{
+  shareBathymetry(i_shared);
+
+  m_displacement_length_x = i_displacement_length_x;
+  m_displacement_length_y = i_displacement_length_y;
+  m_displacement_values_x = copyValues(i_displacement_values_x, i_displacement_length_x);
+  m_displacement_values_y = copyValues(i_displacement_values_y, i_displacement_length_y);
+  m_displacement = copyValues(i_displacement, i_displacement_length_x * i_displacement_length_y);
+}
+
+tsunami_lab::t_real *tsunami_lab::setups::TsunamiEvent2d::copyValues(t_real const *i_values,
+                                                                     t_idx i_size)
+{
+  t_real *l_copy = new t_real[i_size];
+  std::copy(i_values, i_values + i_size, l_copy);
+  return l_copy;
+}
+
+void tsunami_lab::setups::TsunamiEvent2d::shareBathymetry(TsunamiEvent2d const &i_shared)
+{
+  m_delta = i_shared.m_delta;
+  m_bathymetry_length_x = i_shared.m_bathymetry_length_x;
+  m_bathymetry_length_y = i_shared.m_bathymetry_length_y;
+  m_bathymetry_values_x = i_shared.m_bathymetry_values_x;
+  m_bathymetry_values_y = i_shared.m_bathymetry_values_y;
+  m_bathymetry = i_shared.m_bathymetry;
+  m_x_offset = i_shared.m_x_offset;
+  m_y_offset = i_shared.m_y_offset;
+  m_ownsBathymetry = false;
+  m_displaceSurface = true;
+}
+
 tsunami_lab::t_real tsunami_lab::setups::TsunamiEvent2d::getHeight(t_real i_x,
                                                                    t_real i_y) const
 {
   t_real l_b_in = getBathymetryFromNetCdf(i_x, i_y);
-  if (l_b_in < 0)
+  if (l_b_in < 0 && m_displaceSurface)
+  {
+    return std::max(std::max(-l_b_in, m_delta) + getDisplacement(i_x, i_y), t_real(0));
+  }
+  else if (l_b_in < 0)
   {
     return std::max(-l_b_in, m_delta);
   }
@@ -90,7 +183,11 @@ tsunami_lab::t_real tsunami_lab::setups::TsunamiEvent2d::getBathymetry(t_real i_
 {
   t_real l_b_in = getBathymetryFromNetCdf(i_x, i_y);
 
-  if (l_b_in < 0)
+  if (m_displaceSurface)
+  {
+    return l_b_in < 0 ? std::min(l_b_in, -m_delta) : std::max(l_b_in, m_delta);
+  }
+  else if (l_b_in < 0)
   {
     return std::min(l_b_in, -m_delta) + getDisplacement(i_x, i_y);
   }
@@ -141,4 +238,79 @@ tsunami_lab::t_real tsunami_lab::setups::TsunamiEvent2d::getBathymetryFromNetCdf
   t_idx l_y = (i_y - m_y_offset) / l_dxy;
 
   return m_bathymetry[l_y * m_bathymetry_length_x + l_x];
-}
\ No newline at end of file
+}
+
+void tsunami_lab::setups::TsunamiEvent2d::fill(Region const &i_region,
+                                               t_real *o_h,
+                                               t_real *o_hu,
+                                               t_real *o_hv,
+                                               t_real *o_b,
+                                               t_idx i_stride) const
+{
+  t_real l_dxy_bathymetry = m_bathymetry_values_x[1] - m_bathymetry_values_x[0];
+  t_real l_dxy_displacement = m_displacement_values_x[1] - m_displacement_values_x[0];
+
+  // lookup columns of the bathymetry and displacement, same conditions and indices as the getters
+  std::vector<t_idx> l_colBathymetry(i_region.m_nx, 0);
+  std::vector<t_idx> l_colDisplacement(i_region.m_nx, 0);
+  std::vector<unsigned char> l_inBathymetry(i_region.m_nx, 0);
+  std::vector<unsigned char> l_inDisplacement(i_region.m_nx, 0);
+  for (t_idx l_ix = 0; l_ix < i_region.m_nx; l_ix++)
+  {
+    t_real l_x = (i_region.m_ix0 + l_ix) * i_region.m_dxy - i_region.m_x_offset;
+    if (l_x >= m_bathymetry_values_x[0] && l_x <= m_bathymetry_values_x[m_bathymetry_length_x - 1])
+    {
+      l_inBathymetry[l_ix] = 1;
+      l_colBathymetry[l_ix] = (l_x - m_x_offset) / l_dxy_bathymetry;
+    }
+    if (l_x >= m_displacement_values_x[0] && l_x <= m_displacement_values_x[m_displacement_length_x - 1])
+    {
+      l_inDisplacement[l_ix] = 1;
+      l_colDisplacement[l_ix] = (l_x - m_displacement_values_x[0]) / l_dxy_displacement;
+    }
+  }
+
+#pragma omp parallel for schedule(static)
+  for (t_idx l_iy = 0; l_iy < i_region.m_ny; l_iy++)
+  {
+    t_real l_y = (i_region.m_iy0 + l_iy) * i_region.m_dxy - i_region.m_y_offset;
+
+    // lookup rows, a row outside of the data reads no values
+    bool l_rowBathymetry = l_y >= m_bathymetry_values_y[0] && l_y <= m_bathymetry_values_y[m_bathymetry_length_y - 1];
+    bool l_rowDisplacement = l_y >= m_displacement_values_y[0] && l_y <= m_displacement_values_y[m_displacement_length_y - 1];
+    t_real const *l_bathymetry = m_bathymetry;
+    t_real const *l_displacement = m_displacement;
+    if (l_rowBathymetry)
+    {
+      t_idx l_rowId = (l_y - m_y_offset) / l_dxy_bathymetry;
+      l_bathymetry += l_rowId * m_bathymetry_length_x;
+    }
+    if (l_rowDisplacement)
+    {
+      t_idx l_rowId = (l_y - m_displacement_values_y[0]) / l_dxy_displacement;
+      l_displacement += l_rowId * m_displacement_length_x;
+    }
+    t_idx l_row = l_iy * i_stride;
+
+#pragma omp simd
+    for (t_idx l_ix = 0; l_ix < i_region.m_nx; l_ix++)
+    {
+      t_real l_b_in = (l_rowBathymetry && l_inBathymetry[l_ix]) ? l_bathymetry[l_colBathymetry[l_ix]] : 0;
+      t_real l_d = (l_rowDisplacement && l_inDisplacement[l_ix]) ? l_displacement[l_colDisplacement[l_ix]] : 0;
+
+      // same expressions as getHeight and getBathymetry
+      if (m_displaceSurface)
+      {
+        o_h[l_row + l_ix] = l_b_in < 0 ? std::max(std::max(-l_b_in, m_delta) + l_d, t_real(0)) : 0;
+        o_b[l_row + l_ix] = l_b_in < 0 ? std::min(l_b_in, -m_delta) : std::max(l_b_in, m_delta);
+      }
+      else
+      {
+        o_h[l_row + l_ix] = l_b_in < 0 ? std::max(-l_b_in, m_delta) : 0;
+        o_b[l_row + l_ix] = (l_b_in < 0 ? std::min(l_b_in, -m_delta) : std::max(l_b_in, m_delta)) + l_d;
+      }
+      o_hu[l_row + l_ix] = 0;
+      o_hv[l_row + l_ix] = 0;
+    }
+  }
+}
@@ -61,6 +61,12 @@ private:
   t_real m_x_offset;
   t_real m_y_offset;
 
+  //! true if the bathymetry belongs to this setup, false if it is shared with another one
+  bool m_ownsBathymetry = true;
+
+  //! true if the displacement raises the water surface instead of the seafloor
+  bool m_displaceSurface = false;
+
   /**
    * @brief Get initial displacement
    *
@@ -82,6 +88,23 @@ private:
   t_real getBathymetryFromNetCdf(t_real i_x,
                                  t_real i_y) const;
 
+  /**
+   * Copies values into a new array.
+   *
+   * @param i_values values.
+   * @param i_size number of values.
+   * @return copy, freed with delete[].
+   */
+  static t_real *copyValues(t_real const *i_values,
+                            t_idx i_size);
+
+  /**
+   * Takes the bathymetry of another event without copying it.
+   *
+   * @param i_shared event whose bathymetry is used, has to outlive this one.
+   */
+  void shareBathymetry(TsunamiEvent2d const &i_shared);
+
 public:
   /**
    * @brief Construct a new TsunamiEvent1d object
@@ -94,6 +117,64 @@ public:
                  t_real *o_x_offset,
                  t_real *o_y_offset);
 
+  /**
+   * @brief Construct an event from a bathymetry and a displacement in memory, e.g. a small test case.
+   * Both are given on equidistant grids with the coordinates of their columns and rows, like read from the netCDF files.
+   * The values are copied.
+   *
+   * @param i_bathymetry_length_x number of columns of the bathymetry.
+   * @param i_bathymetry_length_y number of rows of the bathymetry.
+   * @param i_bathymetry_values_x x-coordinates of the columns of the bathymetry.
+   * @param i_bathymetry_values_y y-coordinates of the rows of the bathymetry.
+   * @param i_bathymetry bathymetry, row by row.
+   * @param i_displacement_length_x number of columns of the displacement.
+   * @param i_displacement_length_y number of rows of the displacement.
+   * @param i_displacement_values_x x-coordinates of the columns of the displacement.
+   * @param i_displacement_values_y y-coordinates of the rows of the displacement.
+   * @param i_displacement displacement, row by row.
+   */
+  TsunamiEvent2d(t_idx i_bathymetry_length_x,
+                 t_idx i_bathymetry_length_y,
+                 t_real const *i_bathymetry_values_x,
+                 t_real const *i_bathymetry_values_y,
+                 t_real const *i_bathymetry,
+                 t_idx i_displacement_length_x,
+                 t_idx i_displacement_length_y,
+                 t_real const *i_displacement_values_x,
+                 t_real const *i_displacement_values_y,
+                 t_real const *i_displacement);
+
+  /**
+   * @brief Construct a scenario which shares the bathymetry of another event, e.g. a member of an ensemble.
+   * The displacement is applied to the water surface instead of the seafloor, such that all scenarios
+   * sharing the bathymetry have the same bathymetry in the simulation. The patches of ensemble members
+   * share the bathymetry as well and ignore the bathymetry set from such a scenario, see
+   * WavePropagation2d::setBathymetry.
+   *
+   * @param i_shared event whose bathymetry is used, has to outlive this one.
+   * @param dis_path path of the displacement.
+   */
+  TsunamiEvent2d(TsunamiEvent2d const &i_shared,
+                 std::string dis_path);
+
+  /**
+   * @brief Construct a scenario which shares the bathymetry of another event with a displacement in memory.
+   * The displacement is applied to the water surface like for a displacement read from a file, its values are copied.
+   *
+   * @param i_shared event whose bathymetry is used, has to outlive this one.
+   * @param i_displacement_length_x number of columns of the displacement.
+   * @param i_displacement_length_y number of rows of the displacement.
+   * @param i_displacement_values_x x-coordinates of the columns of the displacement.
+   * @param i_displacement_values_y y-coordinates of the rows of the displacement.
+   * @param i_displacement displacement, row by row.
+   */
+  TsunamiEvent2d(TsunamiEvent2d const &i_shared,
+                 t_idx i_displacement_length_x,
+                 t_idx i_displacement_length_y,
+                 t_real const *i_displacement_values_x,
+                 t_real const *i_displacement_values_y,
+                 t_real const *i_displacement);
+
   /**
    * @brief Destroy the Tsunami Event 2d object
    *
@@ -135,6 +216,25 @@ public:
    */
   t_real getBathymetry(t_real i_x,
                        t_real i_y) const;
+
+  /**
+   * Fills the initial values of all cells of a region, see Setup::fill.
+   * The bathymetry is looked up once per cell for both the height and the bathymetry, and
+   * the lookup indices are computed once per column and row.
+   *
+   * @param i_region region of cells.
+   * @param o_h will be set to the water heights.
+   * @param o_hu will be set to the momenta in x-direction.
+   * @param o_hv will be set to the momenta in y-direction.
+   * @param o_b will be set to the bathymetry.
+   * @param i_stride stride of the output arrays in y-direction.
+   **/
+  void fill(Region const &i_region,
+            t_real *o_h,
+            t_real *o_hu,
+            t_real *o_hv,
+            t_real *o_b,
+            t_idx i_stride) const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -6,48 +6,200 @@
  * Two-dimensional tsunamievent problem.
  **/
 #include <catch2/catch.hpp>
+#include <vector>
 #include "TsunamiEvent2d.h"
-#include "./../../io/csv/Csv.h"
 
-TEST_CASE("Test the one-dimensional TsunamiEvent2d setup.", "[TsunamiEvent2d]")
+/**
+ * Small bathymetry and displacement in memory:
+ *
+ *   bathymetry:   12 x 8 values with a spacing of 100 at x = 0, ..., 1100 and y = 0, ..., 700,
+ *                 deep ocean in the west, shallow water (-20 < b < 0) in column 7 and land in the east.
+ *   displacement: 6 x 4 values with a spacing of 100 at x = 500, ..., 1000 and y = 200, ..., 500,
+ *                 from -45 to 8, such that the surface falls dry in the shallow cells.
+ **/
+struct TsunamiEvent2dData
 {
-    std::vector<tsunami_lab::t_real> m_b_in;
-    tsunami_lab::io::Csv::read("data/real.csv", m_b_in);
-
-    tsunami_lab::t_real beginning = 10;
-
-    // b_in < 0 and -b_in > delta
-    tsunami_lab::t_real middle = 150000;
-
-    // b_in > 20
-    tsunami_lab::t_real end = 375000;
-
-    tsunami_lab::setups::TsunamiEvent2d l_tsunamievent();
-
-    //
-    REQUIRE(l_tsunamievent.getHeight(beginning, 0) == 20.0f);
-
-    REQUIRE(l_tsunamievent.getMomentumX(beginning, 0) == 0);
-
-    REQUIRE(l_tsunamievent.getMomentumY(beginning, 0) == 0);
-
-    REQUIRE(l_tsunamievent.getBathymetry(beginning, 0) == -20.0f);
-
-    //
-    REQUIRE(l_tsunamievent.getHeight(middle, 0) == Approx(2337.15381f));
+    std::vector<tsunami_lab::t_real> m_bathymetry_x;
+    std::vector<tsunami_lab::t_real> m_bathymetry_y;
+    std::vector<tsunami_lab::t_real> m_bathymetry;
+    std::vector<tsunami_lab::t_real> m_displacement_x;
+    std::vector<tsunami_lab::t_real> m_displacement_y;
+    std::vector<tsunami_lab::t_real> m_displacement;
+
+    TsunamiEvent2dData()
+    {
+        for (int l_ix = 0; l_ix < 12; l_ix++)
+        {
+            m_bathymetry_x.push_back(100 * l_ix);
+        }
+        for (int l_iy = 0; l_iy < 8; l_iy++)
+        {
+            m_bathymetry_y.push_back(100 * l_iy);
+            for (int l_ix = 0; l_ix < 12; l_ix++)
+            {
+                m_bathymetry.push_back(-700 + 100 * l_ix - 5 * l_iy);
+            }
+        }
+
+        for (int l_ix = 0; l_ix < 6; l_ix++)
+        {
+            m_displacement_x.push_back(500 + 100 * l_ix);
+        }
+        for (int l_iy = 0; l_iy < 4; l_iy++)
+        {
+            m_displacement_y.push_back(200 + 100 * l_iy);
+            for (int l_ix = 0; l_ix < 6; l_ix++)
+            {
+                m_displacement.push_back(-45 + 10 * l_ix + l_iy);
+            }
+        }
+    }
+
+    tsunami_lab::setups::TsunamiEvent2d *createEvent() const
+    {
+        return new tsunami_lab::setups::TsunamiEvent2d(12, 8, m_bathymetry_x.data(), m_bathymetry_y.data(), m_bathymetry.data(),
+                                                       6, 4, m_displacement_x.data(), m_displacement_y.data(), m_displacement.data());
+    }
+
+    tsunami_lab::setups::TsunamiEvent2d *createSharedEvent(tsunami_lab::setups::TsunamiEvent2d const &i_shared) const
+    {
+        return new tsunami_lab::setups::TsunamiEvent2d(i_shared,
+                                                       6, 4, m_displacement_x.data(), m_displacement_y.data(), m_displacement.data());
+    }
+};
+
+TEST_CASE("Test the two-dimensional tsunami event setup.", "[TsunamiEvent2d]")
+{
+    TsunamiEvent2dData l_data;
+    tsunami_lab::setups::TsunamiEvent2d *l_event = l_data.createEvent();
 
-    REQUIRE(l_tsunamievent.getMomentumX(middle, 0) == 0);
+    // deep ocean outside of the displacement
+    REQUIRE(l_event->getHeight(50, 50) == 700);
+    REQUIRE(l_event->getMomentumX(50, 50) == 0);
+    REQUIRE(l_event->getMomentumY(50, 50) == 0);
+    REQUIRE(l_event->getBathymetry(50, 50) == -700);
 
-    REQUIRE(l_tsunamievent.getMomentumY(middle, 0) == 0);
+    // ocean in the displacement: b = -215, d = -44
+    REQUIRE(l_event->getHeight(550, 350) == 215);
+    REQUIRE(l_event->getBathymetry(550, 350) == -215 - 44);
 
-    REQUIRE(l_tsunamievent.getBathymetry(middle, 0) == Approx(-2337.15381f));
+    // shallow water is deepened to the minimum depth: b = -15, d = -24
+    REQUIRE(l_event->getHeight(750, 350) == 20);
+    REQUIRE(l_event->getBathymetry(750, 350) == -20 - 24);
 
-    //
-    REQUIRE(l_tsunamievent.getHeight(end, 0) == Approx(5675.89795f));
+    // land: b = 85, d = -14
+    REQUIRE(l_event->getHeight(850, 350) == 0);
+    REQUIRE(l_event->getBathymetry(850, 350) == 85 - 14);
 
-    REQUIRE(l_tsunamievent.getMomentumX(end, 0) == 0);
+    // outside of the bathymetry
+    REQUIRE(l_event->getHeight(-50, 350) == 0);
+    REQUIRE(l_event->getBathymetry(-50, 350) == 20);
 
-    REQUIRE(l_tsunamievent.getMomentumY(end, 0) == 0);
+    delete l_event;
+}
 
-    REQUIRE(l_tsunamievent.getBathymetry(end, 0) == Approx(-5675.89795f));
-}
\ No newline at end of file
+TEST_CASE("Test the bulk fill of the two-dimensional tsunami event setup.", "[TsunamiEvent2dFill]")
+{
+    TsunamiEvent2dData l_data;
+    tsunami_lab::setups::TsunamiEvent2d *l_event = l_data.createEvent();
+    tsunami_lab::setups::TsunamiEvent2d *l_shared = l_data.createSharedEvent(*l_event);
+
+    // region beyond the bathymetry and the displacement on all sides, stored with a padded stride
+    tsunami_lab::setups::Setup::Region l_region = {0, 0, 40, 24, 37, 100, 50};
+    tsunami_lab::t_idx l_stride = 43;
+    std::vector<tsunami_lab::t_real> l_h(l_stride * l_region.m_ny);
+    std::vector<tsunami_lab::t_real> l_hu(l_stride * l_region.m_ny);
+    std::vector<tsunami_lab::t_real> l_hv(l_stride * l_region.m_ny);
+    std::vector<tsunami_lab::t_real> l_b(l_stride * l_region.m_ny);
+
+    // the displacement is applied to the seafloor or, if the bathymetry is shared, to the water surface
+    for (tsunami_lab::setups::TsunamiEvent2d *l_setup : {l_event, l_shared})
+    {
+        // the overridden and the default fill match the getters bitwise
+        for (int l_pass = 0; l_pass < 2; l_pass++)
+        {
+            if (l_pass == 0)
+            {
+                l_setup->fill(l_region, l_h.data(), l_hu.data(), l_hv.data(), l_b.data(), l_stride);
+            }
+            else
+            {
+                l_setup->tsunami_lab::setups::Setup::fill(l_region, l_h.data(), l_hu.data(), l_hv.data(), l_b.data(), l_stride);
+            }
+
+            for (tsunami_lab::t_idx l_iy = 0; l_iy < l_region.m_ny; l_iy++)
+            {
+                tsunami_lab::t_real l_y = (l_region.m_iy0 + l_iy) * l_region.m_dxy - l_region.m_y_offset;
+                for (tsunami_lab::t_idx l_ix = 0; l_ix < l_region.m_nx; l_ix++)
+                {
+                    tsunami_lab::t_real l_x = (l_region.m_ix0 + l_ix) * l_region.m_dxy - l_region.m_x_offset;
+                    tsunami_lab::t_idx l_id = l_ix + l_iy * l_stride;
+
+                    REQUIRE(l_h[l_id] == l_setup->getHeight(l_x, l_y));
+                    REQUIRE(l_hu[l_id] == l_setup->getMomentumX(l_x, l_y));
+                    REQUIRE(l_hv[l_id] == l_setup->getMomentumY(l_x, l_y));
+                    REQUIRE(l_b[l_id] == l_setup->getBathymetry(l_x, l_y));
+                }
+            }
+        }
+    }
+
+    delete l_shared;
+    delete l_event;
+}
+
+TEST_CASE("Test the tsunami event sharing the bathymetry of another one.", "[TsunamiEvent2dShared]")
+{
+    /*
+     * Test case:
+     *
+     *   The event with the shared bathymetry applies the displacement to the water surface instead of the seafloor.
+     *   Its bathymetry equals the one of the unshared event without the displacement, and the water surface of wet cells
+     *   is the same. Cells where the lowered surface falls below the seafloor are dry.
+     */
+    TsunamiEvent2dData l_data;
+    tsunami_lab::setups::TsunamiEvent2d *l_event = l_data.createEvent();
+    tsunami_lab::setups::TsunamiEvent2d *l_shared = l_data.createSharedEvent(*l_event);
+
+    std::size_t l_nDry = 0;
+    for (int l_iy = -2; l_iy < 18; l_iy++)
+    {
+        for (int l_ix = -2; l_ix < 26; l_ix++)
+        {
+            tsunami_lab::t_real l_x = 50 * l_ix + 25;
+            tsunami_lab::t_real l_y = 50 * l_iy + 25;
+
+            // displacement at the point, 0 outside of its grid
+            tsunami_lab::t_real l_d = 0;
+            if (l_x >= 500 && l_x <= 1000 && l_y >= 200 && l_y <= 500)
+            {
+                l_d = l_data.m_displacement[int((l_y - 200) / 100) * 6 + int((l_x - 500) / 100)];
+            }
+
+            REQUIRE(l_shared->getMomentumX(l_x, l_y) == 0);
+            REQUIRE(l_shared->getMomentumY(l_x, l_y) == 0);
+            REQUIRE(l_shared->getBathymetry(l_x, l_y) + l_d == l_event->getBathymetry(l_x, l_y));
+
+            if (l_event->getHeight(l_x, l_y) == 0)
+            {
+                // land stays dry
+                REQUIRE(l_shared->getHeight(l_x, l_y) == 0);
+            }
+            else if (l_event->getHeight(l_x, l_y) + l_d > 0)
+            {
+                REQUIRE(l_shared->getHeight(l_x, l_y) == l_event->getHeight(l_x, l_y) + l_d);
+                REQUIRE(l_shared->getHeight(l_x, l_y) + l_shared->getBathymetry(l_x, l_y) ==
+                        l_event->getHeight(l_x, l_y) + l_event->getBathymetry(l_x, l_y));
+            }
+            else
+            {
+                REQUIRE(l_shared->getHeight(l_x, l_y) == 0);
+                l_nDry++;
+            }
+        }
+    }
+    REQUIRE(l_nDry > 0);
+
+    delete l_shared;
+    delete l_event;
+}
@@ -8,79 +8,84 @@
  */
 #include "F_wave.h"
 
-#include "cmath"
-
-void tsunami_lab::solvers::FWave::waveSpeeds(t_real i_hL,
-                                             t_real i_hR,
-                                             t_real i_uL,
-                                             t_real i_uR,
-                                             t_real &o_waveSpeedL,
-                                             t_real &o_waveSpeedR)
+#include <algorithm>
+#include <cmath>
+
+template <typename T>
+void tsunami_lab::solvers::FWave<T>::waveSpeeds(T i_hL,
+                                                T i_hR,
+                                                T i_uL,
+                                                T i_uR,
+                                                T &o_waveSpeedL,
+                                                T &o_waveSpeedR)
 {
     // pre-compute square-root ops
-    t_real l_hSqrtL = std::sqrt(i_hL);
-    t_real l_hSqrtR = std::sqrt(i_hR);
+    T l_hSqrtL = std::sqrt(i_hL);
+    T l_hSqrtR = std::sqrt(i_hR);
 
     // compute FWave averages
-    t_real l_hRoe = 0.5f * (i_hL + i_hR);
-    t_real l_uRoe = l_hSqrtL * i_uL + l_hSqrtR * i_uR;
+    T l_hRoe = 0.5f * (i_hL + i_hR);
+    T l_uRoe = l_hSqrtL * i_uL + l_hSqrtR * i_uR;
     l_uRoe /= l_hSqrtL + l_hSqrtR;
 
     // compute wave speeds
-    t_real l_ghSqrtRoe = m_gSqrt * std::sqrt(l_hRoe);
+    T l_ghSqrtRoe = m_gSqrt * std::sqrt(l_hRoe);
     o_waveSpeedL = l_uRoe - l_ghSqrtRoe;
     o_waveSpeedR = l_uRoe + l_ghSqrtRoe;
 }
 
-void tsunami_lab::solvers::FWave::flux(t_real i_h,
-                                       t_real i_hu,
-                                       t_real *o_flux)
+template <typename T>
+void tsunami_lab::solvers::FWave<T>::flux(T i_h,
+                                          T i_hu,
+                                          T *o_flux)
 {
     o_flux[0] = i_hu;
     o_flux[1] = i_hu * i_hu / i_h + m_g * (0.5f * i_h * i_h);
 }
 
-void tsunami_lab::solvers::FWave::deltaXPsi(t_real i_hL,
-                                            t_real i_hR,
-                                            t_real i_bL,
-                                            t_real i_bR,
-                                            t_real *o_deltaXPsi)
+template <typename T>
+void tsunami_lab::solvers::FWave<T>::deltaXPsi(T i_hL,
+                                               T i_hR,
+                                               T i_bL,
+                                               T i_bR,
+                                               T *o_deltaXPsi)
 {
     o_deltaXPsi[0] = 0;
     o_deltaXPsi[1] = -1 * m_g * (i_bR - i_bL) * (i_hL + i_hR) * 0.5;
 }
 
-void tsunami_lab::solvers::FWave::waveStrengths(t_real i_hL,
-                                                t_real i_hR,
-                                                t_real i_huL,
-                                                t_real i_huR,
-                                                t_real i_bL,
-                                                t_real i_bR,
-                                                t_real i_waveSpeedL,
-                                                t_real i_waveSpeedR,
-                                                t_real &o_strengthL,
-                                                t_real &o_strengthR)
+template <typename T>
+void tsunami_lab::solvers::FWave<T>::waveStrengths(T i_hL,
+                                                   T i_hR,
+                                                   T i_huL,
+                                                   T i_huR,
+                                                   T i_bL,
+                                                   T i_bR,
+                                                   T i_waveSpeedL,
+                                                   T i_waveSpeedR,
+                                                   T &o_strengthL,
+                                                   T &o_strengthR)
 {
     // compute inverse of right eigenvector-matrix
-    t_real l_detInv = 1 / (i_waveSpeedR - i_waveSpeedL);
+    T l_detInv = 1 / (i_waveSpeedR - i_waveSpeedL);
 
-    t_real l_rInv[2][2] = {0};
+    T l_rInv[2][2] = {0};
     l_rInv[0][0] = l_detInv * i_waveSpeedR;
     l_rInv[0][1] = -l_detInv;
     l_rInv[1][0] = -l_detInv * i_waveSpeedL;
     l_rInv[1][1] = l_detInv;
 
-    t_real l_fluxL[2] = {0};
-    t_real l_fluxR[2] = {0};
+    T l_fluxL[2] = {0};
+    T l_fluxR[2] = {0};
 
     flux(i_hL, i_huL, l_fluxL);
     flux(i_hR, i_huR, l_fluxR);
 
-    t_real l_deltaXPsi[2] = {0};
+    T l_deltaXPsi[2] = {0};
 
     deltaXPsi(i_hL, i_hR, i_bL, i_bR, l_deltaXPsi);
 
-    t_real l_fluxJump[2];
+    T l_fluxJump[2];
 
     l_fluxJump[0] = l_fluxR[0] - l_fluxL[0] - l_deltaXPsi[0];
     l_fluxJump[1] = l_fluxR[1] - l_fluxL[1] - l_deltaXPsi[1];
@@ -93,14 +98,15 @@ void tsunami_lab::solvers::FWave::waveStrengths(t_real i_hL,
     o_strengthR += l_rInv[1][1] * l_fluxJump[1];
 }
 
-void tsunami_lab::solvers::FWave::netUpdates(t_real i_hL,
-                                             t_real i_hR,
-                                             t_real i_huL,
-                                             t_real i_huR,
-                                             t_real i_bL,
-                                             t_real i_bR,
-                                             t_real o_netUpdateL[2],
-                                             t_real o_netUpdateR[2])
+template <typename T>
+void tsunami_lab::solvers::FWave<T>::netUpdates(T i_hL,
+                                                T i_hR,
+                                                T i_huL,
+                                                T i_huR,
+                                                T i_bL,
+                                                T i_bR,
+                                                T o_netUpdateL[2],
+                                                T o_netUpdateR[2])
 {
     // both sides are dry -> exit 0
     if (i_hL <= 0 && i_hR <= 0)
@@ -134,24 +140,24 @@ void tsunami_lab::solvers::FWave::netUpdates(t_real i_hL,
     }
 
     // compute particle velocities
-    t_real l_uL = i_huL / i_hL;
-    t_real l_uR = i_huR / i_hR;
+    T l_uL = i_huL / i_hL;
+    T l_uR = i_huR / i_hR;
 
     // compute wave speeds
-    t_real l_sL = 0;
-    t_real l_sR = 0;
+    T l_sL = 0;
+    T l_sR = 0;
 
     waveSpeeds(i_hL, i_hR, l_uL, l_uR, l_sL, l_sR);
 
     // compute wave strengths
-    t_real l_aL = 0;
-    t_real l_aR = 0;
+    T l_aL = 0;
+    T l_aR = 0;
 
     waveStrengths(i_hL, i_hR, i_huL, i_huR, i_bL, i_bR, l_sL, l_sR, l_aL, l_aR);
 
     // compute waves
-    t_real l_waveL[2] = {0};
-    t_real l_waveR[2] = {0};
+    T l_waveL[2] = {0};
+    T l_waveR[2] = {0};
 
     l_waveL[0] = l_aL;
     l_waveL[1] = l_aL * l_sL;
@@ -186,4 +192,195 @@ void tsunami_lab::solvers::FWave::netUpdates(t_real i_hL,
             o_netUpdateL[l_qt] += l_waveR[l_qt];
         }
     }
-}
\ No newline at end of file
+}
+
+template <typename T>
+inline void tsunami_lab::solvers::FWave<T>::netUpdatesSelect(T i_hL,
+                                                             T i_hR,
+                                                             T i_huL,
+                                                             T i_huR,
+                                                             T i_bL,
+                                                             T i_bR,
+                                                             T &o_netUpdateLh,
+                                                             T &o_netUpdateLhu,
+                                                             T &o_netUpdateRh,
+                                                             T &o_netUpdateRhu,
+                                                             T &o_speed)
+{
+    // dry masks, a dry side is neither updated nor used (reflection)
+    bool l_dryL = i_hL <= 0;
+    bool l_dryR = i_hR <= 0;
+    bool l_dry = l_dryL && l_dryR;
+
+    // left side dry -> reflect to right, right side dry -> reflect to left,
+    // both sides dry -> dummy state which keeps the arithmetic finite
+    T l_hL = l_dry ? 1 : (l_dryL ? i_hR : i_hL);
+    T l_hR = l_dry ? 1 : (l_dryR ? i_hL : i_hR);
+    T l_huL = l_dryL ? -i_huR : i_huL;
+    T l_huR = l_dryR ? -i_huL : i_huR;
+    T l_bL = l_dryL ? i_bR : i_bL;
+    T l_bR = l_dryR ? i_bL : i_bR;
+
+    // compute particle velocities
+    T l_uL = l_huL / l_hL;
+    T l_uR = l_huR / l_hR;
+
+    // compute wave speeds
+    T l_hSqrtL = std::sqrt(l_hL);
+    T l_hSqrtR = std::sqrt(l_hR);
+
+    T l_hRoe = 0.5f * (l_hL + l_hR);
+    T l_uRoe = l_hSqrtL * l_uL + l_hSqrtR * l_uR;
+    l_uRoe /= l_hSqrtL + l_hSqrtR;
+
+    T l_ghSqrtRoe = m_gSqrt * std::sqrt(l_hRoe);
+    T l_sL = l_uRoe - l_ghSqrtRoe;
+    T l_sR = l_uRoe + l_ghSqrtRoe;
+
+    // the dummy state of two dry sides does not contribute to the maximum wave speed
+    T l_speed = std::max(std::abs(l_sL), std::abs(l_sR));
+    o_speed = l_dry ? T(0) : l_speed;
+
+    // compute jump in fluxes including the bathymetry source term
+    T l_fluxJump0 = l_huR - l_huL;
+    T l_fluxJump1 = (l_huR * l_huR / l_hR + m_g * (0.5f * l_hR * l_hR)) - (l_huL * l_huL / l_hL + m_g * (0.5f * l_hL * l_hL));
+    l_fluxJump1 -= -1 * m_g * (l_bR - l_bL) * (l_hL + l_hR) * 0.5f;
+
+    // compute wave strengths
+    T l_detInv = 1 / (l_sR - l_sL);
+
+    T l_aL = l_detInv * l_sR * l_fluxJump0;
+    l_aL += -l_detInv * l_fluxJump1;
+
+    T l_aR = -l_detInv * l_sL * l_fluxJump0;
+    l_aR += l_detInv * l_fluxJump1;
+
+    // assign the waves depending on the wave speeds, dry sides are masked
+    bool l_toL1 = l_sL < 0 && !l_dryL;
+    bool l_toR1 = l_sL >= 0 && !l_dryR;
+    bool l_toR2 = l_sR > 0 && !l_dryR;
+    bool l_toL2 = l_sR <= 0 && !l_dryL;
+
+    o_netUpdateLh = (l_toL1 ? l_aL : 0) + (l_toL2 ? l_aR : 0);
+    o_netUpdateLhu = (l_toL1 ? l_aL * l_sL : 0) + (l_toL2 ? l_aR * l_sR : 0);
+    o_netUpdateRh = (l_toR1 ? l_aL : 0) + (l_toR2 ? l_aR : 0);
+    o_netUpdateRhu = (l_toR1 ? l_aL * l_sL : 0) + (l_toR2 ? l_aR * l_sR : 0);
+}
+
+template <typename T>
+template <typename T_in>
+T tsunami_lab::solvers::FWave<T>::netUpdatesBatch(t_idx i_nEdges,
+                                                  T_in const *i_hL,
+                                                  T_in const *i_hR,
+                                                  T_in const *i_huL,
+                                                  T_in const *i_huR,
+                                                  T_in const *i_bL,
+                                                  T_in const *i_bR,
+                                                  T *o_netUpdateLh,
+                                                  T *o_netUpdateLhu,
+                                                  T *o_netUpdateRh,
+                                                  T *o_netUpdateRhu)
+{
+    T l_speedMax = 0;
+
+#pragma omp simd reduction(max : l_speedMax)
+    for (t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
+    {
+        T l_netUpdates[4];
+        T l_speed;
+        netUpdatesSelect(i_hL[l_ed],
+                         i_hR[l_ed],
+                         i_huL[l_ed],
+                         i_huR[l_ed],
+                         i_bL[l_ed],
+                         i_bR[l_ed],
+                         l_netUpdates[0],
+                         l_netUpdates[1],
+                         l_netUpdates[2],
+                         l_netUpdates[3],
+                         l_speed);
+
+        o_netUpdateLh[l_ed] = l_netUpdates[0];
+        o_netUpdateLhu[l_ed] = l_netUpdates[1];
+        o_netUpdateRh[l_ed] = l_netUpdates[2];
+        o_netUpdateRhu[l_ed] = l_netUpdates[3];
+        l_speedMax = std::max(l_speedMax, l_speed);
+    }
+
+    return l_speedMax;
+}
+
+template <typename T>
+template <typename T_in>
+void tsunami_lab::solvers::FWave<T>::netUpdatesLanes(t_idx i_nEdges,
+                                                     t_idx i_nLanes,
+                                                     T_in const *i_hL,
+                                                     T_in const *i_hR,
+                                                     T_in const *i_huL,
+                                                     T_in const *i_huR,
+                                                     T_in const *i_bL,
+                                                     T_in const *i_bR,
+                                                     T *o_netUpdateLh,
+                                                     T *o_netUpdateLhu,
+                                                     T *o_netUpdateRh,
+                                                     T *o_netUpdateRhu,
+                                                     T *io_speedMax)
+{
+    for (t_idx l_ed = 0; l_ed < i_nEdges; l_ed++)
+    {
+        // the bathymetry is the same in all lanes
+        T l_bL = i_bL[l_ed];
+        T l_bR = i_bR[l_ed];
+        t_idx l_id0 = l_ed * i_nLanes;
+
+#pragma omp simd
+        for (t_idx l_la = 0; l_la < i_nLanes; l_la++)
+        {
+            t_idx l_id = l_id0 + l_la;
+            T l_netUpdates[4];
+            T l_speed;
+            netUpdatesSelect(i_hL[l_id],
+                             i_hR[l_id],
+                             i_huL[l_id],
+                             i_huR[l_id],
+                             l_bL,
+                             l_bR,
+                             l_netUpdates[0],
+                             l_netUpdates[1],
+                             l_netUpdates[2],
+                             l_netUpdates[3],
+                             l_speed);
+
+            o_netUpdateLh[l_id] = l_netUpdates[0];
+            o_netUpdateLhu[l_id] = l_netUpdates[1];
+            o_netUpdateRh[l_id] = l_netUpdates[2];
+            o_netUpdateRhu[l_id] = l_netUpdates[3];
+            T l_speedMax = io_speedMax[l_la];
+            io_speedMax[l_la] = std::max(l_speedMax, l_speed);
+        }
+    }
+}
+
+template class tsunami_lab::solvers::FWave<float>;
+template class tsunami_lab::solvers::FWave<double>;
+
+template float tsunami_lab::solvers::FWave<float>::netUpdatesBatch<float>(t_idx,
+                                                                          float const *, float const *,
+                                                                          float const *, float const *,
+                                                                          float const *, float const *,
+                                                                          float *, float *, float *, float *);
+template double tsunami_lab::solvers::FWave<double>::netUpdatesBatch<double>(t_idx,
+                                                                            double const *, double const *,
+                                                                            double const *, double const *,
+                                                                            double const *, double const *,
+                                                                            double *, double *, double *, double *);
+template double tsunami_lab::solvers::FWave<double>::netUpdatesBatch<float>(t_idx,
+                                                                           float const *, float const *,
+                                                                           float const *, float const *,
+                                                                           float const *, float const *,
+                                                                           double *, double *, double *, double *);
+template void tsunami_lab::solvers::FWave<float>::netUpdatesLanes<float>(t_idx, t_idx,
+                                                                         float const *, float const *,
+                                                                         float const *, float const *,
+                                                                         float const *, float const *,
+                                                                         float *, float *, float *, float *, float *);
@@ -14,16 +14,26 @@ namespace tsunami_lab
 {
    namespace solvers
    {
+      template <typename T = t_real>
       class FWave;
    }
 } // namespace tsunami_lab
 
+/**
+ * F-wave solver.
+ *
+ * @tparam T floating point type in which the net-updates are computed.
+ **/
+template <typename T>
 class tsunami_lab::solvers::FWave
 {
+public:
+   //! gravity, shared with the wave speed estimates of the patches
+   static T constexpr m_g = 9.80665;
+
 private:
    //! square root of gravity
-   static t_real constexpr m_g = 9.80665;
-   static t_real constexpr m_gSqrt = 3.131557121;
+   static T constexpr m_gSqrt = 3.1315571206669692;
 
    /**
     * Computes the wave speeds.
@@ -37,12 +47,12 @@ private:
     * @param o_waveSpeedR will be set to the speed of the wave propagating to
     *the right.
     **/
-   static void waveSpeeds(t_real i_hL,
-                          t_real i_hR,
-                          t_real i_uL,
-                          t_real i_uR,
-                          t_real &o_waveSpeedL,
-                          t_real &o_waveSpeedR);
+   static void waveSpeeds(T i_hL,
+                          T i_hR,
+                          T i_uL,
+                          T i_uR,
+                          T &o_waveSpeedL,
+                          T &o_waveSpeedR);
 
    /**
     * Computes the wave strengths.
@@ -61,16 +71,16 @@ private:
     *the right.
     **/
 
-   static void waveStrengths(t_real i_hL,
-                             t_real i_hR,
-                             t_real i_huL,
-                             t_real i_huR,
-                             t_real i_bL,
-                             t_real i_bR,
-                             t_real i_waveSpeedL,
-                             t_real i_waveSpeedR,
-                             t_real &o_strengthL,
-                             t_real &o_strengthR);
+   static void waveStrengths(T i_hL,
+                             T i_hR,
+                             T i_huL,
+                             T i_huR,
+                             T i_bL,
+                             T i_bR,
+                             T i_waveSpeedL,
+                             T i_waveSpeedR,
+                             T &o_strengthL,
+                             T &o_strengthR);
 
    /**
     * Computes the flux.
@@ -80,9 +90,9 @@ private:
     * @param o_flux will be set to the flux function hu, h*u^2 + 1/2*g*h^2.
     **/
 
-   static void flux(t_real i_h,
-                    t_real i_hu,
-                    t_real *o_flux);
+   static void flux(T i_h,
+                    T i_hu,
+                    T *o_flux);
 
    /**
     * @brief
@@ -94,11 +104,39 @@ private:
     * @param o_deltaXPsi resutling bathymetry-change
     */
 
-   static void deltaXPsi(t_real i_hl,
-                         t_real i_hr,
-                         t_real i_bL,
-                         t_real i_bR,
-                         t_real *o_deltaXPsi);
+   static void deltaXPsi(T i_hl,
+                         T i_hr,
+                         T i_bL,
+                         T i_bR,
+                         T *o_deltaXPsi);
+
+   /**
+    * Computes the net-updates of one edge without branches, the body of the vectorized loops.
+    * Dry-cell reflection and the wave-speed sign tests are expressed as selects.
+    *
+    * @param i_hL height of the left side.
+    * @param i_hR height of the right side.
+    * @param i_huL momentum of the left side.
+    * @param i_huR momentum of the right side.
+    * @param i_bL bathymetry of the left side.
+    * @param i_bR bathymetry of the right side.
+    * @param o_netUpdateLh will be set to the height net-update for the left side.
+    * @param o_netUpdateLhu will be set to the momentum net-update for the left side.
+    * @param o_netUpdateRh will be set to the height net-update for the right side.
+    * @param o_netUpdateRhu will be set to the momentum net-update for the right side.
+    * @param o_speed will be set to the maximum absolute wave speed of the edge, 0 if both sides are dry.
+    **/
+   [[gnu::always_inline]] static void netUpdatesSelect(T i_hL,
+                                                       T i_hR,
+                                                       T i_huL,
+                                                       T i_huR,
+                                                       T i_bL,
+                                                       T i_bR,
+                                                       T &o_netUpdateLh,
+                                                       T &o_netUpdateLhu,
+                                                       T &o_netUpdateRh,
+                                                       T &o_netUpdateRhu,
+                                                       T &o_speed);
 
 public:
    /**
@@ -115,14 +153,82 @@ public:
     * @param o_netUpdateR will be set to the net-updates for the right side; 0:
     *height, 1: momentum.
     **/
-   static void netUpdates(t_real i_hL,
-                          t_real i_hR,
-                          t_real i_huL,
-                          t_real i_huR,
-                          t_real i_bL,
-                          t_real i_bR,
-                          t_real o_netUpdateL[2],
-                          t_real o_netUpdateR[2]);
+   static void netUpdates(T i_hL,
+                          T i_hR,
+                          T i_huL,
+                          T i_huR,
+                          T i_bL,
+                          T i_bR,
+                          T o_netUpdateL[2],
+                          T o_netUpdateR[2]);
+
+   /**
+    * Computes the net-updates for a batch of edges given as structure of arrays.
+    * Dry-cell reflection and the wave-speed sign tests are expressed as selects,
+    * so that the loop is vectorized over the edges.
+    *
+    * @tparam T_in floating point type of the inputs, may be narrower than T.
+    * @param i_nEdges number of edges in the batch.
+    * @param i_hL heights of the left sides.
+    * @param i_hR heights of the right sides.
+    * @param i_huL momenta of the left sides.
+    * @param i_huR momenta of the right sides.
+    * @param i_bL bathymetry of the left sides.
+    * @param i_bR bathymetry of the right sides.
+    * @param o_netUpdateLh will be set to the height net-updates for the left sides.
+    * @param o_netUpdateLhu will be set to the momentum net-updates for the left sides.
+    * @param o_netUpdateRh will be set to the height net-updates for the right sides.
+    * @param o_netUpdateRhu will be set to the momentum net-updates for the right sides.
+    * @return maximum absolute wave speed of the batch, 0 if all edges are dry.
+    **/
+   template <typename T_in>
+   static T netUpdatesBatch(t_idx i_nEdges,
+                            T_in const *i_hL,
+                            T_in const *i_hR,
+                            T_in const *i_huL,
+                            T_in const *i_huR,
+                            T_in const *i_bL,
+                            T_in const *i_bR,
+                            T *o_netUpdateLh,
+                            T *o_netUpdateLhu,
+                            T *o_netUpdateRh,
+                            T *o_netUpdateRhu);
+
+   /**
+    * Computes the net-updates for a batch of edges in several scenarios (lanes) on the same bathymetry.
+    * Value (edge e, lane l) is stored at e * i_nLanes + l, the bathymetry once per edge.
+    * The loop over the lanes is vectorized, it needs neither gathers nor lane-dependent bathymetry.
+    * The results of each lane equal those of netUpdatesBatch bitwise.
+    *
+    * @tparam T_in floating point type of the inputs, may be narrower than T.
+    * @param i_nEdges number of edges in the batch.
+    * @param i_nLanes number of lanes.
+    * @param i_hL heights of the left sides.
+    * @param i_hR heights of the right sides.
+    * @param i_huL momenta of the left sides.
+    * @param i_huR momenta of the right sides.
+    * @param i_bL bathymetry of the left sides, one value per edge.
+    * @param i_bR bathymetry of the right sides, one value per edge.
+    * @param o_netUpdateLh will be set to the height net-updates for the left sides.
+    * @param o_netUpdateLhu will be set to the momentum net-updates for the left sides.
+    * @param o_netUpdateRh will be set to the height net-updates for the right sides.
+    * @param o_netUpdateRhu will be set to the momentum net-updates for the right sides.
+    * @param io_speedMax maximum absolute wave speed of each lane, raised by the waves of the batch.
+    **/
+   template <typename T_in>
+   static void netUpdatesLanes(t_idx i_nEdges,
+                               t_idx i_nLanes,
+                               T_in const *i_hL,
+                               T_in const *i_hR,
+                               T_in const *i_huL,
+                               T_in const *i_huR,
+                               T_in const *i_bL,
+                               T_in const *i_bR,
+                               T *o_netUpdateLh,
+                               T *o_netUpdateLhu,
+                               T *o_netUpdateRh,
+                               T *o_netUpdateRhu,
+                               T *io_speedMax);
 };
 
 #endif
\ No newline at end of file
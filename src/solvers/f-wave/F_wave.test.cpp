@@ -5,6 +5,7 @@
  * Unit tests of the FWave Riemann solver.
  **/
 #include <catch2/catch.hpp>
+#include <algorithm>
 #define private public
 #include "F_wave.h"
 #undef public
@@ -24,12 +25,12 @@ TEST_CASE("Test the derivation of the FWave speeds.", "[FWaveSpeeds]")
      */
     float l_waveSpeedL = 0;
     float l_waveSpeedR = 0;
-    tsunami_lab::solvers::FWave::waveSpeeds(10,
-                                            9,
-                                            -3,
-                                            3,
-                                            l_waveSpeedL,
-                                            l_waveSpeedR);
+    tsunami_lab::solvers::FWave<>::waveSpeeds(10,
+                                              9,
+                                              -3,
+                                              3,
+                                              l_waveSpeedL,
+                                              l_waveSpeedR);
 
     REQUIRE(l_waveSpeedL == Approx(-9.7311093998375095));
     REQUIRE(l_waveSpeedR == Approx(9.5731051658991654));
@@ -71,16 +72,16 @@ TEST_CASE("Test the derivation of the FWave wave strength.", "[FWaveStrengths]")
     float l_strengthL = 0;
     float l_strengthR = 0;
 
-    tsunami_lab::solvers::FWave::waveStrengths(10,
-                                               9,
-                                               -30,
-                                               27,
-                                               0,
-                                               0,
-                                               -9.7311093998375095,
-                                               9.5731051658991654,
-                                               l_strengthL,
-                                               l_strengthR);
+    tsunami_lab::solvers::FWave<>::waveStrengths(10,
+                                                 9,
+                                                 -30,
+                                                 27,
+                                                 0,
+                                                 0,
+                                                 -9.7311093998375095,
+                                                 9.5731051658991654,
+                                                 l_strengthL,
+                                                 l_strengthR);
 
     REQUIRE(l_strengthL == Approx(33.559));
     REQUIRE(l_strengthR == Approx(23.441));
@@ -111,14 +112,14 @@ TEST_CASE("Test the derivation of the FWave net-updates.", "[FWaveUpdates]")
     float l_netUpdatesL[2] = {-5, 3};
     float l_netUpdatesR[2] = {4, 7};
 
-    tsunami_lab::solvers::FWave::netUpdates(10,
-                                            9,
-                                            -30,
-                                            27,
-                                            0,
-                                            0,
-                                            l_netUpdatesL,
-                                            l_netUpdatesR);
+    tsunami_lab::solvers::FWave<>::netUpdates(10,
+                                              9,
+                                              -30,
+                                              27,
+                                              0,
+                                              0,
+                                              l_netUpdatesL,
+                                              l_netUpdatesR);
 
     REQUIRE(l_netUpdatesL[0] == Approx(33.559));
     REQUIRE(l_netUpdatesL[1] == Approx(-326.5663003491469813105));
@@ -162,14 +163,14 @@ TEST_CASE("Test the derivation of the FWave net-updates.", "[FWaveUpdates]")
      * update #2:      a2 * |    | = |               |
      *                      | s2 |   | -88.2599      |
      */
-    tsunami_lab::solvers::FWave::netUpdates(10,
-                                            8,
-                                            0,
-                                            0,
-                                            0,
-                                            0,
-                                            l_netUpdatesL,
-                                            l_netUpdatesR);
+    tsunami_lab::solvers::FWave<>::netUpdates(10,
+                                              8,
+                                              0,
+                                              0,
+                                              0,
+                                              0,
+                                              l_netUpdatesL,
+                                              l_netUpdatesR);
 
     REQUIRE(l_netUpdatesL[0] == Approx(9.39468));
     REQUIRE(l_netUpdatesL[1] == Approx(-88.2599));
@@ -184,14 +185,14 @@ TEST_CASE("Test the derivation of the FWave net-updates.", "[FWaveUpdates]")
      *   h:  10 | 10
      *  hu:   0 |  0
      */
-    tsunami_lab::solvers::FWave::netUpdates(10,
-                                            10,
-                                            0,
-                                            0,
-                                            0,
-                                            0,
-                                            l_netUpdatesL,
-                                            l_netUpdatesR);
+    tsunami_lab::solvers::FWave<>::netUpdates(10,
+                                              10,
+                                              0,
+                                              0,
+                                              0,
+                                              0,
+                                              l_netUpdatesL,
+                                              l_netUpdatesR);
 
     REQUIRE(l_netUpdatesL[0] == Approx(0));
     REQUIRE(l_netUpdatesL[1] == Approx(0));
@@ -235,14 +236,14 @@ TEST_CASE("Test the derivation of the FWave net-updates.", "[FWaveUpdates]")
      *                     | s1 |         | s2 |    | -9900.002044988 |
      */
 
-    tsunami_lab::solvers::FWave::netUpdates(1,
-                                            1,
-                                            100,
-                                            10,
-                                            0,
-                                            0,
-                                            l_netUpdatesL,
-                                            l_netUpdatesR);
+    tsunami_lab::solvers::FWave<>::netUpdates(1,
+                                              1,
+                                              100,
+                                              10,
+                                              0,
+                                              0,
+                                              l_netUpdatesL,
+                                              l_netUpdatesR);
 
     REQUIRE(l_netUpdatesL[0] == Approx(0));
     REQUIRE(l_netUpdatesL[1] == Approx(0));
@@ -259,24 +260,24 @@ TEST_CASE("Test the derivation of the FWave net-updates dry-to-wet edge-case.",
     float l_netUpdatesR_shock_shock[2] = {4, 7};
 
     // Simulate wave against wall right to left
-    tsunami_lab::solvers::FWave::netUpdates(0,
-                                            15,
-                                            0,
-                                            -10,
-                                            15,
-                                            -15,
-                                            l_netUpdatesL_dry_to_wet,
-                                            l_netUpdatesR_dry_to_wet);
+    tsunami_lab::solvers::FWave<>::netUpdates(0,
+                                              15,
+                                              0,
+                                              -10,
+                                              15,
+                                              -15,
+                                              l_netUpdatesL_dry_to_wet,
+                                              l_netUpdatesR_dry_to_wet);
 
     // Simulate shock-shock wave
-    tsunami_lab::solvers::FWave::netUpdates(15,
-                                            15,
-                                            10,
-                                            -10,
-                                            -15,
-                                            -15,
-                                            l_netUpdatesL_shock_shock,
-                                            l_netUpdatesR_shock_shock);
+    tsunami_lab::solvers::FWave<>::netUpdates(15,
+                                              15,
+                                              10,
+                                              -10,
+                                              -15,
+                                              -15,
+                                              l_netUpdatesL_shock_shock,
+                                              l_netUpdatesR_shock_shock);
 
     REQUIRE(l_netUpdatesL_dry_to_wet[0] == 0);
     REQUIRE(l_netUpdatesL_dry_to_wet[1] == 0);
@@ -284,4 +285,152 @@ TEST_CASE("Test the derivation of the FWave net-updates dry-to-wet edge-case.",
     // Proof, that same effect as shock-shock happens
     REQUIRE(l_netUpdatesR_dry_to_wet[0] == Approx(l_netUpdatesR_shock_shock[0]));
     REQUIRE(l_netUpdatesR_dry_to_wet[1] == -Approx(l_netUpdatesL_shock_shock[1]));
-}
\ No newline at end of file
+}
+
+TEST_CASE("Test the batched FWave net-updates against the single-edge solver.", "[FWaveUpdatesBatch]")
+{
+    /*
+     * Test case:
+     *
+     *   Batch containing the cases of the single-edge tests above, i.e.
+     *   regular, dam break, steady state, supersonic, dry-to-wet, wet-to-dry,
+     *   both sides dry and bathymetry jumps.
+     *   The batch has an odd length to cover the remainder of the vectorized loop.
+     */
+    float l_hL[9] = {10, 10, 10, 1, 0, 15, 0, 5, 3};
+    float l_hR[9] = {9, 8, 10, 1, 15, 0, 0, 7, 3};
+    float l_huL[9] = {-30, 0, 0, 100, 0, 10, 0, 1, -2};
+    float l_huR[9] = {27, 0, 0, 10, -10, 0, 0, -4, 6};
+    float l_bL[9] = {0, 0, 0, 0, 15, -15, 20, -5, -3};
+    float l_bR[9] = {0, 0, 0, 0, -15, 15, 20, -7, -1};
+
+    float l_netUpdatesLh[9];
+    float l_netUpdatesLhu[9];
+    float l_netUpdatesRh[9];
+    float l_netUpdatesRhu[9];
+
+    float l_speedMax = tsunami_lab::solvers::FWave<>::netUpdatesBatch(9,
+                                                                      l_hL,
+                                                                      l_hR,
+                                                                      l_huL,
+                                                                      l_huR,
+                                                                      l_bL,
+                                                                      l_bR,
+                                                                      l_netUpdatesLh,
+                                                                      l_netUpdatesLhu,
+                                                                      l_netUpdatesRh,
+                                                                      l_netUpdatesRhu);
+
+    for (int l_ed = 0; l_ed < 9; l_ed++)
+    {
+        float l_netUpdatesL[2];
+        float l_netUpdatesR[2];
+
+        tsunami_lab::solvers::FWave<>::netUpdates(l_hL[l_ed],
+                                                  l_hR[l_ed],
+                                                  l_huL[l_ed],
+                                                  l_huR[l_ed],
+                                                  l_bL[l_ed],
+                                                  l_bR[l_ed],
+                                                  l_netUpdatesL,
+                                                  l_netUpdatesR);
+
+        REQUIRE(l_netUpdatesLh[l_ed] == Approx(l_netUpdatesL[0]).margin(1E-5));
+        REQUIRE(l_netUpdatesLhu[l_ed] == Approx(l_netUpdatesL[1]).margin(1E-5));
+        REQUIRE(l_netUpdatesRh[l_ed] == Approx(l_netUpdatesR[0]).margin(1E-5));
+        REQUIRE(l_netUpdatesRhu[l_ed] == Approx(l_netUpdatesR[1]).margin(1E-5));
+    }
+
+    // both sides dry
+    REQUIRE(l_netUpdatesLh[6] == 0);
+    REQUIRE(l_netUpdatesLhu[6] == 0);
+    REQUIRE(l_netUpdatesRh[6] == 0);
+    REQUIRE(l_netUpdatesRhu[6] == 0);
+
+    // the fastest wave is the one of the supersonic edge: u_Roe + sqrt(g * h_Roe) = 55 + sqrt(g)
+    REQUIRE(l_speedMax == Approx(58.1315571206669692));
+
+    // both sides dry, no waves
+    l_speedMax = tsunami_lab::solvers::FWave<>::netUpdatesBatch(1,
+                                                                l_hL + 6,
+                                                                l_hR + 6,
+                                                                l_huL + 6,
+                                                                l_huR + 6,
+                                                                l_bL + 6,
+                                                                l_bR + 6,
+                                                                l_netUpdatesLh,
+                                                                l_netUpdatesLhu,
+                                                                l_netUpdatesRh,
+                                                                l_netUpdatesRhu);
+    REQUIRE(l_speedMax == 0);
+}
+
+TEST_CASE("Test the FWave net-updates of lanes against the batched solver.", "[FWaveUpdatesLanes]")
+{
+    /*
+     * Test case:
+     *
+     *   Three edges with different bathymetry jumps, each in three lanes (scenarios) with different states:
+     *   regular, dry-to-wet, wet-to-dry, both sides dry and steady state.
+     *   Each lane has to match the batched solver with the edge's bathymetry bitwise.
+     */
+    float l_hL[9] = {10, 0, 5, 3, 10, 0, 4, 2, 6};
+    float l_hR[9] = {9, 15, 0, 3, 10, 0, 2, 5, 1};
+    float l_huL[9] = {-30, 0, 1, -2, 0, 0, 3, 1, 2};
+    float l_huR[9] = {27, -10, 0, 6, 0, 0, -1, 2, -4};
+    float l_bL[3] = {0, -5, 20};
+    float l_bR[3] = {-2, -5, 19};
+
+    float l_netUpdatesLh[9];
+    float l_netUpdatesLhu[9];
+    float l_netUpdatesRh[9];
+    float l_netUpdatesRhu[9];
+    float l_speedMax[3] = {0, 0, 0};
+
+    tsunami_lab::solvers::FWave<>::netUpdatesLanes(3,
+                                                   3,
+                                                   l_hL,
+                                                   l_hR,
+                                                   l_huL,
+                                                   l_huR,
+                                                   l_bL,
+                                                   l_bR,
+                                                   l_netUpdatesLh,
+                                                   l_netUpdatesLhu,
+                                                   l_netUpdatesRh,
+                                                   l_netUpdatesRhu,
+                                                   l_speedMax);
+
+    for (int l_la = 0; l_la < 3; l_la++)
+    {
+        float l_speedMaxLane = 0;
+        for (int l_ed = 0; l_ed < 3; l_ed++)
+        {
+            int l_id = l_ed * 3 + l_la;
+            float l_netUpdates[4];
+
+            float l_speed = tsunami_lab::solvers::FWave<>::netUpdatesBatch(1,
+                                                                           l_hL + l_id,
+                                                                           l_hR + l_id,
+                                                                           l_huL + l_id,
+                                                                           l_huR + l_id,
+                                                                           l_bL + l_ed,
+                                                                           l_bR + l_ed,
+                                                                           l_netUpdates,
+                                                                           l_netUpdates + 1,
+                                                                           l_netUpdates + 2,
+                                                                           l_netUpdates + 3);
+            l_speedMaxLane = std::max(l_speedMaxLane, l_speed);
+
+            REQUIRE(l_netUpdatesLh[l_id] == l_netUpdates[0]);
+            REQUIRE(l_netUpdatesLhu[l_id] == l_netUpdates[1]);
+            REQUIRE(l_netUpdatesRh[l_id] == l_netUpdates[2]);
+            REQUIRE(l_netUpdatesRhu[l_id] == l_netUpdates[3]);
+        }
+        REQUIRE(l_speedMax[l_la] == l_speedMaxLane);
+    }
+
+    // both sides dry
+    REQUIRE(l_netUpdatesLh[5] == 0);
+    REQUIRE(l_netUpdatesRhu[5] == 0);
+}
@@ -7,10 +7,21 @@
 #define CATCH_CONFIG_RUNNER
 #include <catch2/catch.hpp>
 #undef CATCH_CONFIG_RUNNER
+#ifdef TSUNAMI_LAB_USE_MPI
+#include <mpi.h>
+#endif
 
 int main( int   i_argc,
           char* i_argv[] ) {
+#ifdef TSUNAMI_LAB_USE_MPI
+  // the patches call MPI from the main thread inside parallel regions
+  int l_provided = 0;
+  MPI_Init_thread( &i_argc, &i_argv, MPI_THREAD_FUNNELED, &l_provided );
+#endif
   int l_result = Catch::Session().run( i_argc, i_argv );
+#ifdef TSUNAMI_LAB_USE_MPI
+  MPI_Finalize();
+#endif
 
   return ( l_result < 0xff ? l_result : 0xff );
 }
\ No newline at end of file